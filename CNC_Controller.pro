@@ -1,4 +1,4 @@
-QT += core widgets opengl serialport
+QT += core widgets opengl serialport network websockets
 
 CONFIG += c++17
 
@@ -13,7 +13,22 @@ SOURCES += \
     src/serialcommunication.cpp \
     src/axiscontroller.cpp \
     src/settings.cpp \
-    src/logger.cpp
+    src/logger.cpp \
+    src/positioninterpolator.cpp \
+    src/latencyhistogram.cpp \
+    src/virtualgrbl.cpp \
+    src/gcodecompactor.cpp \
+    src/grbltransport.cpp \
+    src/jobstreamer.cpp \
+    src/jogcontroller.cpp \
+    src/trafficrecorder.cpp \
+    src/controllersettings.cpp \
+    src/machinemanager.cpp \
+    src/jobserver.cpp \
+    src/motionestimator.cpp \
+    src/telemetryrecorder.cpp \
+    src/simulationclock.cpp \
+    src/stepgenerator.cpp
 
 HEADERS += \
     include/mainwindow.h \
@@ -22,7 +37,22 @@ HEADERS += \
     include/serialcommunication.h \
     include/axiscontroller.h \
     include/settings.h \
-    include/logger.h
+    include/logger.h \
+    include/positioninterpolator.h \
+    include/latencyhistogram.h \
+    include/virtualgrbl.h \
+    include/gcodecompactor.h \
+    include/grbltransport.h \
+    include/jobstreamer.h \
+    include/jogcontroller.h \
+    include/trafficrecorder.h \
+    include/controllersettings.h \
+    include/machinemanager.h \
+    include/jobserver.h \
+    include/motionestimator.h \
+    include/telemetryrecorder.h \
+    include/simulationclock.h \
+    include/stepgenerator.h
 
 INCLUDEPATH += include
 
@@ -2,9 +2,12 @@
 #define AXISCONTROLLER_H
 
 #include <QObject>
-#include <QTimer>
 #include <QMap>
+#include <QSet>
+#include <QStringList>
 #include <QVector>
+#include "simulationclock.h"
+#include "stepgenerator.h"
 
 enum class AccelerationProfile {
     Linear,
@@ -21,18 +24,42 @@ enum class MicrostepMode {
     ThirtySecond = 32
 };
 
+// Profilin bir anındaki durum (mm, mm/s, mm/s²; işaret hareket yönündedir)
+struct MotionSample {
+    double time;
+    double position;
+    double velocity;
+    double acceleration;
+};
+
+// Sabit jerk'li tek evre. Evre içinde t saniye sonra:
+//   a = a0 + j·t,  v = v0 + a0·t + j·t²/2,  s = s0 + v0·t + a0·t²/2 + j·t³/6
+// Yol (s) ve hız her zaman pozitiftir; yön MotionProfile'da tutulur.
+struct MotionPhase {
+    double startTime;
+    double duration;
+    double jerk;
+    double startAcceleration;
+    double startVelocity;
+    double startDistance;
+};
+
+// Parçalı polinom hareket profili: S-eğrisinde 7, yamukta 3 evre. Nokta dizisi
+// tutulmaz; sampleAt() herhangi bir t için O(1) hesaplar, örnekleme istek üzerinedir.
 struct MotionProfile {
     double startPosition;
     double endPosition;
-    double maxSpeed;
-    double acceleration;
-    double deceleration;
-    double jerk;
+    double maxSpeed;            // mm/min (istenen)
+    double acceleration;        // mm/s²
+    double deceleration;        // mm/s²
+    double jerk;                // mm/s³ (yalnızca S-eğrisi)
     AccelerationProfile profile;
-    double totalTime;
-    QVector<double> timePoints;
-    QVector<double> positionPoints;
-    QVector<double> velocityPoints;
+    double totalTime;           // s
+    double peakVelocity;        // mm/s; kısa hareketlerde maxSpeed'e ulaşılmaz
+    int phaseCount;
+    MotionPhase phases[7];
+    
+    MotionSample sampleAt(double time) const;
 };
 
 struct AxisLimits {
@@ -49,8 +76,21 @@ struct AxisPosition {
     double currentVelocity;
     double currentAcceleration;
     MicrostepMode microstepMode;
-    int stepsPerRevolution;
-    double mmPerStep;
+    int stepsPerRevolution;     // Tam adım / tur
+    double mmPerStep;           // Tam adım başına mm (vida adımı / stepsPerRevolution)
+    double maxRate;             // mm/min (GRBL $110-$112)
+    double maxAcceleration;     // mm/s² (GRBL $120-$122)
+};
+
+// Çok eksenli doğrusal hareket. Tek profil yol uzunluğu boyunca planlanır
+// (0 → length); her eksenin konumu başlangıç + yön · s, böylece eksenler aynı
+// anda başlar ve biter.
+struct CoordinatedMove {
+    QMap<char, double> startPositions;
+    QMap<char, double> targetPositions;
+    QMap<char, double> direction;   // Birim vektör bileşenleri (yalnızca hareket eden eksenler)
+    double length;                  // mm
+    MotionProfile profile;          // Yol profili: startPosition 0, endPosition length
 };
 
 class AxisController : public QObject
@@ -91,11 +131,25 @@ public:
     void stopAllMovement();
     bool isMoving(char axis) const;
     
-    // Yeni: Gelişmiş hareket planlayıcı
+    // Yeni: Koordineli çok eksenli hareket (feedRate mm/min yol hızı; <= 0 ise rapid)
+    CoordinatedMove planCoordinatedMove(const QMap<char, double> &targets, double feedRate);
+    void executeCoordinatedMove(const CoordinatedMove &move);
+    void moveToPositions(const QMap<char, double> &targets, double feedRate);
+    bool isCoordinatedMoveActive() const;
+    
+    // Yeni: Eksen başına hız ve ivme limitleri
+    void setAxisMaxRate(char axis, double rate);
+    double getAxisMaxRate(char axis) const;
+    void setAxisAcceleration(char axis, double acceleration);
+    double getAxisAcceleration(char axis) const;
+    
+    // Yeni: Gelişmiş hareket planlayıcı (maxSpeed mm/min, acceleration mm/s², jerk mm/s³)
     MotionProfile createMotionProfile(char axis, double startPos, double endPos, double maxSpeed, double acceleration);
     MotionProfile createSCurveProfile(char axis, double startPos, double endPos, double maxSpeed, double acceleration, double jerk);
     MotionProfile createTrapezoidalProfile(char axis, double startPos, double endPos, double maxSpeed, double acceleration);
     void executeMotionProfile(char axis, const MotionProfile &profile);
+    // Grafik/analiz için profilden eşit aralıklı örnekler (son nokta her zaman dahil)
+    QVector<MotionSample> generateProfilePoints(const MotionProfile &profile, double interval) const;
     
     // Yeni: Mikro-adım kontrolü
     void setMicrostepMode(char axis, MicrostepMode mode);
@@ -104,6 +158,13 @@ public:
     int getStepsPerRevolution(char axis) const;
     void setMmPerStep(char axis, double mmPerStep);
     double getMmPerStep(char axis) const;
+    double getStepsPerMm(char axis) const;          // Mikro-adım dahil
+    
+    // Yeni: Adım üreteci öykünmesi. Program GRBL gibi planlanıp adım segmentlerine
+    // bölünür; tepe frekanslar ve sınırı aşan satırlar raporlanır (mikro-adım seçimi için).
+    StepRateReport analyzeStepRates(const QStringList &program,
+                                    double stepRateCeiling = StepGenerator::DEFAULT_STEP_RATE_CEILING,
+                                    bool recordSegments = false) const;
     
     // Yeni: Hız profili ayarları
     void setAccelerationProfile(AccelerationProfile profile);
@@ -125,6 +186,12 @@ public:
     double getCurrentAcceleration(char axis) const;
     double getTotalDistance(char axis) const;
     double getTotalTime(char axis) const;
+    
+    // Yeni: Simülasyon saati. Hareket sabit adımlarla ilerler; toplu modda
+    // runUntilIdle() tüm hareketi duvar saatini beklemeden tamamlar.
+    SimulationClock *getSimulationClock() const;
+    bool hasActiveMotion() const;
+    double runUntilIdle(double maxSeconds = 3600.0);   // İşlenen simülasyon süresi, s
 
 signals:
     void positionChanged(char axis, double position);
@@ -137,22 +204,26 @@ signals:
     void velocityChanged(char axis, double velocity);
     void accelerationChanged(char axis, double acceleration);
     void profileCompleted(char axis, const MotionProfile &profile);
+    void coordinatedMoveCompleted(const CoordinatedMove &move);
 
 private slots:
-    void updateJogMovement();
-    void updateContinuousMovement();
-    void updateMotionProfile();
+    void advanceSimulation(double dt);
+    void publishFrame();
 
 private:
     QMap<char, AxisPosition> axisPositions;
     QMap<char, AxisLimits> axisLimits;
     QMap<char, MotionProfile> activeProfiles;
-    QTimer *jogTimer;
-    QTimer *continuousTimer;
-    QTimer *motionTimer;
+    SimulationClock *simulationClock;
+    QSet<char> changedAxes;             // Son yayından beri konumu değişen eksenler
+    QMap<char, double> profileElapsed;  // Çalışan profilin geçen süresi, s
+    CoordinatedMove activeMove;
+    bool coordinatedMoveActive;
+    double coordinatedElapsed;          // s
     
     char currentJogAxis;
     bool currentJogPositive;
+    bool continuousJogActive;
     double jogStep;
     double jogSpeed;
     double acceleration;
@@ -164,15 +235,21 @@ private:
     void initializeAxis(char axis);
     bool validateMovement(char axis, double newPosition) const;
     void updateAxisPosition(char axis, double newPosition);
-    double calculateJogDistance() const;
-    void applyAcceleration();
+    double calculateJogDistance(double dt) const;
+    void applyAcceleration(double dt);
     
     // Yeni yardımcı fonksiyonlar
-    double calculateSCurveVelocity(double time, double maxSpeed, double acceleration, double jerk);
-    double calculateTrapezoidalVelocity(double time, double maxSpeed, double acceleration);
-    double calculatePositionFromVelocity(double velocity, double time);
-    void updateProfileExecution(char axis);
-    void generateProfilePoints(MotionProfile &profile);
+    MotionProfile createLinearProfile(double startPos, double endPos, double maxSpeed, double acceleration) const;
+    MotionProfile emptyProfile(double startPos, double endPos, double maxSpeed, double acceleration) const;
+    void appendPhase(MotionProfile &profile, double duration, double jerk, double startAcceleration) const;
+    void updateContinuousMovement(double dt);
+    void updateProfileExecution(char axis, double dt);
+    void updateCoordinatedMove(double dt);
+    void abortCoordinatedMove();
+    void startSimulation();
+    void setSimulatedPosition(char axis, double position);
+    void publishAxis(char axis);
+    QVector<StepBlock> programToStepBlocks(const QStringList &program, const double start[3]) const;
 };
 
 #endif // AXISCONTROLLER_H 
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef CONTROLLERSETTINGS_H
+#define CONTROLLERSETTINGS_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+// Kontrolcüden okunan $$ ayarlarının tipli önbelleği. Bağlantı başına bir
+// kez doldurulur; $N= yazımları ilgili değeri geçersiz kılar. Böylece hız,
+// ivme ve kurs limitleri seri gidiş-dönüş olmadan okunabilir.
+//
+// Numaralı ayarlar GRBL 1.1 ($0-$132) ve grbl_ESP32'nin A/B/C eksenleri
+// ($103-$105, $113-$115, $123-$125, $133-$135). grbl_ESP32'nin isimli
+// ayarları ($Sta/SSID=...) metin olarak saklanır.
+class ControllerSettings
+{
+public:
+    // GRBL ayar numaraları
+    enum Setting {
+        StepPulseTime = 0,
+        StepIdleDelay = 1,
+        StatusReportMask = 10,
+        JunctionDeviation = 11,
+        ArcTolerance = 12,
+        ReportInches = 13,
+        SoftLimits = 20,
+        HardLimits = 21,
+        HomingCycle = 22,
+        HomingFeed = 24,
+        HomingSeek = 25,
+        SpindleMax = 30,
+        SpindleMin = 31,
+        LaserMode = 32,
+        StepsPerMmBase = 100,
+        MaxRateBase = 110,
+        AccelerationBase = 120,
+        MaxTravelBase = 130
+    };
+    
+    ControllerSettings();
+    
+    // Önbellek durumu
+    bool isLoaded() const;
+    void setLoaded(bool loaded);
+    void clear();
+    
+    // $$ / $S yanıt satırını işler; ayar satırı değilse false
+    bool parseLine(const QString &line);
+    
+    bool has(int number) const;
+    double value(int number, double defaultValue = 0.0) const;
+    void setValue(int number, double value);
+    void invalidate(int number);
+    QMap<int, double> numericSettings() const;
+    QString namedValue(const QString &name) const;
+    
+    // Eksen ayarları (axis: X, Y, Z, A, B, C)
+    double getStepsPerMm(char axis) const;
+    double getMaxRate(char axis) const;        // mm/min
+    double getAcceleration(char axis) const;   // mm/s²
+    double getMaxTravel(char axis) const;      // mm
+    
+    // Genel ayarlar
+    int getStatusReportMask() const;
+    double getJunctionDeviation() const;
+    double getArcTolerance() const;
+    bool isReportInches() const;
+    bool isSoftLimitsEnabled() const;
+    bool isHardLimitsEnabled() const;
+    bool isHomingEnabled() const;
+    double getSpindleMax() const;
+    double getSpindleMin() const;
+    bool isLaserMode() const;
+    
+    // Profil ile önbellek arasındaki farkı $N=değer komutlarına çevirir
+    QStringList diff(const QMap<int, double> &profile) const;
+    static QString formatWrite(int number, double value);
+    static bool parseWrite(const QString &command, int &number, double &value);
+    static int axisSetting(int base, char axis); // Geçersiz eksen: -1
+
+private:
+    QMap<int, double> values;
+    QMap<QString, QString> namedValues;
+    bool loaded;
+};
+
+#endif // CONTROLLERSETTINGS_H
@@ -0,0 +1,77 @@
+#ifndef GCODECOMPACTOR_H
+#define GCODECOMPACTOR_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// Gönderim öncesi G-code sıkıştırma: yorumlar, boşluklar ve satır
+// numaraları atılır, kontrolcünün zaten bildiği modal G/F kelimeleri
+// düşürülür ve sayılar kontrolcü çözünürlüğüne göre yazılır.
+// "G01 X10.000000 Y5.500 F1000 ; kenar" -> "X10Y5.5" (G1 F1000 modal iken)
+// "G21 G1 X1 F100", "G20", "G1 X2 F100" -> üçüncü satırda F100 korunur:
+// birim değişince F (100 mm/dk yerine 100 inç/dk) yeniden gönderilir.
+//
+// Modal durum yalnızca bu sınıftan geçen satırlardan izlenir. Karakter
+// saymada satırlar öncekilerin ok'u gelmeden sıkıştırılır; önceki satır hata
+// verirse koyduğu modal kelime hiç uygulanmamış olur. Bu yüzden bir kelime
+// ancak onu ayarlayan satır acknowledge() ile onaylandıysa düşürülür.
+// Kontrolcü durumu belirsizleşince (hata, reset, alarm) invalidate() çağrılmalıdır.
+class GCodeCompactor
+{
+public:
+    GCodeCompactor();
+    
+    QString compact(const QString &line);
+    quint64 getLastLineId() const;          // Son compact() çağrısının satır kimliği
+    void acknowledge(quint64 lineId);       // Satır (ve öncekiler) ok ile kabul edildi
+    void invalidate();
+    
+    // Mutlak koordinatlar için ondalık hane sayısı (mm / inç)
+    void setDecimals(int mmDecimals, int inchDecimals);
+    int getMmDecimals() const;
+    
+    // İstatistikler (satır sonu dahil bayt)
+    qint64 getBytesIn() const;
+    qint64 getBytesOut() const;
+    qint64 getBytesSaved() const;
+    void resetStatistics();
+
+private:
+    struct Word {
+        QChar letter;
+        QString number;
+        double value;
+    };
+    
+    // Modal grup değeri ve bu değere geçiren satır
+    struct ModalGroup {
+        int value;          // -1 = bilinmiyor
+        quint64 setBy;
+    };
+    
+    ModalGroup motionMode;      // 0, 1, 2, 3, 80
+    ModalGroup planeMode;       // 17, 18, 19
+    ModalGroup distanceMode;    // 90, 91
+    ModalGroup unitsMode;       // 20, 21
+    ModalGroup feedMode;        // 93, 94
+    ModalGroup coordSystem;     // 54..59
+    QString feedRate;           // Biçimlenmiş F değeri; boş = bilinmiyor
+    quint64 feedRateSetBy;
+    
+    quint64 lastLineId;
+    quint64 acknowledgedLineId;
+    
+    int mmDecimals;
+    int inchDecimals;
+    qint64 bytesIn;
+    qint64 bytesOut;
+    
+    QString stripCommentsAndSpaces(const QString &line) const;
+    bool parseWords(const QString &clean, QVector<Word> &words) const;
+    ModalGroup *modalGroupFor(int code);
+    QString formatNumber(double value, int decimals) const;
+    QString finish(const QString &output);
+};
+
+#endif // GCODECOMPACTOR_H
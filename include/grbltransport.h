@@ -0,0 +1,201 @@
+#ifndef GRBLTRANSPORT_H
+#define GRBLTRANSPORT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QSerialPort>
+
+class QIODevice;
+class QSocketNotifier;
+class QTcpSocket;
+class QWebSocket;
+
+// SerialCommunication'ın altındaki bayt taşıma katmanı. Akış kontrolü ve
+// yanıt ayrıştırma tüm taşıyıcılarda ortaktır; taşıyıcı yalnızca baytları
+// iletir ve gelen veriyi satırlara böler.
+//
+// open() bağlantıyı başlatır. Bağlantı kullanıma hazır olduğunda opened()
+// yayınlanır (seri port/cihazda hemen, ağ taşıyıcılarında el sıkışmadan sonra).
+class GrblTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GrblTransport(QObject *parent = nullptr);
+    
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+    virtual qint64 write(const QByteArray &data) = 0;
+    virtual QString describe() const = 0;
+    QString errorString() const;
+    
+    bool canReadLine() const;
+    QByteArray readLine();
+
+signals:
+    void opened();
+    void closed();
+    void readyRead();
+    void bytesReceived(const QByteArray &data); // Ham veri (trafik kaydı için)
+    void errorOccurred(const QString &error);
+
+protected:
+    void appendReceived(const QByteArray &data);
+    void clearReceived();
+    void setErrorString(const QString &error);
+
+private:
+    QByteArray receiveBuffer;
+    QString lastError;
+};
+
+// USB-UART köprüsü üzerinden klasik seri bağlantı
+class SerialTransport : public GrblTransport
+{
+    Q_OBJECT
+
+public:
+    explicit SerialTransport(const QString &portName, int baudRate, QObject *parent = nullptr);
+    
+    bool open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const QByteArray &data) override;
+    QString describe() const override;
+    
+    QSerialPort *port() const;
+
+private slots:
+    void handleReadyRead();
+    void handleError(QSerialPort::SerialPortError error);
+
+private:
+    QSerialPort *serialPort;
+};
+
+// Harici bir QIODevice (örn. VirtualGrblDevice); cihazın sahibi çağırandır
+class IODeviceTransport : public GrblTransport
+{
+    Q_OBJECT
+
+public:
+    explicit IODeviceTransport(QIODevice *device, QObject *parent = nullptr);
+    
+    bool open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const QByteArray &data) override;
+    QString describe() const override;
+
+private slots:
+    void handleReadyRead();
+
+private:
+    QIODevice *device;
+};
+
+// grbl_ESP32 Telnet sunucusu (varsayılan port 23) veya ham TCP köprüsü.
+// Sunucudan gelebilecek Telnet IAC dizileri ayıklanır.
+class TcpTransport : public GrblTransport
+{
+    Q_OBJECT
+
+public:
+    TcpTransport(const QString &host, quint16 port, QObject *parent = nullptr);
+    
+    bool open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const QByteArray &data) override;
+    QString describe() const override;
+
+private slots:
+    void handleConnected();
+    void handleDisconnected();
+    void handleReadyRead();
+    void handleSocketError();
+
+private:
+    QTcpSocket *socket;
+    QString hostName;
+    quint16 portNumber;
+    int telnetState;      // IAC ayrıştırıcı durumu
+    
+    QByteArray stripTelnetCommands(const QByteArray &data);
+};
+
+// grbl_ESP32 WebSocket sunucusu (varsayılan ws://host:81). Kontrolcü
+// çıktısı ikili veya metin çerçeveleriyle gelebilir; her write() tek
+// ikili çerçevedir.
+class WebSocketTransport : public GrblTransport
+{
+    Q_OBJECT
+
+public:
+    explicit WebSocketTransport(const QUrl &url, QObject *parent = nullptr);
+    
+    bool open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const QByteArray &data) override;
+    QString describe() const override;
+
+private slots:
+    void handleConnected();
+    void handleDisconnected();
+    void handleBinaryMessage(const QByteArray &message);
+    void handleTextMessage(const QString &message);
+    void handleSocketError();
+
+private:
+    QWebSocket *socket;
+    QUrl serverUrl;
+};
+
+#ifdef Q_OS_LINUX
+// Linux'a özgü düşük gecikmeli seri taşıyıcı. USB-seri köprülerde okuma başına
+// 1-16 ms ekleyen gecikme zamanlayıcısını ve QSerialPort'un ara tamponunu atlar:
+// termios ham mod (VMIN=1, VTIME=0: ilk baytta uyan, baytlar arası zamanlayıcı yok),
+// ASYNC_LOW_LATENCY ve FTDI için latency_timer=1. Okuma, taşıyıcının yaşadığı G/Ç
+// iş parçacığında epoll ile yapılır. Sürücü desteklemiyorsa (örn. pty) düşük gecikme
+// bayrakları atlanır, bağlantı yine açılır.
+class LinuxSerialTransport : public GrblTransport
+{
+    Q_OBJECT
+
+public:
+    explicit LinuxSerialTransport(const QString &portName, int baudRate, QObject *parent = nullptr);
+    ~LinuxSerialTransport();
+    
+    bool open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const QByteArray &data) override;
+    QString describe() const override;
+    
+    bool isLowLatencyEnabled() const;   // ASYNC_LOW_LATENCY sürücü tarafından kabul edildi
+
+private slots:
+    void handleEpollReady();
+
+private:
+    QString portName;
+    int baudRate;
+    int fd;
+    int epollFd;
+    QSocketNotifier *notifier;
+    QByteArray pendingWrite;    // Çekirdek tamponu doluyken yazılamayan kısım
+    bool lowLatency;
+    
+    bool configureTermios();
+    void enableLowLatency();
+    void flushPendingWrite();
+    void updateEpollEvents();
+    void failAndClose(const QString &error);
+};
+#endif
+
+#endif // GRBLTRANSPORT_H
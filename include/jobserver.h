@@ -0,0 +1,82 @@
+#ifndef JOBSERVER_H
+#define JOBSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QQueue>
+#include <QSet>
+#include <QString>
+#include "machinemanager.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+// Masaüstü oturumu olmadan iş kuyruğu ve akış: MachineManager üzerinde yerel
+// soket (Unix soketi / Windows named pipe) API'si. Protokol satır başına bir
+// JSON nesnesidir; her isteğe {"ok":true,...} veya {"ok":false,"error":"..."}
+// ile yanıt verilir, isteğin "id" alanı yanıta aynen kopyalanır.
+//
+//   {"cmd":"connect","machine":"cnc1","port":"/dev/ttyUSB0","baud":115200}
+//   {"cmd":"connect","machine":"cnc2","host":"192.168.1.5","tcpPort":23}
+//   {"cmd":"queue","machine":"cnc1","file":"/srv/jobs/part.nc"}
+//   {"cmd":"queue","machine":"cnc1","file":"/srv/jobs/part.nc","check":true}   ($C kuru çalıştırma)
+//   {"cmd":"status"}  {"cmd":"pause|hold|resume|stop","machine":"cnc1"}
+//   {"cmd":"send","machine":"cnc1","line":"G0 X0"}  {"cmd":"subscribe"}
+//
+// Abone istemcilere {"event":"status|jobFinished|error",...} olayları gönderilir.
+// Kuyruktaki işler makine bağlı ve boşta olduğunda sırayla başlatılır.
+class JobServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JobServer(QObject *parent = nullptr);
+    ~JobServer();
+    
+    bool listen(const QString &socketName);   // Eski soket dosyası temizlenir
+    void close();
+    bool isListening() const;
+    QString getServerPath() const;
+    QString errorString() const;
+    
+    MachineManager *getMachineManager();
+    // "ad=/dev/ttyUSB0@115200" veya "ad=tcp:host:port" (komut satırı --machine)
+    bool addMachineFromSpec(const QString &spec, QString *error = nullptr);
+    
+    static const qint64 MAX_REQUEST_BYTES = 64 * 1024;
+    static const qint64 MAX_PENDING_EVENT_BYTES = 256 * 1024;
+
+private slots:
+    void handleNewConnection();
+    void handleClientReadyRead();
+    void handleClientDisconnected();
+    void handleSnapshotChanged(const QString &name);
+    void handleJobFinished(const QString &name, bool success);
+    void handleMachineError(const QString &name, const QString &error);
+
+private:
+    struct QueuedJob {
+        QString filePath;
+        JobMode mode;
+    };
+    
+    QLocalServer *server;
+    MachineManager *manager;
+    QSet<QLocalSocket *> subscribers;
+    QHash<QString, QQueue<QueuedJob>> jobQueues;
+    QHash<QString, QString> runningJobs;    // startJob çağrıldı, jobFinished bekleniyor
+    
+    QJsonObject handleRequest(const QJsonObject &request, QLocalSocket *client);
+    MachineSession *ensureMachine(const QString &name);
+    void connectMachine(MachineSession *session, const QString &portName, int baudRate,
+                        const QString &host, quint16 tcpPort);
+    void startNextJob(const QString &name);
+    QJsonObject machineToJson(const QString &name) const;
+    void broadcast(const QJsonObject &event);
+    static void sendJson(QLocalSocket *socket, const QJsonObject &object);
+    static QString jobStateName(JobState state);
+    static QString jobModeName(JobMode mode);
+};
+
+#endif // JOBSERVER_H
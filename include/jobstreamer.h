@@ -0,0 +1,142 @@
+#ifndef JOBSTREAMER_H
+#define JOBSTREAMER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QString>
+#include <QVector>
+#include "serialcommunication.h"
+
+class QIODevice;
+
+enum class JobState {
+    Idle,
+    Running,
+    Paused,     // Yeni satır gönderilmez, kontrolcüdekiler işlenir
+    FeedHold,   // Realtime '!' ile hareket durduruldu
+    Stopping    // Hold bekleniyor, ardından soft reset
+};
+
+enum class JobMode {
+    Run,
+    Check       // $C: GRBL satırları ayrıştırıp doğrular, hareket etmez
+};
+
+// Kontrolcünün reddettiği bir iş satırı (dosyadaki satır numarasıyla)
+struct JobLineError {
+    qint64 lineNumber;
+    QString text;
+    QString error;      // "error:20"
+};
+
+// Programı dosyadan satır satır okuyarak SerialCommunication'a akıtır.
+// Bellekte yalnızca sınırlı bir ön okuma penceresi ve kontrolcüye gönderilmiş
+// satırların numaraları tutulur; bellek kullanımı dosya boyutundan bağımsızdır.
+//
+// JobMode::Check kuru çalıştırmadır: kontrolcü $C ile check moduna alınır, program
+// bağlantının ve akış kontrolünün izin verdiği hızda akıtılır, her error:N satır
+// numarasıyla toplanır ve sonunda check modundan çıkılır (GRBL çıkışta soft reset yapar).
+class JobStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JobStreamer(SerialCommunication *serial, QObject *parent = nullptr);
+    ~JobStreamer();
+    
+    bool startFile(const QString &filePath, int firstLine = 1, JobMode mode = JobMode::Run);
+    bool startText(const QString &program, int firstLine = 1, JobMode mode = JobMode::Run);
+    void pause();
+    void feedHold();
+    void resume();
+    void stop();
+    
+    JobState getState() const;
+    JobMode getMode() const;
+    bool isActive() const;
+    qint64 getCurrentLine() const;      // Son tamamlanan satırın dosyadaki numarası
+    qint64 getLinesCompleted() const;
+    qint64 getErrorCount() const;
+    int getProgressPercent() const;     // Okunan bayta göre
+    qint64 getElapsedMs() const;        // Başlangıçtan (bitmişse bitişe) kadar
+    double getLinesPerSecond() const;
+    QVector<JobLineError> getLineErrors() const;   // İlk MAX_RECORDED_ERRORS hata
+    
+    // Ayarlar
+    void setPrefetchLines(int lines);   // Okunmuş, gönderilmeye hazır satır sınırı
+    void setQueueDepth(int lines);      // SerialCommunication'da yazılmayı bekleyen satır sınırı
+    void setStopOnError(bool enabled);  // Check modunda yok sayılır: tüm hatalar toplanır
+    
+    static const int MAX_RECORDED_ERRORS = 10000;
+    static const int CHECK_QUEUE_DEPTH = 64;    // Check modunda duraklatma gecikmesi önemsiz
+
+signals:
+    void stateChanged(JobState state);
+    void progressChanged(qint64 linesCompleted, int percent);
+    void lineFailed(qint64 lineNumber, const QString &line, const QString &error);
+    void finished(bool success);
+
+private slots:
+    void handleCommandResolved(quint64 sequence, CommandStatus status, const QString &response);
+    void handleStatusReport(const GrblStatusReport &report);
+    void handleDataReceived(const QString &line);
+    void handleDisconnected();
+
+private:
+    struct PrefetchedLine {
+        qint64 lineNumber;
+        QString text;
+        qint64 endOffset;   // Satır sonunun dosyadaki bayt konumu (ilerleme için)
+    };
+    
+    struct SentLine {
+        quint64 sequence;
+        PrefetchedLine line;
+    };
+    
+    enum class CheckPhase {
+        None,
+        Entering,   // $C yanıtı bekleniyor
+        Streaming,
+        Leaving     // Çıkış $C yanıtı bekleniyor
+    };
+    
+    SerialCommunication *serialComm;
+    QIODevice *source;
+    QQueue<PrefetchedLine> prefetch;
+    QQueue<SentLine> sentLines;         // ok/error bekleyen iş satırları
+    JobState state;
+    JobMode mode;
+    CheckPhase checkPhase;
+    bool checkModeOwned;                // Check modunu bu iş açtı, çıkarken kapatmalı
+    QVector<JobLineError> lineErrors;
+    QElapsedTimer jobClock;
+    qint64 finishedElapsedMs;           // -1: iş sürüyor
+    qint64 totalBytes;
+    qint64 bytesRead;
+    qint64 completedOffset;
+    qint64 nextLineNumber;
+    qint64 firstLineNumber;
+    qint64 currentLine;
+    qint64 linesCompleted;
+    qint64 errorCount;
+    int prefetchLimit;
+    int queueDepth;
+    bool stopOnError;
+    bool sourceExhausted;
+    
+    bool startSource(QIODevice *device, int firstLine, JobMode jobMode);
+    void enterCheckMode();
+    void leaveCheckMode();
+    void fillPrefetch();
+    void pump();
+    void finishJob(bool success);
+    void recordLineError(const PrefetchedLine &line, const QString &error);
+    void abortAfterControllerReset(const QString &reason);
+    void closeSource();
+    void setState(JobState newState);
+    static bool isExecutableLine(const QString &line);
+};
+
+#endif // JOBSTREAMER_H
@@ -0,0 +1,55 @@
+#ifndef JOGCONTROLLER_H
+#define JOGCONTROLLER_H
+
+#include <QObject>
+#include <QQueue>
+#include "serialcommunication.h"
+
+// Tuş/buton basılı tutulurken kontrolcüye kısa $J= artımları akıtır.
+// Artım süresi GRBL önerisine göre dt > v² / (2·a·(N-1)) seçilir: N-1
+// planlayıcı bloğu tam hızdan durmaya yeter, hareket kesintisiz sürer.
+// Bırakınca 0x85 (jog cancel) planlayıcıyı boşaltıp yavaşlayarak durdurur.
+class JogController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JogController(SerialCommunication *serial, QObject *parent = nullptr);
+    
+    bool start(char axis, bool positive, double feedRate); // feedRate: mm/min
+    void stop();
+    bool isJogging() const;
+    
+    // Kontrolcü ayarları ($120..) okunamadıysa kullanılacak ivme (mm/s²); GRBL varsayılanı 10
+    void setAcceleration(double mmPerSec2);
+    double getAcceleration() const;
+    void setMinIncrementTime(double seconds);
+    double getIncrementDistance() const;
+
+signals:
+    void jogStarted(char axis, bool positive);
+    void jogStopped();
+    void jogError(const QString &error);
+
+private slots:
+    void handleCommandResolved(quint64 sequence, CommandStatus status, const QString &response);
+    void handleDisconnected();
+
+private:
+    SerialCommunication *serialComm;
+    QQueue<quint64> outstanding;   // ok bekleyen jog satırları
+    char jogAxis;
+    bool jogPositive;
+    double jogFeedRate;
+    double incrementDistance;
+    double acceleration;
+    double minIncrementTime;
+    bool jogging;
+    
+    static const int MAX_OUTSTANDING = 2; // Planlayıcı dolunca ok'lar yürütme hızında gelir
+    
+    double calculateIncrementTime() const;
+    void sendIncrements();
+};
+
+#endif // JOGCONTROLLER_H
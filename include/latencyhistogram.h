@@ -0,0 +1,44 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QVector>
+#include <QString>
+#include <QtGlobal>
+
+// HDR tarzı log-lineer histogram. Her ikinin kuvveti aralığı 16 alt kovaya
+// bölünür; böylece sabit bellekle tüm 64-bit aralıkta ~%6 göreli hassasiyet
+// elde edilir. Birim bağımsızdır (mikrosaniye, bayt, ...).
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    
+    void record(qint64 value);
+    void reset();
+    void merge(const LatencyHistogram &other);
+    
+    // İstatistikler
+    quint64 count() const;
+    qint64 min() const;
+    qint64 max() const;
+    double mean() const;
+    qint64 percentile(double percent) const;
+    
+    // Örn: "n=1200 min=180 p50=420 p90=610 p99=1400 max=5200"
+    QString summary() const;
+
+private:
+    static const int SubBucketCount = 32;
+    static const int HalfSubBucketCount = SubBucketCount / 2;
+    
+    QVector<quint64> counts;
+    quint64 totalCount;
+    qint64 minValue;
+    qint64 maxValue;
+    double sum;
+    
+    static int bucketIndex(quint64 value);
+    static quint64 bucketUpperBound(int index);
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,186 @@
+#ifndef MACHINEMANAGER_H
+#define MACHINEMANAGER_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <atomic>
+#include "serialcommunication.h"
+#include "jobstreamer.h"
+
+class QThread;
+
+// Bir G-code dosyasının ön analiz özeti. Oluşturulduktan sonra değişmez;
+// aynı dosyayı çalıştıran tüm makine oturumları aynı örneği paylaşır.
+struct ProgramSummary {
+    QString filePath;
+    qint64 fileSize;
+    QDateTime lastModified;
+    qint64 totalLines;
+    qint64 executableLines;
+    qint64 invalidLines;
+    QStringList errors;         // "Satır N: mesaj" (ilk MAX_REPORTED_ERRORS kadar)
+    bool hasExtents;
+    double minX, minY, minZ;    // Mutlak (G90) hareketlerin sınırları
+    double maxX, maxY, maxZ;
+};
+
+// İş parçacıkları arasında paylaşılan ayrıştırma önbelleği. Anahtar dosya yolu;
+// boyut veya değişiklik zamanı farklıysa kayıt bayattır. Aynı dosya için eşzamanlı
+// istekler tek bir ayrıştırmayı bekler, dosya iki kez okunmaz.
+class ProgramCache
+{
+public:
+    explicit ProgramCache(int maxEntries = 32);
+    
+    // Güncel kayıt yoksa nullptr döner, ayrıştırma yapmaz
+    QSharedPointer<const ProgramSummary> lookup(const QString &filePath);
+    // Gerekirse çağıran iş parçacığında ayrıştırır (oturum iş parçacığında çağrılmamalı)
+    QSharedPointer<const ProgramSummary> summarize(const QString &filePath);
+    void invalidate(const QString &filePath);
+    void clear();
+    
+    quint64 getHitCount() const;
+    quint64 getMissCount() const;
+    
+    static const int MAX_REPORTED_ERRORS = 100;
+
+private:
+    struct Entry {
+        QSharedPointer<const ProgramSummary> summary;
+        quint64 lastUse;
+    };
+    
+    mutable QMutex mutex;
+    QWaitCondition parseFinished;
+    QHash<QString, Entry> entries;
+    QSet<QString> parsing;
+    int maxEntries;
+    quint64 useCounter;
+    quint64 hits;
+    quint64 misses;
+    
+    bool isCurrent(const ProgramSummary &summary, qint64 size, const QDateTime &modified) const;
+    void evictLocked();
+    static QSharedPointer<const ProgramSummary> parseFile(const QString &filePath);
+};
+
+// GUI'nin kendi hızında okuduğu oturum durumu (kopya olarak döner)
+struct MachineSnapshot {
+    QString name;
+    bool connected;
+    QString transport;
+    GrblStatusReport status;
+    JobState jobState;
+    JobMode jobMode;
+    QString jobFile;
+    qint64 linesCompleted;
+    int progressPercent;
+    qint64 jobErrors;
+    double linesPerSecond;
+    int pendingCommands;        // Gönderilmiş + kuyruktaki komutlar
+};
+
+// Tek bir makine: kendi iş parçacığında yaşayan SerialCommunication + JobStreamer.
+// Dışarıdan yalnızca kuyruklu çağrılarla (invokeMethod / sinyal) sürülür; durum
+// getSnapshot() ile kilit altında kopyalanır. Durum bildirimi birleştirilir: GUI bir
+// önceki snapshotChanged'i okumadan yenisi kuyruğa eklenmez, yavaş bir arayüz
+// oturum iş parçacığını ve akışı bekletmez.
+class MachineSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    MachineSession(const QString &name, ProgramCache *cache, QThreadPool *analysisPool);
+    ~MachineSession();
+    
+    QString getName() const;
+    MachineSnapshot getSnapshot() const;   // Her iş parçacığından çağrılabilir
+    
+    // Yalnızca oturum iş parçacığında kullanılmalı
+    SerialCommunication *getSerialCommunication() const;
+    JobStreamer *getJobStreamer() const;
+
+public slots:
+    void connectToDevice(const QString &portName, int baudRate = 115200);
+    void connectToHost(const QString &host, quint16 port = 23);
+    void disconnectFromDevice();
+    void sendCommand(const QString &command);
+    void startJob(const QString &filePath, JobMode mode = JobMode::Run);   // Check: $C kuru çalıştırma
+    void pauseJob();
+    void feedHold();
+    void resumeJob();
+    void stopJob();
+    void shutdown(QThread *targetThread);  // Bağlantıyı kapatır ve nesneyi hedef iş parçacığına iter
+
+signals:
+    void snapshotChanged(const QString &name);
+    void programAnalyzed(const QString &name, const QString &filePath, qint64 executableLines, qint64 invalidLines);
+    void jobFinished(const QString &name, bool success);   // Meşgulken reddedilenler hariç her startJob için bir kez
+    void errorOccurred(const QString &name, const QString &error);
+
+private:
+    QString name;
+    ProgramCache *programCache;
+    QThreadPool *analysisPool;  // Ayrıştırma oturum iş parçacığını bekletmez
+    SerialCommunication *serialComm;
+    JobStreamer *jobStreamer;
+    QString pendingJobFile;     // Analiz bekleyen iş
+    JobMode pendingJobMode;
+    quint64 analysisToken;      // stopJob eski analiz sonuçlarını geçersiz kılar
+    
+    mutable QMutex snapshotMutex;
+    MachineSnapshot snapshot;
+    mutable std::atomic<bool> notifyPending;
+    
+    void handleProgramSummary(quint64 token, const QString &filePath,
+                              QSharedPointer<const ProgramSummary> summary);
+    void abandonPendingJob();
+    void updateSnapshot();
+    void notifySnapshot();
+};
+
+// N bağımsız makine oturumunu barındırır: her oturum için ayrı bir QThread
+// açar ve ortak ProgramCache'i paylaştırır. Yönetici GUI iş parçacığında yaşar.
+class MachineManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MachineManager(QObject *parent = nullptr);
+    ~MachineManager();
+    
+    MachineSession *addMachine(const QString &name);   // Ad kullanılıyorsa nullptr
+    bool removeMachine(const QString &name);
+    MachineSession *getMachine(const QString &name) const;
+    QStringList getMachineNames() const;
+    int getMachineCount() const;
+    ProgramCache *getProgramCache();
+    void shutdown();
+
+signals:
+    void machineAdded(const QString &name);
+    void machineRemoved(const QString &name);
+
+private:
+    struct HostedMachine {
+        MachineSession *session;
+        QThread *thread;
+    };
+    
+    QMap<QString, HostedMachine> machines;
+    ProgramCache programCache;
+    QThreadPool analysisPool;
+    
+    void stopMachine(HostedMachine &machine);
+};
+
+#endif // MACHINEMANAGER_H
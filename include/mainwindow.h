@@ -38,6 +38,9 @@
 #include "axiscontroller.h"
 #include "settings.h"
 #include "logger.h"
+#include "positioninterpolator.h"
+#include "jobstreamer.h"
+#include "jogcontroller.h"
 
 class MainWindow : public QMainWindow
 {
@@ -93,7 +96,6 @@ private slots:
     
     // G-code işleme
     void sendGCodeCommand();
-    void processGCodeFile();
     void runFromLine();
     void updateJogSpeed();
     void updateTotalLines();
@@ -183,8 +185,6 @@ private:
     
     // G-code dosyası
     QString currentGCodeFile;
-    QStringList gcodeCommands;
-    int currentCommandIndex;
     
     // Hız kontrolü - Güncellenmiş
     int jogSpeed;           // Jog hızı (mm/min)
@@ -217,6 +217,9 @@ private:
     GCodeParser *gcodeParser;
     SerialCommunication *serialComm;
     AxisController *axisController;
+    PositionInterpolator *positionInterpolator;
+    JobStreamer *jobStreamer;
+    JogController *jogController;
     Settings *settings;
     Logger *logger;
 };
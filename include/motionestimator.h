@@ -0,0 +1,56 @@
+#ifndef MOTIONESTIMATOR_H
+#define MOTIONESTIMATOR_H
+
+#include <QString>
+
+class ControllerSettings;
+
+// Kontrolcüye giden satırların hareket süresini tahmin eder. Satırlar gönderim
+// sırasıyla verilmelidir; modal durum ve iş koordinatı konumu bu satırlardan izlenir.
+// Tahmin bilerek üst sınırdır: her blok duruştan başlayıp duruşa iner (d/v + v/a),
+// hız ve ivme hareket yönüne izdüşürülmüş eksen limitleriyle sınırlanır. Ack zaman
+// aşımı bu süreden türetildiği için kısa tahmin yanlış alarm, uzun tahmin yalnızca
+// geç fark edilen bir kopukluk demektir.
+class MotionEstimator
+{
+public:
+    MotionEstimator();
+    
+    // Hız/ivme/kurs limitleri; nullptr veya eksik ayarda GRBL varsayılanları kullanılır
+    void setSettings(const ControllerSettings *settings);
+    
+    // Satırın tahmini çalışma süresi (s); hareket yoksa 0. Konum ve modal durum ilerletilir.
+    double estimate(const QString &line);
+    
+    // Reset/alarm sonrası: modal durum ve konum bilinmiyor
+    void invalidate();
+    // Kontrolcü boştayken status raporundan gerçek iş koordinatı konumu
+    void syncPosition(double x, double y, double z);
+    bool isPositionKnown() const;
+    
+    static const int AXIS_COUNT = 3;
+
+private:
+    const ControllerSettings *settings;
+    double position[AXIS_COUNT];    // İş koordinatı, mm
+    bool positionKnown[AXIS_COUNT];
+    int motionMode;                 // 0, 1, 2, 3; -1 = bilinmiyor / iptal
+    int planeMode;                  // 17, 18, 19
+    bool absoluteMode;              // G90 / G91
+    bool inchUnits;                 // G20 / G21
+    bool inverseTimeFeed;           // G93
+    double feedRate;                // mm/min (G93'te 1/dk); 0 = bilinmiyor
+    
+    double estimateJog(const QString &body);
+    double estimateHoming() const;
+    void applyProgramEnd();
+    double moveTime(const double delta[AXIS_COUNT], double length, bool rapid, double feed) const;
+    double arcLength(const double start[AXIS_COUNT], const double target[AXIS_COUNT],
+                     const double offset[AXIS_COUNT], bool hasOffset, double radius,
+                     bool clockwise) const;
+    double axisMaxRate(int axis) const;       // mm/min
+    double axisAcceleration(int axis) const;  // mm/s²
+    double axisMaxTravel(int axis) const;     // mm
+};
+
+#endif // MOTIONESTIMATOR_H
@@ -0,0 +1,53 @@
+#ifndef POSITIONINTERPOLATOR_H
+#define POSITIONINTERPOLATOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector3D>
+#include "serialcommunication.h"
+
+// Status raporları arasında takım pozisyonunu raporlanan ilerleme hızıyla
+// tahmin eder. Böylece önizleme ve DRO, bağlantıyı daha sık sorgulamadan
+// akıcı şekilde güncellenir.
+class PositionInterpolator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PositionInterpolator(QObject *parent = nullptr);
+    
+    // Ayarlar
+    void setDisplayRate(int hz);
+    int getDisplayRate() const;
+    void setMaxExtrapolationTime(int milliseconds);
+    
+    QVector3D getInterpolatedPosition() const;
+
+public slots:
+    void updateFromReport(const GrblStatusReport &report);
+    void reset();
+
+signals:
+    void interpolatedPositionChanged(double x, double y, double z);
+
+private slots:
+    void updateDisplay();
+
+private:
+    QTimer *displayTimer;
+    QElapsedTimer reportClock;
+    
+    QVector3D lastReportedPosition;
+    QVector3D previousReportedPosition;
+    QVector3D direction;        // Birim hareket yönü
+    double feedRateMMPerSec;
+    qint64 lastReportTimeMs;
+    qint64 reportIntervalMs;
+    int maxExtrapolationMs;
+    bool hasReport;
+    
+    bool isMovingState(const QString &state) const;
+};
+
+#endif // POSITIONINTERPOLATOR_H
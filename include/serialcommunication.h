@@ -2,10 +2,21 @@
 #define SERIALCOMMUNICATION_H
 
 #include <QObject>
-#include <QSerialPort>
 #include <QSerialPortInfo>
 #include <QTimer>
 #include <QQueue>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QPromise>
+#include <QSharedPointer>
+#include "latencyhistogram.h"
+#include "gcodecompactor.h"
+#include "grbltransport.h"
+#include "trafficrecorder.h"
+#include "telemetryrecorder.h"
+#include "controllersettings.h"
+#include "motionestimator.h"
 
 enum class LimitSwitchState {
     NotTriggered,
@@ -38,6 +49,97 @@ struct SpindleStatus {
     bool airBlastOn;
 };
 
+// GRBL 1.1 status raporu: <Idle|MPos:0.000,0.000,0.000|Bf:15,128|FS:0,0>
+struct GrblStatusReport {
+    QString state;
+    int subState;               // Hold:N / Door:N alt durumu, -1 = yok
+    double mposX;
+    double mposY;
+    double mposZ;
+    double wposX;               // İş koordinatı: MPos - WCO
+    double wposY;
+    double wposZ;
+    double wcoX;                // Son bildirilen WCO (GRBL bunu ara sıra gönderir)
+    double wcoY;
+    double wcoZ;
+    double feedRate;
+    double spindleSpeed;
+    int plannerBlocksAvailable; // -1 = raporda yok
+    int rxBytesAvailable;       // -1 = raporda yok
+    qint64 timestampMs;         // Monotonik alış zamanı
+};
+
+Q_DECLARE_METATYPE(GrblStatusReport)
+
+// Komut akış modu
+enum class StreamingMode {
+    PingPong,          // Her satır için ok beklenir
+    CharacterCounting  // RX tamponu dolana kadar satırlar art arda gönderilir
+};
+
+// connectToDevice() için seri port altyapısı
+enum class SerialBackend {
+    QtSerialPort,   // Taşınabilir varsayılan
+    LinuxNative     // termios + ASYNC_LOW_LATENCY + epoll (yalnızca Linux)
+};
+
+// Giden kuyruk şeritleri, öncelik sırasıyla. Yazılmamış satırlar arasında katı
+// öncelik uygulanır; kontrolcüdeki satırların önüne yalnızca realtime komutlar geçer.
+enum class CommandLane {
+    Safety,     // $X, $H: her şeyin önünde
+    Jog,        // $J=: yalnızca makine Idle/Jog iken ve başka şerit yolda değilken
+    Mdi,        // Kullanıcı komutları: iş satırlarının arasına, satır sınırında girer
+    Job         // Program akışı
+};
+
+const int COMMAND_LANE_COUNT = 4;
+
+struct LaneStatistics {
+    int queued;             // Şu an bekleyen
+    int inFlight;           // Yazıldı, ok bekleniyor
+    int maxQueued;          // Görülen en büyük kuyruk derinliği
+    quint64 sent;
+    quint64 heldCount;      // Kuyruk başının kontrolcü durumu nedeniyle bekletildiği dönemler
+};
+
+// Gönderilen her satır: sıra numarası ve monotonik zaman damgaları (ns).
+// Satır yazılırken bir kez (gerekirse sıkıştırılarak) UTF-8'e çevrilir ("G1 X10\n");
+// sıkıştırıcının modal durumu böylece kontrolcüye gerçekten gidiş sırasını izler.
+struct QueuedCommand {
+    quint64 sequence;
+    CommandLane lane;
+    QString text;           // Kuyruğa girdiği hali
+    QByteArray data;        // Yazılan hali (yazılana kadar boş)
+    int rawSize;            // Ham satırın UTF-8 boyutu + '\n'; sıkıştırma kısaltır, üst sınırdır
+    quint64 compactorLine;  // GCodeCompactor satır kimliği; 0 = sıkıştırılmadı
+    qint64 enqueuedNs;
+    qint64 writtenNs;
+    qint64 ackNs;
+    double estimatedSeconds;    // Yazım anındaki hareket süresi tahmini (ack zaman aşımı için)
+};
+
+// sendCommandAsync sonucu: komutun kendi yanıtı, sinyallerden tahmin edilmez
+enum class CommandStatus {
+    Ok,
+    Error,      // error:N
+    Alarm,      // Komut çalışırken ALARM:N
+    Timeout,    // Yanıt süresi doldu, komut atlandı
+    Cancelled,  // Soft reset, kuyruk temizleme veya bağlantı kopması
+    Rejected    // Bağlı değil / güvenlik kontrolü / yazılamadı
+};
+
+struct CommandResult {
+    quint64 sequence;       // 0 = kuyruğa hiç girmedi
+    QString command;
+    CommandStatus status;
+    int code;               // error:N veya ALARM:N kodu, yoksa 0
+    QString response;       // Komutu sonlandıran satır veya iptal nedeni
+    QStringList data;       // ok'tan önce gelen yanıt satırları ([GC:...], $N=..., [MSG:...])
+    qint64 ackLatencyUs;    // -1 = yanıt yok
+    
+    bool isOk() const { return status == CommandStatus::Ok; }
+};
+
 class SerialCommunication : public QObject
 {
     Q_OBJECT
@@ -48,15 +150,29 @@ public:
     
     // Bağlantı yönetimi
     bool connectToDevice(const QString &portName, int baudRate = 115200);
+    void setSerialBackend(SerialBackend backend);   // Sonraki connectToDevice için
+    SerialBackend getSerialBackend() const;
+    bool connectToHost(const QString &host, quint16 port = 23); // grbl_ESP32 Telnet
+    bool connectToWebSocket(const QUrl &url);                   // Örn: ws://cnc.local:81
+    bool connectToIODevice(QIODevice *device); // Örn: VirtualGrblDevice
+    bool connectWithTransport(GrblTransport *transport); // Sahiplik devralınır
+    QString getTransportDescription() const;
     void disconnectFromDevice();
     bool isConnected() const;
     
     // Komut gönderme
-    bool sendCommand(const QString &command);
+    bool sendCommand(const QString &command, CommandLane lane = CommandLane::Mdi);
+    // Komut başına future: ok, error:N, ALARM:N, zaman aşımı veya iptal ile tamamlanır.
+    // Birden çok komut aynı anda bekletilebilir; sonuçlar sıra numarasıyla eşleşir.
+    QFuture<CommandResult> sendCommandAsync(const QString &command, CommandLane lane = CommandLane::Mdi);
     bool sendGCodeCommand(const QString &gcode);
     bool sendJogCommand(char axis, double distance, double speed);
     bool sendEmergencyStop();
     bool sendReset();
+    bool sendFeedHold();    // Realtime '!'
+    bool sendCycleStart();  // Realtime '~'
+    bool sendSoftReset();   // Realtime 0x18; kontrolcü tamponları boşaltır
+    bool sendJogCancel();   // Realtime 0x85; jog hareketini yavaşlatıp durdurur
     
     // Yeni: Hardware limit switch kontrolü
     void requestLimitSwitchStatus();
@@ -83,6 +199,73 @@ public:
     void requestPosition();
     void requestSettings();
     
+    // Yeni: Uyarlanabilir status sorgulama
+    void setStatusPollIntervals(int idleMs, int activeMs);
+    int getStatusPollInterval() const;
+    QString getMachineState() const;
+    
+    // Yeni: Akış kontrolü
+    void setStreamingMode(StreamingMode mode);
+    StreamingMode getStreamingMode() const;
+    void setRxBufferSize(int bytes);
+    int getRxBufferSize() const;
+    int getPlannerBlockCount() const;
+    int getPendingCommandCount() const;
+    int getQueuedCommandCount() const;   // Henüz yazılmamış olanlar
+    quint64 getLastQueuedSequence() const;
+    bool isCommandPending(quint64 sequence) const;  // Kuyrukta veya yolda, henüz sonuçlanmadı
+    void clearPendingCommands(); // Henüz yazılmamış satırları atar
+    void clearPendingCommands(CommandLane lane);
+    
+    // Yeni: Şerit metrikleri (kuyruk başı tıkanmasını görmek için)
+    int getLaneDepth(CommandLane lane) const;
+    LaneStatistics getLaneStatistics(CommandLane lane) const;
+    const LatencyHistogram &getLaneQueueWaitHistogram(CommandLane lane) const;
+    static QString laneName(CommandLane lane);
+    
+    // Yeni: Planlayıcıya duyarlı akış kontrolü (status raporundaki Bf: alanı)
+    void setPlannerAwareFlowControl(bool enabled);
+    bool isPlannerAwareFlowControlEnabled() const;
+    bool isStarvationRiskHigh() const;
+    quint64 getPlannerStarvationCount() const;
+    int getMaxLinesInFlight() const;
+    
+    // Yeni: Status rapor alanları ($10). Bağlantı başına bir kez, yalnızca
+    // gerekiyorsa yazılır: her $10 yazımı kontrolcüde bir EEPROM yazımıdır.
+    void setStatusMaskNegotiation(bool enabled);
+    int getDesiredStatusReportMask() const;
+    GrblStatusReport getLastStatusReport() const;
+    
+    // Yeni: Gönderim öncesi G-code sıkıştırma
+    void setGCodeCompactionEnabled(bool enabled);
+    bool isGCodeCompactionEnabled() const;
+    void setCompactionDecimals(int mmDecimals, int inchDecimals);
+    qint64 getCompactionBytesSaved() const;
+    const GCodeCompactor &getGCodeCompactor() const;
+    
+    // Yeni: $$ ayar önbelleği (bağlantı başına bir kez okunur)
+    const ControllerSettings &getControllerSettings() const;
+    int pushSettingsProfile(const QMap<int, double> &profile); // Yazılan ayar sayısı, -1: önbellek yok
+    
+    // Yeni: TX/RX trafik kaydı (ns zaman damgalı ikili dosya)
+    bool startTrafficCapture(const QString &filePath);
+    void stopTrafficCapture();
+    bool isTrafficCaptureActive() const;
+    void addTrafficMarker(const QString &text);
+    
+    // Yeni: Status raporu telemetrisi (kilitsiz halka tampon; her iş parçacığından okunabilir)
+    TelemetryRecorder *getTelemetryRecorder();
+    
+    // Yeni: Komut gecikme istatistikleri (süreler mikrosaniye)
+    const LatencyHistogram &getQueueWaitHistogram() const;
+    const LatencyHistogram &getAckLatencyHistogram() const;
+    const LatencyHistogram &getBytesInFlightHistogram() const;
+    const LatencyHistogram &getBatchSizeHistogram() const;
+    void resetLatencyStatistics();
+    QString getLatencySummary() const;
+    QString getLaneSummary() const;
+    void setLatencySummaryInterval(int milliseconds); // 0 = kapalı
+    
     // Ayarlar
     void setBaudRate(int baudRate);
     void setDataBits(int dataBits);
@@ -93,7 +276,16 @@ public:
     // Port listesi
     static QStringList getAvailablePorts();
     
+    // Ack zaman aşımı: taban süre + kontrolcüde sıradaki hareketin tahmini süresi.
+    // Status raporları gelmeye devam ettiği ve makine hareket/hold halinde olduğu sürece
+    // süre dolduğunda komut atlanmaz, yalnızca uzatılır.
+    void setAckTimeout(int milliseconds);
+    int getAckTimeout() const;
+    double getPlannedMotionSeconds() const;     // Ack'lenmiş, henüz çalışmamış blokların tahmini
+    quint64 getAckTimeoutExtensionCount() const;
+    
     // Yeni: Güvenlik ayarları
+    // safetyTimer status raporu bekçisidir: yolda iş varken bu süre boyunca rapor gelmezse durdurur
     void setSafetyTimeout(int milliseconds);
     int getSafetyTimeout() const;
     void enableSafetyChecks(bool enabled);
@@ -105,9 +297,17 @@ signals:
     void dataReceived(const QString &data);
     void errorOccurred(const QString &error);
     void statusUpdated(const QString &status);
+    void statusReportReceived(const GrblStatusReport &report);
     void positionUpdated(double x, double y, double z);
     void commandSent(const QString &command);
     void commandCompleted(const QString &command);
+    void commandAcknowledged(quint64 sequence, qint64 queueWaitUs, qint64 ackLatencyUs);
+    void commandFailed(quint64 sequence, const QString &error); // error:N yanıtı
+    // Her komut için tam bir kez: ok, error, zaman aşımı, yazılamadı veya iptal
+    void commandResolved(quint64 sequence, CommandStatus status, const QString &response);
+    void settingsLoaded();
+    void plannerStarvation(quint64 count);
+    void starvationRiskChanged(bool high);
     
     // Yeni sinyaller
     void limitSwitchTriggered(char axis, bool isMin);
@@ -124,34 +324,106 @@ signals:
 
 private slots:
     void handleReadyRead();
-    void handleError(QSerialPort::SerialPortError error);
+    void handleTransportClosed();
+    void handleTransportError(const QString &error);
     void handleTimeout();
     void handleSafetyTimeout();
+    void handleStatusPoll();
+    void logLatencySummary();
 
 private:
-    QSerialPort *serialPort;
+    GrblTransport *transport;  // Aktif bağlantı: seri, TCP, WebSocket veya cihaz
+    bool linkEstablished;
     QTimer *timeoutTimer;
     QTimer *safetyTimer;
     QTimer *statusTimer;
-    QQueue<QString> commandQueue;
+    QTimer *latencySummaryTimer;
+    QTimer *trafficFlushTimer;
+    QQueue<QueuedCommand> laneQueues[COMMAND_LANE_COUNT];   // Gönderilmeyi bekleyenler
+    LaneStatistics laneStatistics[COMMAND_LANE_COUNT];
+    LatencyHistogram laneQueueWait[COMMAND_LANE_COUNT];     // Kuyruğa giriş -> yazım (us)
+    bool laneHeld[COMMAND_LANE_COUNT];
+    QQueue<QueuedCommand> sentCommands;   // Yazıldı, ok/error bekleniyor
+    QHash<quint64, QSharedPointer<QPromise<CommandResult>>> pendingResults; // Sıra numarasıyla
+    QStringList pendingResponseLines;     // En eski gönderilmiş komutun ok öncesi satırları
     bool isProcessingCommand;
+    quint64 nextSequence;
+    StreamingMode streamingMode;
+    SerialBackend serialBackend;
+    int rxBufferSize;
+    int plannerBlockCount;
+    int inFlightBytes;
+    
+    // Planlayıcı durumu
+    bool plannerAwareFlowControl;
+    bool starvationRisk;
+    quint64 plannerStarvationCount;
+    int starvationStatusInterval;
+    
+    // Gecikme histogramları
+    LatencyHistogram queueWaitHistogram;
+    LatencyHistogram ackLatencyHistogram;
+    LatencyHistogram bytesInFlightHistogram;
+    LatencyHistogram batchSizeHistogram;  // Tek write() çağrısındaki satır sayısı
+    quint64 lastSummarizedCount;
+    
+    // G-code sıkıştırma (modal durum gönderilen satırlardan izlenir)
+    GCodeCompactor gcodeCompactor;
+    bool gcodeCompactionEnabled;
+    
+    TrafficRecorder trafficRecorder;
+    TelemetryRecorder telemetryRecorder;
+    ControllerSettings controllerSettings;
+    bool statusMaskNegotiation;
+    bool statusMaskNegotiated;
     
     // Yeni üye değişkenler
     LimitSwitchStatus limitSwitchStatus;
     SpindleStatus spindleStatus;
     bool limitSwitchMonitoringEnabled;
-    bool homingInProgress;
+    QFuture<CommandResult> homingResult;
     bool homingEnabled;
     bool safetyChecksEnabled;
     int safetyTimeout;
     
-    void processReceivedData();
+    // Ack zaman aşımı (hareket tahmini + status nabzı)
+    MotionEstimator motionEstimator;
+    QQueue<double> plannedMotion;   // Planlayıcıdaki satırların tahmini süreleri (s), eskisi başta
+    int ackTimeout;
+    qint64 lastHeartbeatMs;         // Son status raporu; -1 = henüz yok
+    quint64 ackTimeoutExtensions;
+    
+    // Status sorgulama durumu
+    GrblStatusReport lastStatusReport;
+    QString machineState;
+    QElapsedTimer monotonicClock;
+    qint64 statusRequestSentMs;
+    bool statusRequestPending;
+    int idleStatusInterval;
+    int activeStatusInterval;
+    int statusBackoffFactor;
+    
+    void processReceivedData(const QString &response);
     void sendNextCommand();
     void parseStatusResponse(const QString &response);
     void parsePositionResponse(const QString &response);
     void parseLimitSwitchResponse(const QString &response);
     void parseSpindleResponse(const QString &response);
-    void parseHomingResponse(const QString &response);
+    void parseBuildOptions(const QString &response);
+    void handleSettingsAck(const QString &command, const QString &response);
+    void negotiateStatusReportMask();
+    void resolveCommand(const QueuedCommand &command, CommandStatus status,
+                        const QString &response, qint64 ackLatencyUs);
+    void cancelPendingResults(const QQueue<QueuedCommand> &commands, const QString &reason);
+    void discardInFlightCommands(const QString &reason);
+    void handleHomingResult(const CommandResult &result);
+    quint64 enqueueCommand(const QString &command, CommandLane lane,
+                           const QSharedPointer<QPromise<CommandResult>> &promise);
+    int selectNextLane() const;     // -1: gönderilebilecek satır yok
+    bool isLaneEligible(CommandLane lane) const;
+    void updateLaneHolds();
+    void encodeCommand(QueuedCommand &command);
+    static int parseResponseCode(const QString &response);
     
     QString formatGCodeCommand(const QString &gcode);
     QString formatJogCommand(char axis, double distance, double speed);
@@ -160,10 +432,28 @@ private:
     QString formatHomingCommand(char axis = ' ');
     
     // Yeni yardımcı fonksiyonlar
+    void setTransport(GrblTransport *transport);
+    QSerialPort *activeSerialPort() const;
+    void handleConnectionEstablished();
     void startStatusMonitoring();
     void stopStatusMonitoring();
     void checkSafetyConditions();
     bool validateSafetyCommand(const QString &command);
+    
+    // Realtime komutlar kuyruğa girmez, doğrudan yazılır
+    bool sendRealtimeCommand(char command);
+    qint64 writeToTransport(const QByteArray &data);
+    bool isAckResponse(const QString &response) const;
+    bool isActiveMachineState(const QString &state) const;
+    void updateStatusPollInterval();
+    void restartAckTimer();
+    bool isHeartbeatAlive() const;
+    void updatePlannedMotion(const GrblStatusReport &report, bool hasPosition);
+    void updateSafetyWatchdog(bool heartbeat);   // heartbeat: status raporu geldi
+    void recordTelemetry(const GrblStatusReport &report);
+    int bytesInFlight() const;
+    bool canSendNextCommand() const;
+    void updatePlannerFlowControl(const GrblStatusReport &previous, const GrblStatusReport &report);
 };
 
 #endif // SERIALCOMMUNICATION_H 
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef SIMULATIONCLOCK_H
+#define SIMULATIONCLOCK_H
+
+#include <QObject>
+#include <QTimer>
+#include <chrono>
+
+// Sabit adımlı simülasyon saati. Gerçek zaman modunda std::chrono::steady_clock'tan
+// geçen süre biriktirilir ve sabit adımlarla tüketilir: olay döngüsü geç uyansa da
+// kaçırılan adımlar bir sonraki uyanışta işlenir, simülasyon hızı timer
+// titremesinden bağımsız kalır. Simülasyon zamanı adım sayısı × adım süresidir,
+// yani aynı girdilerle her çalıştırmada aynı sonucu verir.
+//
+// Toplu modda duvar saati kullanılmaz; advance() istenen simülasyon süresini
+// beklemeden, olabildiğince hızlı işler (testler ve program analizi için).
+class SimulationClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        RealTime,
+        Batch
+    };
+    
+    explicit SimulationClock(QObject *parent = nullptr);
+    
+    // Ayarlar
+    void setMode(Mode mode);
+    Mode getMode() const;
+    void setStepInterval(double seconds);
+    double getStepInterval() const;
+    void setFrameInterval(int milliseconds);       // Gerçek zamanda uyanma/yayın aralığı
+    void setMaxCatchUpSteps(int steps);            // Tek uyanışta en fazla adım
+    
+    void start();
+    void stop();
+    bool isRunning() const;
+    
+    // Adımları hemen işler (her iki modda da); işlenen simülasyon süresi, s
+    double advance(double seconds);
+    
+    // İstatistikler
+    double getSimulationTime() const;              // s
+    quint64 getStepCount() const;
+    quint64 getDroppedSteps() const;               // Telafi sınırını aşıp atılan adımlar
+
+signals:
+    void stepped(double dt);                       // Her sabit adımda
+    void frameAdvanced(double simulationTime);     // Bir grup adımdan sonra (görüntü güncellemesi)
+
+private slots:
+    void onWake();
+
+private:
+    QTimer *wakeTimer;
+    Mode mode;
+    bool running;
+    std::chrono::nanoseconds stepDuration;
+    std::chrono::nanoseconds accumulator;
+    std::chrono::steady_clock::time_point lastWake;
+    quint64 stepCount;
+    quint64 droppedSteps;
+    int maxCatchUpSteps;
+    
+    void runSteps(quint64 count);
+};
+
+#endif // SIMULATIONCLOCK_H
@@ -0,0 +1,100 @@
+#ifndef STEPGENERATOR_H
+#define STEPGENERATOR_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Kontrolcüye gidecek doğrusal hareket (yaylar önceden doğrulara bölünmüş olmalı)
+struct StepBlock {
+    double target[3];       // mm
+    double feedRate;        // mm/min; rapid'de yok sayılır
+    bool rapid;
+    int lineNumber;
+};
+
+// Adım hazırlayıcının bir segmenti (GRBL stepper.c: ~10 ms'lik dilim)
+struct StepSegment {
+    int lineNumber;
+    double startTime;       // s, program başından
+    double duration;        // s
+    int steps[3];           // Bu segmentte eksen başına adım
+    double stepRate[3];     // Eksen başına adım frekansı, Hz
+    double dominantRate;    // Bresenham ana ekseni, Hz
+    int amassLevel;         // 0-3
+    double isrRate;         // Adım kesmesi frekansı: dominantRate · 2^amassLevel, Hz
+};
+
+// Bir program satırının özeti (yay satırları birden çok bloğa bölünür)
+struct StepLineReport {
+    int lineNumber;
+    double startTime;       // s
+    double duration;        // s
+    qint64 steps[3];
+    double peakStepRate[3]; // Hz
+    double peakIsrRate;     // Hz
+};
+
+// Sınırı aşan ardışık segmentler tek aralıkta birleştirilir
+struct StepRateViolation {
+    int lineNumber;
+    double startTime;       // s
+    double endTime;         // s
+    double peakIsrRate;     // Hz
+    int axis;               // En çok adım atan eksen (0 = X)
+};
+
+struct StepRateReport {
+    double stepRateCeiling;             // Hz
+    double totalTime;                   // s
+    qint64 segmentCount;
+    qint64 totalSteps[3];
+    double peakStepRate[3];             // Hz
+    double peakIsrRate;                 // Hz
+    int peakLineNumber;
+    QVector<StepLineReport> lines;
+    QVector<StepRateViolation> violations;
+    QVector<StepSegment> segments;      // Yalnızca setRecordSegments(true) ise
+};
+
+// GRBL'in planlayıcı + adım üreteci zincirinin öykünmesi. Bloklar junction deviation
+// ile birleşim hızları hesaplanıp ileri/geri geçişle yamuk hız profillerine dönüştürülür,
+// sonra sabit süreli segmentlere bölünür. Her segmentte adım sayıları Bresenham
+// sayaçlarının kapalı formuyla, kesme frekansı AMASS seviyesiyle hesaplanır; tek tek
+// adım olayı üretilmediği için saatlerce sürecek programlar da saniyeler içinde biter.
+//
+// Look-ahead tüm programı kapsar (kontrolcü 16 blokla sınırlıdır): bulunan tepe
+// frekansları gerçekte ulaşılabilecek değerlerin üst sınırıdır.
+class StepGenerator
+{
+public:
+    StepGenerator();
+    
+    // Eksen ayarları (GRBL $100-$102, $110-$112, $120-$122)
+    void setAxis(int axis, double stepsPerMm, double maxRate, double acceleration);
+    double getStepsPerMm(int axis) const;
+    
+    void setJunctionDeviation(double mm);       // $11
+    void setSegmentTime(double seconds);
+    void setStepRateCeiling(double hz);
+    double getStepRateCeiling() const;
+    void setRecordSegments(bool enabled);
+    
+    StepRateReport analyze(const double startPosition[3], const QVector<StepBlock> &blocks) const;
+    
+    static const int AXIS_COUNT = 3;
+    // grbl_ESP32 adım kesmesinin pratik üst sınırı; kartta ölçülen değerle değiştirilmeli
+    static const int DEFAULT_STEP_RATE_CEILING = 120000;   // Hz
+
+private:
+    double stepsPerMm[AXIS_COUNT];
+    double maxRate[AXIS_COUNT];         // mm/min
+    double acceleration[AXIS_COUNT];    // mm/s²
+    double junctionDeviation;           // mm
+    double segmentTime;                 // s
+    double stepRateCeiling;             // Hz
+    bool recordSegments;
+    
+    static int amassLevel(double dominantRate);
+};
+
+#endif // STEPGENERATOR_H
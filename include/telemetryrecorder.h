@@ -0,0 +1,105 @@
+#ifndef TELEMETRYRECORDER_H
+#define TELEMETRYRECORDER_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <atomic>
+
+// Makine durumu kodları (status raporundaki ilk alan)
+enum class TelemetryState : quint8 {
+    Unknown = 0,
+    Idle,
+    Run,
+    Hold,
+    Jog,
+    Home,
+    Alarm,
+    Door,
+    Check,
+    Sleep
+};
+
+// Tek status raporu, 28 bayt: 50 Hz'de 8 saatlik vardiya ~40 MB
+struct TelemetrySample {
+    quint32 timeMs;                 // Kayıt başlangıcına göre
+    float mpos[3];                  // Makine koordinatı, mm
+    float feedRate;                 // mm/min
+    float spindleSpeed;             // RPM
+    qint16 rxBytesAvailable;        // -1 = raporda yok
+    qint8 plannerBlocksAvailable;   // -1 = raporda yok
+    quint8 state;                   // TelemetryState
+};
+
+// Çizim için bir zaman dilimindeki örneklerin özeti (min/max korunur, tepe kaybolmaz)
+struct TelemetryBucket {
+    quint32 startMs;
+    quint32 endMs;
+    int sampleCount;                // 0 = bu dilimde örnek yok, diğer alanlar geçersiz
+    float minPos[3];
+    float maxPos[3];
+    float minFeed;
+    float maxFeed;
+    float minSpindle;
+    float maxSpindle;
+    int minPlannerBlocks;           // En kötü durum: planlayıcıdaki en az boş blok
+    int minRxBytes;
+    quint8 lastState;
+};
+
+// Sabit kapasiteli, kilitsiz telemetri halka tamponu. Tek yazar (status raporlarını
+// ayrıştıran iş parçacığı) record() çağırır; diğer iş parçacıkları aynı anda okuyabilir.
+//
+// Yazar örneği yuvaya yazar, sonra yazma sayacını release ile yayınlar. Okuyucu
+// sayacı acquire ile okur, yuvaları kopyalar ve sayacı yeniden okur: kopyalama
+// sırasında üzerine yazılmış olabilecek en eski yuvalar atılır (seqlock mantığı).
+// Bellek 16K örneklik bloklar halinde, doldukça ayrılır; kısa oturumlar tüm kapasiteyi
+// ayırmaz.
+class TelemetryRecorder
+{
+public:
+    explicit TelemetryRecorder(int capacity = DEFAULT_CAPACITY);
+    ~TelemetryRecorder();
+    
+    TelemetryRecorder(const TelemetryRecorder &) = delete;
+    TelemetryRecorder &operator=(const TelemetryRecorder &) = delete;
+    
+    // Yalnızca yazar iş parçacığından
+    void record(qint64 monotonicMs, const TelemetrySample &sample);   // sample.timeMs doldurulur
+    void clear();
+    
+    // Her iş parçacığından
+    int capacity() const;
+    int size() const;
+    quint64 totalRecorded() const;
+    qint64 memoryBytes() const;
+    qint64 startEpochMs() const;            // İlk örneğin duvar saati zamanı; 0 = örnek yok
+    quint32 latestTimeMs() const;
+    QVector<TelemetrySample> samples(quint32 fromMs = 0, quint32 toMs = 0xFFFFFFFFu) const;
+    QVector<TelemetryBucket> decimate(quint32 fromMs, quint32 toMs, int bucketCount) const;
+    
+    // Dışa aktarım (örnekler o anki halleriyle kopyalanır)
+    bool exportCsv(const QString &filePath, QString *error = nullptr) const;
+    // "CNCTLM01" | sürüm u32 | başlangıç (epoch ms) i64 | örnek sayısı u64 | örnekler (LE, 28 bayt)
+    bool exportBinary(const QString &filePath, QString *error = nullptr) const;
+    
+    static TelemetryState stateFromString(const QString &state);
+    static const char *stateName(quint8 state);
+    
+    static const int DEFAULT_CAPACITY = 8 * 3600 * 50;     // 8 saat, 50 Hz
+    static const int BLOCK_SIZE = 16384;
+
+private:
+    int blockCount;
+    TelemetrySample **blocks;       // Dizi sabit; bloklar yazar tarafından ayrılır
+    std::atomic<quint64> writeIndex;
+    std::atomic<qint64> originMs;   // İlk örneğin monotonik zamanı; -1 = yok
+    std::atomic<qint64> originEpochMs;
+    std::atomic<int> allocatedBlocks;
+    
+    const TelemetrySample &slot(quint64 index) const;
+    quint64 firstValidIndex(quint64 written) const;
+    quint64 lowerBound(quint64 first, quint64 last, quint32 timeMs) const;
+};
+
+#endif // TELEMETRYRECORDER_H
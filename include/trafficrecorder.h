@@ -0,0 +1,77 @@
+#ifndef TRAFFICRECORDER_H
+#define TRAFFICRECORDER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+
+// Kontrolcü trafiği yakalama dosyası (.cnccap)
+//
+// Başlık: "CNCCAP01" (8 bayt) | sürüm u32 | yakalama başlangıcı (epoch ms) i64
+// Kayıt:  tür u8 | önceki kayda göre fark (ns, LEB128) | uzunluk (LEB128) | veri
+//
+// Zaman damgaları monotonik saatten alınır; fark kodlaması sayesinde tipik
+// bir kayıt 4-5 bayt ek yük taşır. Tüm sayılar little-endian'dır.
+enum class TrafficDirection : quint8 {
+    Tx = 1,      // Host -> kontrolcü
+    Rx = 2,      // Kontrolcü -> host
+    Marker = 3   // Serbest not (bağlantı, reset, iş başlangıcı...)
+};
+
+struct TrafficRecord {
+    TrafficDirection direction;
+    qint64 timestampNs;   // Yakalama başlangıcına göre
+    QByteArray data;
+};
+
+class TrafficRecorder
+{
+public:
+    TrafficRecorder();
+    ~TrafficRecorder();
+    
+    bool open(const QString &filePath, qint64 startNs);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+    
+    void record(TrafficDirection direction, qint64 timestampNs, const QByteArray &data);
+    void flush();   // Bekleyen kayıtları diske yaz (periyodik çağrılır)
+    qint64 getRecordCount() const;
+    qint64 getBytesWritten() const;
+
+private:
+    QFile file;
+    QByteArray pending;   // Küçük kayıtlar birleştirilerek yazılır
+    qint64 baseNs;
+    qint64 lastNs;
+    qint64 lastFlushNs;   // Son disk yazımının kayıt zamanı
+    qint64 recordCount;
+    qint64 bytesWritten;
+    
+    void flushPending();
+};
+
+class TrafficCaptureReader
+{
+public:
+    TrafficCaptureReader();
+    
+    bool open(const QString &filePath);
+    void close();
+    QString errorString() const;
+    qint64 getCaptureStartEpochMs() const;
+    
+    bool readNext(TrafficRecord &record);
+
+private:
+    QFile file;
+    QString lastError;
+    qint64 startEpochMs;
+    qint64 lastNs;
+    
+    bool readVarint(quint64 &value);
+};
+
+#endif // TRAFFICRECORDER_H
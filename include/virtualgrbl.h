@@ -0,0 +1,229 @@
+#ifndef VIRTUALGRBL_H
+#define VIRTUALGRBL_H
+
+#include <QObject>
+#include <QIODevice>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QMap>
+#include <QByteArray>
+#include <QString>
+
+class QSocketNotifier;
+class QTcpServer;
+class QTcpSocket;
+
+// Sanal kontrolcünün topladığı ölçümler
+struct VirtualGrblStatistics {
+    quint64 linesProcessed;
+    quint64 bytesReceived;
+    quint64 bytesSent;
+    quint64 rxOverflowBytes;     // RX tamponu doluyken gelen ve kaybolan baytlar
+    quint64 plannerEmptyEvents;  // Run sırasında planlayıcının boşaldığı anlar
+    quint64 blocksExecuted;
+    double motionTime;           // Planlanan blokların toplam süresi (s)
+    double idealMotionTime;      // Planlayıcı hiç boşalmasaydı geçecek süre (s)
+    double busyTime;             // Step üretecinin hareket ettiği süre (s)
+};
+
+// Donanımsız test için GRBL 1.1 kontrolcü modeli. RX tamponu, planlayıcı
+// blok tamponu, ok/error yanıtları, status raporları, realtime komutlar ve
+// baud hızına göre bayt zamanlaması modellenir. G-code hareketleri yalnızca
+// süre olarak simüle edilir (sabit hız + duruştan kalkışta ivme rampası).
+class VirtualGrblController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VirtualGrblController(QObject *parent = nullptr);
+    
+    // Model ayarları
+    void setBaudRate(int baudRate);
+    int getBaudRate() const;
+    void setLinkLatency(int microseconds);
+    int getLinkLatency() const;
+    void setRxBufferSize(int bytes);
+    int getRxBufferSize() const;
+    void setPlannerBlockCount(int blocks);      // BLOCK_BUFFER_SIZE; kullanılabilir blok bir eksiği
+    int getPlannerBlockCount() const;
+    void setSetting(int number, double value);
+    double getSetting(int number) const;
+    
+    // Çalıştırma
+    void start();
+    void stop();
+    bool isRunning() const;
+    void receiveBytes(const QByteArray &data);
+    
+    // Durum
+    QString getState() const;
+    int plannerBlocksAvailable() const;
+    int rxBytesAvailable() const;
+    VirtualGrblStatistics getStatistics() const;
+    void resetStatistics();
+
+signals:
+    void bytesOutput(const QByteArray &data);
+    void plannerEmptied();
+    void stateChanged(const QString &state);
+
+private slots:
+    void tick();
+
+private:
+    // Hat üzerindeki bayt öbeği; her bayt baud süresi kadar sonra teslim edilir
+    struct WireChunk {
+        qint64 startUs;
+        QByteArray data;
+        int delivered;
+    };
+    
+    struct PlannerBlock {
+        double start[3];
+        double target[3];
+        double feedRate;   // mm/min
+        double duration;   // s
+        bool isJog;
+    };
+    
+    QTimer *tickTimer;
+    QElapsedTimer clock;
+    qint64 lastTickUs;
+    bool running;
+    
+    int baudRate;
+    int linkLatencyUs;
+    int rxBufferSize;
+    int plannerBlockCount;
+    QMap<int, double> settings;
+    
+    QQueue<WireChunk> inboundWire;
+    QQueue<WireChunk> outboundWire;
+    qint64 inboundWireFreeUs;
+    qint64 outboundWireFreeUs;
+    bool inboundResetPending;   // Teslim sırasında soft reset geldi
+    QByteArray rxBuffer;
+    
+    QQueue<PlannerBlock> planner;
+    double blockElapsed;
+    double holdDecelRemaining;  // s; sıfırdan büyükse feed hold yavaşlaması sürüyor
+    double machinePosition[3];
+    double plannerPosition[3];
+    
+    // G-code modal durumu
+    int motionMode;        // 0, 1, 2, 3
+    bool absoluteMode;
+    bool inchMode;
+    double modalFeedRate;
+    double spindleSpeed;
+    
+    QString state;
+    bool checkMode;
+    bool resetAfterResponse;
+    VirtualGrblStatistics stats;
+    
+    qint64 nowUs() const;
+    double byteTimeUs() const;
+    void enqueueWire(QQueue<WireChunk> &wire, qint64 &wireFreeUs, const QByteArray &data);
+    void deliverInbound(qint64 now);
+    void deliverOutbound(qint64 now);
+    void handleRealtimeByte(char byte);
+    void processLines();
+    void advanceMotion(double seconds);
+    void setState(const QString &newState);
+    void sendResponse(const QByteArray &text);
+    void softReset();
+    
+    // Satır yürütme; GRBL hata kodu döner (0 = ok)
+    int executeLine(const QByteArray &line);
+    int executeSystemCommand(const QByteArray &line);
+    int executeGCode(const QByteArray &line, bool isJog);
+    bool isMotionLine(const QByteArray &line) const;
+    double blockDuration(const double start[3], const double target[3], double feedRate,
+                         double arcLength, bool fromRest) const;
+    QByteArray buildStatusReport() const;
+    void currentPosition(double position[3]) const;
+};
+
+// Kontrolcü modelini SerialCommunication'a bağlamak için süreç içi QIODevice
+class VirtualGrblDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit VirtualGrblDevice(VirtualGrblController *controller, QObject *parent = nullptr);
+    
+    VirtualGrblController *controller() const;
+    
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+    bool canReadLine() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 size) override;
+
+private:
+    VirtualGrblController *grbl;
+    QByteArray readBuffer;
+};
+
+// Kontrolcü modelini yerel bir TCP sunucusu olarak sunar (grbl_ESP32
+// Telnet'inin yerine geçer). Aynı anda tek istemci kabul edilir.
+class VirtualGrblTcpServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VirtualGrblTcpServer(VirtualGrblController *controller, QObject *parent = nullptr);
+    ~VirtualGrblTcpServer();
+    
+    bool listen(quint16 port = 0); // 0 = boş bir port seçilir
+    void close();
+    bool isListening() const;
+    quint16 serverPort() const;
+
+private slots:
+    void handleNewConnection();
+    void handleClientReadyRead();
+    void handleClientDisconnected();
+    void writeToClient(const QByteArray &data);
+
+private:
+    VirtualGrblController *grbl;
+    QTcpServer *server;
+    QTcpSocket *client;
+};
+
+#ifdef Q_OS_UNIX
+// Kontrolcü modelini bir pseudo-terminal üzerinden sunar; slave ucu
+// (/dev/pts/N) QSerialPort veya başka bir seri istemci ile açılabilir.
+class VirtualGrblPty : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VirtualGrblPty(VirtualGrblController *controller, QObject *parent = nullptr);
+    ~VirtualGrblPty();
+    
+    bool open();
+    void close();
+    bool isOpen() const;
+    QString slaveName() const;
+
+private slots:
+    void handleMasterReadable();
+    void writeToMaster(const QByteArray &data);
+
+private:
+    VirtualGrblController *grbl;
+    QSocketNotifier *notifier;
+    int masterFd;
+    QString slavePath;
+};
+#endif
+
+#endif // VIRTUALGRBL_H
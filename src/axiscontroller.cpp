@@ -1,30 +1,56 @@
 #include "axiscontroller.h"
 #include <QDebug>
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // Bu kadar kısa evreler sayısal gürültüdür, profile eklenmez
+    const double MIN_PHASE_DURATION = 1e-9;
+    // Bu kadar kısa yol bileşenleri hareket sayılmaz, mm
+    const double MIN_MOVE_LENGTH = 1e-9;
+    const double DEFAULT_AXIS_ACCELERATION = 200.0;  // mm/s²
+    
+    // Sürekli jog rampası: her saniye hız çarpanı 2 artar, en fazla 3x
+    const double JOG_RAMP_RATE = 2.0;
+    const double JOG_RAMP_MAX = 3.0;
+    
+    // runUntilIdle() bu aralıklarla ilerler ve konumları yayınlar, s
+    const double BATCH_FRAME_SECONDS = 0.02;
+    
+    // Varsayılan sürücü: 1.8° motor, 1/16 mikro-adım, 8 mm vida -> 400 adım/mm
+    const int DEFAULT_STEPS_PER_REVOLUTION = 200;
+    const double DEFAULT_MM_PER_STEP = 8.0 / DEFAULT_STEPS_PER_REVOLUTION;
+    
+    // Yaylar GRBL gibi bu sapmayla doğrulara bölünür ($12), mm
+    const double ARC_TOLERANCE = 0.002;
+    const char STEP_AXES[3] = {'X', 'Y', 'Z'};
+}
 
 AxisController::AxisController(QObject *parent)
     : QObject(parent)
-    , jogTimer(new QTimer(this))
-    , continuousTimer(new QTimer(this))
+    , simulationClock(new SimulationClock(this))
+    , coordinatedMoveActive(false)
+    , coordinatedElapsed(0.0)
     , currentJogAxis(' ')
     , currentJogPositive(false)
+    , continuousJogActive(false)
     , jogStep(1.0)
     , jogSpeed(1000.0)
     , acceleration(1.0)
     , maxSpeed(5000.0)
+    , jerk(5000.0)
     , emergencyStopActive(false)
+    , accelerationProfile(AccelerationProfile::Trapezoidal)
 {
-    // Timer ayarları
-    jogTimer->setInterval(50); // 50ms = 20Hz
-    continuousTimer->setInterval(50);
-    
     // Eksenleri başlat
     initializeAxis('X');
     initializeAxis('Y');
     initializeAxis('Z');
     
-    // Timer bağlantıları
-    connect(jogTimer, &QTimer::timeout, this, &AxisController::updateJogMovement);
-    connect(continuousTimer, &QTimer::timeout, this, &AxisController::updateContinuousMovement);
+    // Hareket sabit adımlarla entegre edilir, konumlar her karede bir kez yayınlanır
+    connect(simulationClock, &SimulationClock::stepped, this, &AxisController::advanceSimulation);
+    connect(simulationClock, &SimulationClock::frameAdvanced, this, &AxisController::publishFrame);
 }
 
 AxisController::~AxisController()
@@ -99,27 +125,30 @@ void AxisController::startContinuousJog(char axis, bool positive)
         return;
     }
     
+    if (continuousJogActive && currentJogAxis != axis) {
+        publishAxis(currentJogAxis);
+    }
+    
     currentJogAxis = axis;
     currentJogPositive = positive;
+    continuousJogActive = true;
     acceleration = 1.0;
-    
-    if (!continuousTimer->isActive()) {
-        continuousTimer->start();
-    }
+    startSimulation();
 }
 
 void AxisController::stopContinuousJog()
 {
-    if (continuousTimer->isActive()) {
-        continuousTimer->stop();
+    if (continuousJogActive) {
+        publishAxis(currentJogAxis);
     }
+    continuousJogActive = false;
     currentJogAxis = ' ';
     acceleration = 1.0;
 }
 
 bool AxisController::isJogging() const
 {
-    return continuousTimer->isActive();
+    return continuousJogActive;
 }
 
 void AxisController::setAxisLimits(char axis, double minLimit, double maxLimit)
@@ -164,31 +193,188 @@ void AxisController::moveToPosition(char axis, double target, double speed)
         return;
     }
     
-    if (validateMovement(axis, target)) {
-        axisPositions[axis].target = target;
-        axisPositions[axis].isMoving = true;
-        emit movementStarted(axis, target);
-        
-        // Basit implementasyon: hemen hedefe git
-        updateAxisPosition(axis, target);
-        axisPositions[axis].isMoving = false;
-        emit targetReached(axis, target);
-        emit movementStopped(axis);
+    // Tek eksen, tek bileşenli koordineli hareket olarak planlanır
+    QMap<char, double> targets;
+    targets[axis] = target;
+    moveToPositions(targets, speed);
+}
+
+CoordinatedMove AxisController::planCoordinatedMove(const QMap<char, double> &targets, double feedRate)
+{
+    CoordinatedMove move;
+    move.length = 0.0;
+    for (auto it = targets.constBegin(); it != targets.constEnd(); ++it) {
+        if (!axisPositions.contains(it.key())) {
+            continue;
+        }
+        double start = axisPositions[it.key()].current;
+        move.startPositions[it.key()] = start;
+        move.targetPositions[it.key()] = it.value();
+        move.length += (it.value() - start) * (it.value() - start);
+    }
+    move.length = qSqrt(move.length);
+    
+    // Yol hızı/ivmesi: her eksenin limiti kendi bileşenine izdüşürülür (GRBL planlayıcısı gibi)
+    double pathRate = feedRate > 0.0 ? feedRate : std::numeric_limits<double>::max();
+    double pathAcceleration = std::numeric_limits<double>::max();
+    double largestComponent = 0.0;
+    if (move.length > MIN_MOVE_LENGTH) {
+        for (auto it = move.targetPositions.constBegin(); it != move.targetPositions.constEnd(); ++it) {
+            double component = (it.value() - move.startPositions[it.key()]) / move.length;
+            if (component == 0.0) {
+                continue;
+            }
+            move.direction[it.key()] = component;
+            const AxisPosition &axis = axisPositions[it.key()];
+            pathRate = qMin(pathRate, axis.maxRate / qAbs(component));
+            pathAcceleration = qMin(pathAcceleration, axis.maxAcceleration / qAbs(component));
+            largestComponent = qMax(largestComponent, qAbs(component));
+        }
+    }
+    if (move.direction.isEmpty()) {
+        move.length = 0.0;
+        move.profile = emptyProfile(0.0, 0.0, 0.0, 0.0);
+        return move;
+    }
+    
+    // jerk tek değer: en büyük bileşenli eksen sınırı aşmasın
+    if (accelerationProfile == AccelerationProfile::SCurve) {
+        move.profile = createSCurveProfile(' ', 0.0, move.length, pathRate, pathAcceleration, jerk / largestComponent);
+    } else {
+        move.profile = createMotionProfile(' ', 0.0, move.length, pathRate, pathAcceleration);
+    }
+    return move;
+}
+
+void AxisController::executeCoordinatedMove(const CoordinatedMove &move)
+{
+    if (emergencyStopActive) {
+        return;
+    }
+    
+    for (auto it = move.targetPositions.constBegin(); it != move.targetPositions.constEnd(); ++it) {
+        if (!validateMovement(it.key(), it.value())) {
+            return;
+        }
+    }
+    
+    // Kontrolcüde olduğu gibi aynı anda tek hareket: eksenlerin bağımsız profilleri de bırakılır
+    abortCoordinatedMove();
+    for (auto it = move.targetPositions.constBegin(); it != move.targetPositions.constEnd(); ++it) {
+        activeProfiles.remove(it.key());
+        profileElapsed.remove(it.key());
+        axisPositions[it.key()].target = it.value();
+    }
+    
+    if (move.direction.isEmpty()) {
+        for (auto it = move.targetPositions.constBegin(); it != move.targetPositions.constEnd(); ++it) {
+            emit targetReached(it.key(), it.value());
+        }
+        emit coordinatedMoveCompleted(move);
+        return;
+    }
+    
+    activeMove = move;
+    coordinatedMoveActive = true;
+    coordinatedElapsed = 0.0;
+    for (auto it = move.direction.constBegin(); it != move.direction.constEnd(); ++it) {
+        axisPositions[it.key()].isMoving = true;
+        emit movementStarted(it.key(), move.targetPositions[it.key()]);
+    }
+    
+    startSimulation();
+}
+
+void AxisController::moveToPositions(const QMap<char, double> &targets, double feedRate)
+{
+    if (emergencyStopActive) {
+        return;
+    }
+    
+    executeCoordinatedMove(planCoordinatedMove(targets, feedRate));
+}
+
+bool AxisController::isCoordinatedMoveActive() const
+{
+    return coordinatedMoveActive;
+}
+
+void AxisController::setAxisMaxRate(char axis, double rate)
+{
+    if (axisPositions.contains(axis) && rate > 0.0) {
+        axisPositions[axis].maxRate = rate;
+    }
+}
+
+double AxisController::getAxisMaxRate(char axis) const
+{
+    return axisPositions.value(axis).maxRate;
+}
+
+void AxisController::setAxisAcceleration(char axis, double accel)
+{
+    if (axisPositions.contains(axis) && accel > 0.0) {
+        axisPositions[axis].maxAcceleration = accel;
+    }
+}
+
+double AxisController::getAxisAcceleration(char axis) const
+{
+    return axisPositions.value(axis).maxAcceleration;
+}
+
+void AxisController::moveToPositionWithProfile(char axis, double target, const MotionProfile &profile)
+{
+    if (!axisPositions.contains(axis)) {
+        return;
     }
+    
+    // Profilin limitleri ve tipi korunur, uç noktalar mevcut konumdan hedefe yeniden hesaplanır
+    double start = axisPositions[axis].current;
+    MotionProfile planned;
+    switch (profile.profile) {
+        case AccelerationProfile::SCurve:
+            planned = createSCurveProfile(axis, start, target, profile.maxSpeed, profile.acceleration, profile.jerk);
+            break;
+        case AccelerationProfile::Trapezoidal:
+            planned = createTrapezoidalProfile(axis, start, target, profile.maxSpeed, profile.acceleration);
+            break;
+        case AccelerationProfile::Linear:
+            planned = createLinearProfile(start, target, profile.maxSpeed, profile.acceleration);
+            break;
+    }
+    executeMotionProfile(axis, planned);
 }
 
 void AxisController::stopMovement(char axis)
 {
-    if (axisPositions.contains(axis)) {
+    // Koordineli hareketin tek ekseni durdurulamaz; hareketin tamamı bırakılır
+    if (coordinatedMoveActive && activeMove.direction.contains(axis)) {
+        abortCoordinatedMove();
+    } else if (axisPositions.contains(axis)) {
+        activeProfiles.remove(axis);
+        profileElapsed.remove(axis);
         axisPositions[axis].isMoving = false;
+        axisPositions[axis].currentVelocity = 0.0;
+        axisPositions[axis].currentAcceleration = 0.0;
+        publishAxis(axis);
         emit movementStopped(axis);
     }
 }
 
 void AxisController::stopAllMovement()
 {
+    activeProfiles.clear();
+    profileElapsed.clear();
+    coordinatedMoveActive = false;
+    
     for (auto it = axisPositions.begin(); it != axisPositions.end(); ++it) {
         it->isMoving = false;
+        it->currentVelocity = 0.0;
+        it->currentAcceleration = 0.0;
+    }
+    publishFrame();
+    for (auto it = axisPositions.begin(); it != axisPositions.end(); ++it) {
         emit movementStopped(it.key());
     }
 }
@@ -198,6 +384,177 @@ bool AxisController::isMoving(char axis) const
     return axisPositions.value(axis).isMoving;
 }
 
+MotionProfile AxisController::createMotionProfile(char axis, double startPos, double endPos, double maxSpeed, double acceleration)
+{
+    // Seçili ivme profiline göre
+    switch (accelerationProfile) {
+        case AccelerationProfile::SCurve:
+            return createSCurveProfile(axis, startPos, endPos, maxSpeed, acceleration, jerk);
+        case AccelerationProfile::Linear:
+            return createLinearProfile(startPos, endPos, maxSpeed, acceleration);
+        case AccelerationProfile::Trapezoidal:
+            break;
+    }
+    return createTrapezoidalProfile(axis, startPos, endPos, maxSpeed, acceleration);
+}
+
+MotionProfile AxisController::createLinearProfile(double startPos, double endPos, double maxSpeed, double acceleration) const
+{
+    // İvme sınırsız: tek sabit hız evresi
+    MotionProfile profile = emptyProfile(startPos, endPos, maxSpeed, acceleration);
+    profile.profile = AccelerationProfile::Linear;
+    if (profile.peakVelocity > 0.0) {
+        appendPhase(profile, qAbs(endPos - startPos) / profile.peakVelocity, 0.0, 0.0);
+    }
+    return profile;
+}
+
+MotionProfile AxisController::createTrapezoidalProfile(char axis, double startPos, double endPos, double maxSpeed, double acceleration)
+{
+    Q_UNUSED(axis);
+    
+    MotionProfile profile = emptyProfile(startPos, endPos, maxSpeed, acceleration);
+    profile.profile = AccelerationProfile::Trapezoidal;
+    double distance = qAbs(endPos - startPos);
+    if (distance <= 0.0 || profile.peakVelocity <= 0.0 || acceleration <= 0.0) {
+        return profile;
+    }
+    
+    // Tepe hıza ulaşılamıyorsa üçgen profil: d = v²/a
+    double velocity = profile.peakVelocity;
+    if (velocity * velocity / acceleration > distance) {
+        velocity = qSqrt(distance * acceleration);
+    }
+    profile.peakVelocity = velocity;
+    
+    double rampTime = velocity / acceleration;
+    double cruiseTime = (distance - velocity * rampTime) / velocity;
+    appendPhase(profile, rampTime, 0.0, acceleration);
+    appendPhase(profile, cruiseTime, 0.0, 0.0);
+    appendPhase(profile, rampTime, 0.0, -acceleration);
+    return profile;
+}
+
+MotionProfile AxisController::createSCurveProfile(char axis, double startPos, double endPos, double maxSpeed, double acceleration, double jerk)
+{
+    if (jerk <= 0.0) {
+        return createTrapezoidalProfile(axis, startPos, endPos, maxSpeed, acceleration);
+    }
+    
+    MotionProfile profile = emptyProfile(startPos, endPos, maxSpeed, acceleration);
+    profile.profile = AccelerationProfile::SCurve;
+    profile.jerk = jerk;
+    double distance = qAbs(endPos - startPos);
+    if (distance <= 0.0 || profile.peakVelocity <= 0.0 || acceleration <= 0.0) {
+        return profile;
+    }
+    
+    // 0'dan v'ye hızlanma süresi: v >= a²/j ise v/a + a/j (sabit ivme evresi var),
+    // değilse 2·sqrt(v/j). Simetrik hızlanma + yavaşlama yolu v·T(v).
+    const double fullAccelVelocity = acceleration * acceleration / jerk;
+    auto rampTime = [&](double v) {
+        return v >= fullAccelVelocity ? v / acceleration + acceleration / jerk : 2.0 * qSqrt(v / jerk);
+    };
+    
+    double velocity = profile.peakVelocity;
+    if (velocity * rampTime(velocity) > distance) {
+        // Kısa hareket: v·T(v) = d denkleminin kapalı çözümü
+        velocity = qPow(distance * distance * jerk / 4.0, 1.0 / 3.0);
+        if (velocity > fullAccelVelocity) {
+            double r = acceleration / jerk;
+            velocity = acceleration / 2.0 * (-r + qSqrt(r * r + 4.0 * distance / acceleration));
+        }
+    }
+    profile.peakVelocity = velocity;
+    
+    double peakAcceleration = velocity >= fullAccelVelocity ? acceleration : qSqrt(velocity * jerk);
+    double jerkTime = peakAcceleration / jerk;
+    double constantTime = qMax(0.0, velocity / peakAcceleration - jerkTime);
+    double cruiseTime = qMax(0.0, (distance - velocity * rampTime(velocity)) / velocity);
+    
+    appendPhase(profile, jerkTime, jerk, 0.0);
+    appendPhase(profile, constantTime, 0.0, peakAcceleration);
+    appendPhase(profile, jerkTime, -jerk, peakAcceleration);
+    appendPhase(profile, cruiseTime, 0.0, 0.0);
+    appendPhase(profile, jerkTime, -jerk, 0.0);
+    appendPhase(profile, constantTime, 0.0, -peakAcceleration);
+    appendPhase(profile, jerkTime, jerk, -peakAcceleration);
+    return profile;
+}
+
+void AxisController::executeMotionProfile(char axis, const MotionProfile &profile)
+{
+    if (emergencyStopActive) {
+        return;
+    }
+    
+    if (!axisPositions.contains(axis)) {
+        return;
+    }
+    
+    if (!validateMovement(axis, profile.endPosition)) {
+        return;
+    }
+    
+    if (coordinatedMoveActive && activeMove.direction.contains(axis)) {
+        abortCoordinatedMove();
+    }
+    
+    activeProfiles[axis] = profile;
+    profileElapsed[axis] = 0.0;
+    axisPositions[axis].target = profile.endPosition;
+    axisPositions[axis].isMoving = true;
+    emit movementStarted(axis, profile.endPosition);
+    
+    startSimulation();
+}
+
+QVector<MotionSample> AxisController::generateProfilePoints(const MotionProfile &profile, double interval) const
+{
+    QVector<MotionSample> points;
+    if (interval <= 0.0) {
+        return points;
+    }
+    
+    int count = static_cast<int>(qCeil(profile.totalTime / interval));
+    points.reserve(count + 1);
+    for (int i = 0; i < count; ++i) {
+        points.append(profile.sampleAt(i * interval));
+    }
+    points.append(profile.sampleAt(profile.totalTime));
+    return points;
+}
+
+void AxisController::setAccelerationProfile(AccelerationProfile profile)
+{
+    accelerationProfile = profile;
+}
+
+AccelerationProfile AxisController::getAccelerationProfile() const
+{
+    return accelerationProfile;
+}
+
+void AxisController::setJerk(double value)
+{
+    jerk = value;
+}
+
+double AxisController::getJerk() const
+{
+    return jerk;
+}
+
+double AxisController::getCurrentVelocity(char axis) const
+{
+    return axisPositions.value(axis).currentVelocity;
+}
+
+double AxisController::getCurrentAcceleration(char axis) const
+{
+    return axisPositions.value(axis).currentAcceleration;
+}
+
 void AxisController::emergencyStop()
 {
     if (!emergencyStopActive) {
@@ -231,36 +588,495 @@ void AxisController::setMaxSpeed(double speed)
     maxSpeed = speed;
 }
 
-void AxisController::updateJogMovement()
+void AxisController::setMicrostepMode(char axis, MicrostepMode mode)
 {
-    // Bu fonksiyon şu an kullanılmıyor, sürekli jog için updateContinuousMovement kullanılıyor
+    if (axisPositions.contains(axis)) {
+        axisPositions[axis].microstepMode = mode;
+    }
 }
 
-void AxisController::updateContinuousMovement()
+MicrostepMode AxisController::getMicrostepMode(char axis) const
 {
-    if (currentJogAxis == ' ' || emergencyStopActive) {
-        return;
+    return axisPositions.value(axis).microstepMode;
+}
+
+void AxisController::setStepsPerRevolution(char axis, int steps)
+{
+    if (axisPositions.contains(axis) && steps > 0) {
+        axisPositions[axis].stepsPerRevolution = steps;
+    }
+}
+
+int AxisController::getStepsPerRevolution(char axis) const
+{
+    return axisPositions.value(axis).stepsPerRevolution;
+}
+
+void AxisController::setMmPerStep(char axis, double mmPerStep)
+{
+    if (axisPositions.contains(axis) && mmPerStep > 0.0) {
+        axisPositions[axis].mmPerStep = mmPerStep;
     }
+}
+
+double AxisController::getMmPerStep(char axis) const
+{
+    return axisPositions.value(axis).mmPerStep;
+}
+
+double AxisController::getStepsPerMm(char axis) const
+{
+    const AxisPosition position = axisPositions.value(axis);
+    if (position.mmPerStep <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<int>(position.microstepMode) / position.mmPerStep;
+}
+
+StepRateReport AxisController::analyzeStepRates(const QStringList &program, double stepRateCeiling,
+                                                bool recordSegments) const
+{
+    StepGenerator generator;
+    double start[StepGenerator::AXIS_COUNT];
+    for (int i = 0; i < StepGenerator::AXIS_COUNT; ++i) {
+        const AxisPosition position = axisPositions.value(STEP_AXES[i]);
+        generator.setAxis(i, getStepsPerMm(STEP_AXES[i]), position.maxRate, position.maxAcceleration);
+        start[i] = position.current;
+    }
+    generator.setStepRateCeiling(stepRateCeiling);
+    generator.setRecordSegments(recordSegments);
+    return generator.analyze(start, programToStepBlocks(program, start));
+}
+
+QVector<StepBlock> AxisController::programToStepBlocks(const QStringList &program, const double start[3]) const
+{
+    QVector<StepBlock> blocks;
+    double position[3] = {start[0], start[1], start[2]};
+    double coordinateOffset[3] = {0.0, 0.0, 0.0};     // G92
+    int motionMode = 0;
+    int plane = 17;
+    bool absolute = true;
+    bool inches = false;
+    double feedRate = 0.0;
     
-    if (!axisPositions.contains(currentJogAxis)) {
+    for (int lineIndex = 0; lineIndex < program.size(); ++lineIndex) {
+        // Yorumları ve boşlukları at
+        QString clean;
+        bool inComment = false;
+        for (QChar c : program[lineIndex]) {
+            if (c == ';') {
+                break;
+            }
+            if (c == '(') {
+                inComment = true;
+            } else if (c == ')') {
+                inComment = false;
+            } else if (!inComment && !c.isSpace()) {
+                clean.append(c.toUpper());
+            }
+        }
+        if (clean.isEmpty() || clean.startsWith('$')) {
+            continue;
+        }
+        
+        double words[3] = {0.0, 0.0, 0.0};
+        bool hasAxis[3] = {false, false, false};
+        double offset[3] = {0.0, 0.0, 0.0};
+        double radius = 0.0;
+        bool hasRadius = false;
+        bool setOffset = false;
+        bool skipMotion = false;
+        int i = 0;
+        while (i < clean.size()) {
+            QChar letter = clean[i++];
+            int begin = i;
+            while (i < clean.size() && (clean[i].isDigit() || clean[i] == '.' || clean[i] == '-' || clean[i] == '+')) {
+                ++i;
+            }
+            bool ok = false;
+            double value = clean.mid(begin, i - begin).toDouble(&ok);
+            if (!ok) {
+                continue;
+            }
+            
+            switch (letter.unicode()) {
+                case 'G': {
+                    int code = qRound(value * 10.0);
+                    if (code == 0 || code == 10 || code == 20 || code == 30) {
+                        motionMode = code / 10;
+                    } else if (code == 800) {
+                        motionMode = -1;
+                    } else if (code == 170 || code == 180 || code == 190) {
+                        plane = code / 10;
+                    } else if (code == 200 || code == 210) {
+                        inches = code == 200;
+                    } else if (code == 900 || code == 910) {
+                        absolute = code == 900;
+                    } else if (code == 920) {
+                        setOffset = true;
+                    } else if (code == 100 || code == 280 || code == 300 || code == 530) {
+                        // Kayıtlı konumlar/makine koordinatı bilinmiyor: satır hareket sayılmaz
+                        skipMotion = true;
+                    }
+                    break;
+                }
+                case 'X': case 'Y': case 'Z':
+                    words[letter.unicode() - 'X'] = value;
+                    hasAxis[letter.unicode() - 'X'] = true;
+                    break;
+                case 'I': case 'J': case 'K':
+                    offset[letter.unicode() - 'I'] = value;
+                    break;
+                case 'R':
+                    radius = value;
+                    hasRadius = true;
+                    break;
+                case 'F':
+                    feedRate = value * (inches ? 25.4 : 1.0);
+                    break;
+                default:
+                    break;
+            }
+        }
+        
+        double scale = inches ? 25.4 : 1.0;
+        bool anyAxis = hasAxis[0] || hasAxis[1] || hasAxis[2];
+        if (setOffset) {
+            for (int axis = 0; axis < 3; ++axis) {
+                if (hasAxis[axis]) {
+                    coordinateOffset[axis] = position[axis] - words[axis] * scale;
+                }
+            }
+            continue;
+        }
+        if (!anyAxis || motionMode < 0 || skipMotion) {
+            continue;
+        }
+        
+        double target[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            target[axis] = position[axis];
+            if (hasAxis[axis]) {
+                target[axis] = absolute ? words[axis] * scale + coordinateOffset[axis]
+                                        : position[axis] + words[axis] * scale;
+            }
+            offset[axis] *= scale;
+        }
+        radius *= scale;
+        
+        StepBlock block;
+        block.feedRate = feedRate;
+        block.rapid = motionMode == 0;
+        block.lineNumber = lineIndex + 1;
+        
+        if (motionMode == 2 || motionMode == 3) {
+            // GRBL mc_arc: yay, ARC_TOLERANCE sapmalı kirişlere bölünür
+            int first = (plane == 18) ? 2 : (plane == 19) ? 1 : 0;
+            int second = (plane == 18) ? 0 : (plane == 19) ? 2 : 1;
+            int linear = 3 - first - second;
+            bool clockwise = motionMode == 2;
+            double x = target[first] - position[first];
+            double y = target[second] - position[second];
+            
+            if (hasRadius) {
+                // R biçiminden merkez (gcode.c)
+                double h = 4.0 * radius * radius - x * x - y * y;
+                double chord = std::hypot(x, y);
+                if (h < 0.0 || chord <= 0.0) {
+                    continue;   // GRBL: error:33
+                }
+                h = -std::sqrt(h) / chord;
+                if (!clockwise) {
+                    h = -h;
+                }
+                if (radius < 0.0) {
+                    h = -h;
+                }
+                offset[first] = 0.5 * (x - y * h);
+                offset[second] = 0.5 * (y + x * h);
+            }
+            
+            double centerX = position[first] + offset[first];
+            double centerY = position[second] + offset[second];
+            double r = std::hypot(offset[first], offset[second]);
+            double rx = -offset[first];
+            double ry = -offset[second];
+            double tx = target[first] - centerX;
+            double ty = target[second] - centerY;
+            double sweep = std::atan2(rx * ty - ry * tx, rx * tx + ry * ty);
+            if (clockwise) {
+                if (sweep >= -5e-7) {
+                    sweep -= 2.0 * M_PI;
+                }
+            } else if (sweep <= 5e-7) {
+                sweep += 2.0 * M_PI;
+            }
+            
+            int segments = 0;
+            if (r > ARC_TOLERANCE) {
+                segments = static_cast<int>(std::floor(std::fabs(0.5 * sweep * r)
+                                                       / std::sqrt(ARC_TOLERANCE * (2.0 * r - ARC_TOLERANCE))));
+            }
+            double startAngle = std::atan2(ry, rx);
+            double linearStart = position[linear];
+            for (int k = 1; k < segments; ++k) {
+                double angle = startAngle + sweep * k / segments;
+                block.target[first] = centerX + r * std::cos(angle);
+                block.target[second] = centerY + r * std::sin(angle);
+                block.target[linear] = linearStart + (target[linear] - linearStart) * k / segments;
+                blocks.append(block);
+            }
+        }
+        
+        for (int axis = 0; axis < 3; ++axis) {
+            block.target[axis] = target[axis];
+            position[axis] = target[axis];
+        }
+        blocks.append(block);
+    }
+    return blocks;
+}
+
+SimulationClock *AxisController::getSimulationClock() const
+{
+    return simulationClock;
+}
+
+bool AxisController::hasActiveMotion() const
+{
+    return continuousJogActive || coordinatedMoveActive || !activeProfiles.isEmpty();
+}
+
+double AxisController::runUntilIdle(double maxSeconds)
+{
+    // Gerçek zaman modunda saat kendi ilerler; burada ayrıca adım işlemek zamanı bozar
+    if (simulationClock->getMode() != SimulationClock::Mode::Batch) {
+        return 0.0;
+    }
+    
+    double simulated = 0.0;
+    while (hasActiveMotion() && simulated < maxSeconds) {
+        simulated += simulationClock->advance(qMin(BATCH_FRAME_SECONDS, maxSeconds - simulated));
+    }
+    return simulated;
+}
+
+void AxisController::advanceSimulation(double dt)
+{
+    // Acil durumda tüm hareketler zaten bırakılmıştır; aşağıdaki kontrol saati durdurur
+    if (continuousJogActive) {
+        updateContinuousMovement(dt);
+    }
+    
+    // updateProfileExecution biten profilleri siler: anahtarların kopyası üzerinde dön
+    const QList<char> axes = activeProfiles.keys();
+    for (char axis : axes) {
+        updateProfileExecution(axis, dt);
+    }
+    
+    if (coordinatedMoveActive) {
+        updateCoordinatedMove(dt);
+    }
+    
+    // Boştayken gerçek zamanlı saat uyandırılmaz
+    if (!hasActiveMotion()) {
+        simulationClock->stop();
+    }
+}
+
+void AxisController::publishFrame()
+{
+    const QList<char> axes = changedAxes.values();
+    for (char axis : axes) {
+        publishAxis(axis);
+    }
+}
+
+void AxisController::updateContinuousMovement(double dt)
+{
+    if (currentJogAxis == ' ' || !axisPositions.contains(currentJogAxis)) {
         return;
     }
     
-    double step = calculateJogDistance();
+    double step = calculateJogDistance(dt);
     double currentPos = axisPositions[currentJogAxis].current;
     double newPos = currentPos + (currentJogPositive ? step : -step);
     
     if (validateMovement(currentJogAxis, newPos)) {
-        updateAxisPosition(currentJogAxis, newPos);
-        applyAcceleration();
+        setSimulatedPosition(currentJogAxis, newPos);
+        applyAcceleration(dt);
     } else {
         stopContinuousJog();
     }
 }
 
+void AxisController::updateCoordinatedMove(double dt)
+{
+    // Kopya: sinyallere bağlı slotlar hareketi iptal edebilir
+    const CoordinatedMove move = activeMove;
+    coordinatedElapsed += dt;
+    bool finished = coordinatedElapsed >= move.profile.totalTime;
+    if (finished) {
+        coordinatedMoveActive = false;
+    }
+    
+    MotionSample sample = move.profile.sampleAt(coordinatedElapsed);
+    for (auto it = move.direction.constBegin(); it != move.direction.constEnd(); ++it) {
+        char axis = it.key();
+        // Son adımda hedef aynen yazılır, izdüşüm yuvarlaması birikmez
+        double position = finished ? move.targetPositions[axis]
+                                   : move.startPositions[axis] + it.value() * sample.position;
+        axisPositions[axis].currentVelocity = it.value() * sample.velocity;
+        axisPositions[axis].currentAcceleration = it.value() * sample.acceleration;
+        setSimulatedPosition(axis, position);
+    }
+    
+    if (finished) {
+        for (auto it = move.direction.constBegin(); it != move.direction.constEnd(); ++it) {
+            axisPositions[it.key()].isMoving = false;
+            publishAxis(it.key());
+            emit targetReached(it.key(), move.targetPositions[it.key()]);
+            emit movementStopped(it.key());
+        }
+        emit coordinatedMoveCompleted(move);
+    }
+}
+
+void AxisController::abortCoordinatedMove()
+{
+    if (!coordinatedMoveActive) {
+        return;
+    }
+    
+    coordinatedMoveActive = false;
+    for (auto it = activeMove.direction.constBegin(); it != activeMove.direction.constEnd(); ++it) {
+        AxisPosition &position = axisPositions[it.key()];
+        position.isMoving = false;
+        position.currentVelocity = 0.0;
+        position.currentAcceleration = 0.0;
+        publishAxis(it.key());
+        emit movementStopped(it.key());
+    }
+}
+
+void AxisController::updateProfileExecution(char axis, double dt)
+{
+    if (!activeProfiles.contains(axis)) {
+        return;
+    }
+    
+    // Kopya: sinyallere bağlı slotlar hareketi durdurup profili silebilir
+    const MotionProfile profile = activeProfiles.value(axis);
+    double elapsed = profileElapsed.value(axis) + dt;
+    profileElapsed[axis] = elapsed;
+    
+    MotionSample sample = profile.sampleAt(elapsed);
+    axisPositions[axis].currentVelocity = sample.velocity;
+    axisPositions[axis].currentAcceleration = sample.acceleration;
+    setSimulatedPosition(axis, sample.position);
+    
+    if (elapsed >= profile.totalTime && activeProfiles.contains(axis)) {
+        activeProfiles.remove(axis);
+        profileElapsed.remove(axis);
+        axisPositions[axis].isMoving = false;
+        publishAxis(axis);
+        emit targetReached(axis, profile.endPosition);
+        emit profileCompleted(axis, profile);
+        emit movementStopped(axis);
+    }
+}
+
+MotionProfile AxisController::emptyProfile(double startPos, double endPos, double maxSpeed, double acceleration) const
+{
+    MotionProfile profile;
+    profile.startPosition = startPos;
+    profile.endPosition = endPos;
+    profile.maxSpeed = maxSpeed;
+    profile.acceleration = acceleration;
+    profile.deceleration = acceleration;
+    profile.jerk = 0.0;
+    profile.profile = AccelerationProfile::Trapezoidal;
+    profile.totalTime = 0.0;
+    profile.peakVelocity = qMax(0.0, maxSpeed / 60.0);
+    profile.phaseCount = 0;
+    return profile;
+}
+
+void AxisController::appendPhase(MotionProfile &profile, double duration, double jerk, double startAcceleration) const
+{
+    if (duration < MIN_PHASE_DURATION || profile.phaseCount >= 7) {
+        return;
+    }
+    
+    // Başlangıç hızı ve yolu önceki evrenin sonundan
+    double velocity = 0.0;
+    double distance = 0.0;
+    if (profile.phaseCount > 0) {
+        const MotionPhase &last = profile.phases[profile.phaseCount - 1];
+        double t = last.duration;
+        velocity = last.startVelocity + last.startAcceleration * t + last.jerk * t * t / 2.0;
+        distance = last.startDistance + last.startVelocity * t + last.startAcceleration * t * t / 2.0
+            + last.jerk * t * t * t / 6.0;
+    }
+    
+    MotionPhase &phase = profile.phases[profile.phaseCount++];
+    phase.startTime = profile.totalTime;
+    phase.duration = duration;
+    phase.jerk = jerk;
+    phase.startAcceleration = startAcceleration;
+    phase.startVelocity = qMax(0.0, velocity);
+    phase.startDistance = distance;
+    profile.totalTime += duration;
+}
+
+MotionSample MotionProfile::sampleAt(double time) const
+{
+    const double direction = endPosition >= startPosition ? 1.0 : -1.0;
+    MotionSample sample;
+    sample.time = time;
+    
+    // Profil dışında duruş; son noktada yuvarlama hatası birikmesin diye hedef aynen verilir
+    if (time <= 0.0 || phaseCount == 0) {
+        sample.position = time <= 0.0 ? startPosition : endPosition;
+        sample.velocity = 0.0;
+        sample.acceleration = 0.0;
+        return sample;
+    }
+    if (time >= totalTime) {
+        sample.position = endPosition;
+        sample.velocity = 0.0;
+        sample.acceleration = 0.0;
+        return sample;
+    }
+    
+    // En fazla 7 evre: sabit maliyetli tarama
+    int index = 0;
+    while (index < phaseCount - 1 && time >= phases[index + 1].startTime) {
+        ++index;
+    }
+    
+    const MotionPhase &phase = phases[index];
+    double t = time - phase.startTime;
+    double distance = phase.startDistance + phase.startVelocity * t + phase.startAcceleration * t * t / 2.0
+        + phase.jerk * t * t * t / 6.0;
+    double velocity = phase.startVelocity + phase.startAcceleration * t + phase.jerk * t * t / 2.0;
+    double acceleration = phase.startAcceleration + phase.jerk * t;
+    
+    double length = qAbs(endPosition - startPosition);
+    sample.position = startPosition + direction * qBound(0.0, distance, length);
+    sample.velocity = direction * qMax(0.0, velocity);
+    sample.acceleration = direction * acceleration;
+    return sample;
+}
+
 void AxisController::initializeAxis(char axis)
 {
     axisPositions[axis] = AxisPosition{0.0, 0.0, false};
+    axisPositions[axis].maxRate = maxSpeed;
+    axisPositions[axis].maxAcceleration = DEFAULT_AXIS_ACCELERATION;
+    axisPositions[axis].microstepMode = MicrostepMode::Sixteenth;
+    axisPositions[axis].stepsPerRevolution = DEFAULT_STEPS_PER_REVOLUTION;
+    axisPositions[axis].mmPerStep = DEFAULT_MM_PER_STEP;
     axisLimits[axis] = AxisLimits{-50.0, 50.0, true};
 }
 
@@ -282,16 +1098,43 @@ void AxisController::updateAxisPosition(char axis, double newPosition)
     }
 }
 
-double AxisController::calculateJogDistance() const
+double AxisController::calculateJogDistance(double dt) const
 {
-    // Hızı mm/s'ye çevir ve timer aralığıyla çarp
+    // Hızı mm/s'ye çevir ve simülasyon adımıyla çarp
     double speedMMPerSec = jogSpeed / 60.0;
-    double timerIntervalSec = continuousTimer->interval() / 1000.0;
-    return speedMMPerSec * timerIntervalSec * acceleration;
+    return speedMMPerSec * dt * acceleration;
 }
 
-void AxisController::applyAcceleration()
+void AxisController::applyAcceleration(double dt)
 {
     // Kademeli hızlanma
-    acceleration = qMin(acceleration + 0.1, 3.0); // Maksimum 3x hızlanma
+    acceleration = qMin(acceleration + JOG_RAMP_RATE * dt, JOG_RAMP_MAX);
+}
+
+void AxisController::startSimulation()
+{
+    if (!simulationClock->isRunning()) {
+        simulationClock->start();
+    }
+}
+
+void AxisController::setSimulatedPosition(char axis, double position)
+{
+    // Adım başına sinyal yerine kare başına bir kez yayınlanır (publishFrame)
+    axisPositions[axis].current = position;
+    changedAxes.insert(axis);
+}
+
+void AxisController::publishAxis(char axis)
+{
+    if (!axisPositions.contains(axis)) {
+        return;
+    }
+    
+    // Kopya: bağlı slotlar eksen durumunu değiştirebilir
+    changedAxes.remove(axis);
+    const AxisPosition position = axisPositions.value(axis);
+    emit positionChanged(axis, position.current);
+    emit velocityChanged(axis, position.currentVelocity);
+    emit accelerationChanged(axis, position.currentAcceleration);
 } 
\ No newline at end of file
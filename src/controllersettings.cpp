@@ -0,0 +1,197 @@
+#include "controllersettings.h"
+#include <QRegularExpression>
+#include <QtMath>
+
+ControllerSettings::ControllerSettings()
+    : loaded(false)
+{
+}
+
+bool ControllerSettings::isLoaded() const
+{
+    return loaded;
+}
+
+void ControllerSettings::setLoaded(bool isLoaded)
+{
+    loaded = isLoaded;
+}
+
+void ControllerSettings::clear()
+{
+    values.clear();
+    namedValues.clear();
+    loaded = false;
+}
+
+bool ControllerSettings::parseLine(const QString &line)
+{
+    // GRBL 1.1: "$100=250.000", GRBL 0.9: "$100=250.000 (x, step/mm)"
+    static const QRegularExpression numericPattern("^\\$(\\d+)=(-?[0-9.]+)");
+    // grbl_ESP32: "$Sta/SSID=atolyem"
+    static const QRegularExpression namedPattern("^\\$([A-Za-z][A-Za-z0-9_/]*)=(.*)$");
+    
+    QRegularExpressionMatch match = numericPattern.match(line);
+    if (match.hasMatch()) {
+        bool ok = false;
+        double parsed = match.captured(2).toDouble(&ok);
+        if (ok) {
+            values[match.captured(1).toInt()] = parsed;
+            return true;
+        }
+        return false;
+    }
+    
+    match = namedPattern.match(line);
+    if (match.hasMatch()) {
+        namedValues[match.captured(1)] = match.captured(2).trimmed();
+        return true;
+    }
+    
+    return false;
+}
+
+bool ControllerSettings::has(int number) const
+{
+    return values.contains(number);
+}
+
+double ControllerSettings::value(int number, double defaultValue) const
+{
+    return values.value(number, defaultValue);
+}
+
+void ControllerSettings::setValue(int number, double value)
+{
+    values[number] = value;
+}
+
+void ControllerSettings::invalidate(int number)
+{
+    values.remove(number);
+}
+
+QMap<int, double> ControllerSettings::numericSettings() const
+{
+    return values;
+}
+
+QString ControllerSettings::namedValue(const QString &name) const
+{
+    return namedValues.value(name);
+}
+
+int ControllerSettings::axisSetting(int base, char axis)
+{
+    static const QString axes = "XYZABC";
+    int index = axes.indexOf(QChar(axis).toUpper());
+    return index < 0 ? -1 : base + index;
+}
+
+double ControllerSettings::getStepsPerMm(char axis) const
+{
+    return value(axisSetting(StepsPerMmBase, axis));
+}
+
+double ControllerSettings::getMaxRate(char axis) const
+{
+    return value(axisSetting(MaxRateBase, axis));
+}
+
+double ControllerSettings::getAcceleration(char axis) const
+{
+    return value(axisSetting(AccelerationBase, axis));
+}
+
+double ControllerSettings::getMaxTravel(char axis) const
+{
+    return value(axisSetting(MaxTravelBase, axis));
+}
+
+int ControllerSettings::getStatusReportMask() const
+{
+    return static_cast<int>(value(StatusReportMask, -1));
+}
+
+double ControllerSettings::getJunctionDeviation() const
+{
+    return value(JunctionDeviation);
+}
+
+double ControllerSettings::getArcTolerance() const
+{
+    return value(ArcTolerance);
+}
+
+bool ControllerSettings::isReportInches() const
+{
+    return value(ReportInches) != 0.0;
+}
+
+bool ControllerSettings::isSoftLimitsEnabled() const
+{
+    return value(SoftLimits) != 0.0;
+}
+
+bool ControllerSettings::isHardLimitsEnabled() const
+{
+    return value(HardLimits) != 0.0;
+}
+
+bool ControllerSettings::isHomingEnabled() const
+{
+    return value(HomingCycle) != 0.0;
+}
+
+double ControllerSettings::getSpindleMax() const
+{
+    return value(SpindleMax);
+}
+
+double ControllerSettings::getSpindleMin() const
+{
+    return value(SpindleMin);
+}
+
+bool ControllerSettings::isLaserMode() const
+{
+    return value(LaserMode) != 0.0;
+}
+
+QStringList ControllerSettings::diff(const QMap<int, double> &profile) const
+{
+    QStringList commands;
+    for (auto it = profile.constBegin(); it != profile.constEnd(); ++it) {
+        // GRBL değerleri 3 ondalıkla raporlar; daha küçük farklar yazıma değmez
+        if (values.contains(it.key()) && qAbs(values.value(it.key()) - it.value()) < 0.0005) {
+            continue;
+        }
+        commands << formatWrite(it.key(), it.value());
+    }
+    return commands;
+}
+
+QString ControllerSettings::formatWrite(int number, double value)
+{
+    QString text = QString::number(value, 'f', 3);
+    while (text.endsWith('0')) {
+        text.chop(1);
+    }
+    if (text.endsWith('.')) {
+        text.chop(1);
+    }
+    return QString("$%1=%2").arg(number).arg(text);
+}
+
+bool ControllerSettings::parseWrite(const QString &command, int &number, double &value)
+{
+    static const QRegularExpression writePattern("^\\$(\\d+)=\\s*(-?[0-9.]+)\\s*$");
+    QRegularExpressionMatch match = writePattern.match(command.trimmed());
+    if (!match.hasMatch()) {
+        return false;
+    }
+    
+    number = match.captured(1).toInt();
+    value = match.captured(2).toDouble();
+    return true;
+}
@@ -0,0 +1,309 @@
+#include "gcodecompactor.h"
+#include <cmath>
+
+GCodeCompactor::GCodeCompactor()
+    : lastLineId(0)
+    , acknowledgedLineId(0)
+    , mmDecimals(3)
+    , inchDecimals(4)
+    , bytesIn(0)
+    , bytesOut(0)
+{
+    invalidate();
+}
+
+void GCodeCompactor::invalidate()
+{
+    for (ModalGroup *group : {&motionMode, &planeMode, &distanceMode, &unitsMode, &feedMode, &coordSystem}) {
+        group->value = -1;
+        group->setBy = 0;
+    }
+    feedRate.clear();
+    feedRateSetBy = 0;
+}
+
+quint64 GCodeCompactor::getLastLineId() const
+{
+    return lastLineId;
+}
+
+void GCodeCompactor::acknowledge(quint64 lineId)
+{
+    // ok'lar sırayla gelir: bir satırın onayı öncekileri de kapsar
+    acknowledgedLineId = qMax(acknowledgedLineId, lineId);
+}
+
+void GCodeCompactor::setDecimals(int mm, int inch)
+{
+    mmDecimals = qBound(0, mm, 6);
+    inchDecimals = qBound(0, inch, 6);
+}
+
+int GCodeCompactor::getMmDecimals() const
+{
+    return mmDecimals;
+}
+
+qint64 GCodeCompactor::getBytesIn() const
+{
+    return bytesIn;
+}
+
+qint64 GCodeCompactor::getBytesOut() const
+{
+    return bytesOut;
+}
+
+qint64 GCodeCompactor::getBytesSaved() const
+{
+    return bytesIn - bytesOut;
+}
+
+void GCodeCompactor::resetStatistics()
+{
+    bytesIn = 0;
+    bytesOut = 0;
+}
+
+QString GCodeCompactor::compact(const QString &line)
+{
+    QString trimmed = line.trimmed();
+    bytesIn += trimmed.toUtf8().size() + 1;
+    const quint64 lineId = ++lastLineId;
+    
+    // Sistem komutları modal durumu etkilemez; jog satırından yalnızca boşluk atılır
+    if (trimmed.startsWith('$')) {
+        if (trimmed.startsWith("$J=", Qt::CaseInsensitive)) {
+            return finish(stripCommentsAndSpaces(trimmed));
+        }
+        return finish(trimmed);
+    }
+    
+    QString clean = stripCommentsAndSpaces(trimmed);
+    if (clean.isEmpty()) {
+        return finish(clean);
+    }
+    
+    QVector<Word> words;
+    if (!parseWords(clean, words)) {
+        // Ayrıştırılamayan satırı kontrolcü değerlendirsin; durum artık belirsiz
+        invalidate();
+        return finish(clean);
+    }
+    
+    // Bu satırdaki birim ve mesafe modu (kelime sırası önemsiz)
+    int lineUnits = unitsMode.value;
+    int lineDistance = distanceMode.value;
+    int lineFeedMode = feedMode.value;
+    for (const Word &word : words) {
+        if (word.letter == 'G') {
+            if (word.value == 20 || word.value == 21) {
+                lineUnits = static_cast<int>(word.value);
+            } else if (word.value == 90 || word.value == 91) {
+                lineDistance = static_cast<int>(word.value);
+            } else if (word.value == 93 || word.value == 94) {
+                lineFeedMode = static_cast<int>(word.value);
+            }
+        }
+    }
+    
+    // GRBL F'yi ayrıştırırken mm/dk'ya çevirir: birim değişince aynı F sayısı
+    // farklı hız demektir (G21 F100 -> G20 F100 = 25.4 kat), tekrar gönderilmeli
+    if (lineUnits != unitsMode.value) {
+        feedRate.clear();
+    }
+    
+    // Birim bilinmiyorsa inç çözünürlüğü (daha hassas) kullanılır. Artımsal
+    // modda yuvarlama hatası birikeceğinden sayılar yuvarlanmaz.
+    int axisDecimals = (lineUnits == 21) ? mmDecimals : inchDecimals;
+    bool roundAxes = (lineDistance == 90);
+    
+    QString output;
+    QString firstGWord;
+    bool programEnd = false;
+    for (const Word &word : words) {
+        QChar letter = word.letter;
+        
+        if (letter == 'N') {
+            continue; // Satır numaraları kontrolcü için anlamsız
+        }
+        
+        if (letter == 'G') {
+            bool integral = word.value == std::floor(word.value);
+            int code = static_cast<int>(word.value);
+            QString gWord = "G" + (integral ? QString::number(code) : formatNumber(word.value, 1));
+            if (firstGWord.isEmpty()) {
+                firstGWord = gWord;
+            }
+            
+            ModalGroup *group = integral ? modalGroupFor(code) : nullptr;
+            if (!integral && code == 38) {
+                motionMode.value = -1; // G38.x prob hareketi: motion grubunu değiştirir
+            }
+            if (group) {
+                if (group->value == code) {
+                    if (group->setBy <= acknowledgedLineId) {
+                        continue; // Kontrolcü zaten bu modda (ayarlayan satır onaylandı)
+                    }
+                } else {
+                    // Değeri değiştiren ilk satır kaydedilir; onun ok'u sonraki tekrarları düşürür
+                    group->value = code;
+                    group->setBy = lineId;
+                }
+            }
+            output += gWord;
+            continue;
+        }
+        
+        if (letter == 'F') {
+            QString value = formatNumber(word.value, 3);
+            // Ters zaman modunda (G93) F her satırda gereklidir
+            if (lineFeedMode != 93 && value == feedRate) {
+                if (feedRateSetBy <= acknowledgedLineId) {
+                    continue;
+                }
+            } else {
+                feedRate = (lineFeedMode == 93) ? QString() : value;
+                feedRateSetBy = lineId;
+            }
+            output += "F" + value;
+            continue;
+        }
+        
+        if (QString("XYZABCIJKR").contains(letter)) {
+            bool isOffset = (letter == 'I' || letter == 'J' || letter == 'K' || letter == 'R');
+            if (roundAxes || isOffset) {
+                output += letter + formatNumber(word.value, axisDecimals);
+            } else {
+                output += letter + formatNumber(word.value, 6);
+            }
+            continue;
+        }
+        
+        // Diğer kelimeler (M, S, T, P, L, ...) sadece sayı biçimiyle yazılır
+        output += letter + formatNumber(word.value, 4);
+        if (letter == 'M' && (word.value == 2 || word.value == 30)) {
+            programEnd = true;
+        }
+    }
+    
+    // M2/M30: GRBL satırın sonunda modal durumu program sonu değerlerine döndürür
+    // (G1 G17 G90 G94 G54). Birim ve F korunur. Değerleri bu satır kurmuş sayılır.
+    if (programEnd) {
+        for (int code : {1, 17, 90, 94, 54}) {
+            ModalGroup *group = modalGroupFor(code);
+            if (group->value != code) {
+                group->value = code;
+                group->setBy = lineId;
+            }
+        }
+    }
+    
+    // Tüm kelimeler gereksiz çıktıysa satır boş kalmasın (ok sayımı korunur)
+    if (output.isEmpty() && !firstGWord.isEmpty()) {
+        output = firstGWord;
+    }
+    
+    return finish(output.isEmpty() ? clean : output);
+}
+
+QString GCodeCompactor::stripCommentsAndSpaces(const QString &line) const
+{
+    QString result;
+    result.reserve(line.size());
+    int depth = 0;
+    
+    for (QChar c : line) {
+        if (c == '(') {
+            depth++;
+        } else if (c == ')') {
+            depth = qMax(depth - 1, 0);
+        } else if (c == ';' && depth == 0) {
+            break;
+        } else if (depth == 0 && !c.isSpace()) {
+            result += c.toUpper();
+        }
+    }
+    
+    return result;
+}
+
+bool GCodeCompactor::parseWords(const QString &clean, QVector<Word> &words) const
+{
+    int pos = 0;
+    while (pos < clean.size()) {
+        QChar letter = clean.at(pos++);
+        if (letter < 'A' || letter > 'Z') {
+            return false;
+        }
+        
+        int start = pos;
+        while (pos < clean.size() && (clean.at(pos).isDigit() || clean.at(pos) == '.'
+                                      || clean.at(pos) == '-' || clean.at(pos) == '+')) {
+            pos++;
+        }
+        
+        bool ok = false;
+        QString number = clean.mid(start, pos - start);
+        double value = number.toDouble(&ok);
+        if (!ok) {
+            return false;
+        }
+        words.append(Word{letter, number, value});
+    }
+    return true;
+}
+
+GCodeCompactor::ModalGroup *GCodeCompactor::modalGroupFor(int code)
+{
+    switch (code) {
+        case 0: case 1: case 2: case 3: case 80:
+            return &motionMode;
+        case 17: case 18: case 19:
+            return &planeMode;
+        case 90: case 91:
+            return &distanceMode;
+        case 20: case 21:
+            return &unitsMode;
+        case 93: case 94:
+            return &feedMode;
+        case 54: case 55: case 56: case 57: case 58: case 59:
+            return &coordSystem;
+        default:
+            return nullptr; // Modal olmayan: G4, G10, G28, G53, G92, ...
+    }
+}
+
+QString GCodeCompactor::formatNumber(double value, int decimals) const
+{
+    QString text = QString::number(value, 'f', decimals);
+    
+    // Sondaki sıfırları ve noktayı at: 10.500 -> 10.5, 10.000 -> 10
+    if (text.contains('.')) {
+        while (text.endsWith('0')) {
+            text.chop(1);
+        }
+        if (text.endsWith('.')) {
+            text.chop(1);
+        }
+    }
+    
+    if (text == "-0") {
+        return "0";
+    }
+    
+    // Baştaki sıfır gereksiz: 0.5 -> .5, -0.5 -> -.5
+    if (text.startsWith("0.")) {
+        text.remove(0, 1);
+    } else if (text.startsWith("-0.")) {
+        text.remove(1, 1);
+    }
+    
+    return text;
+}
+
+QString GCodeCompactor::finish(const QString &output)
+{
+    bytesOut += output.toUtf8().size() + 1;
+    return output;
+}
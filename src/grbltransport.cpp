@@ -0,0 +1,678 @@
+#include "grbltransport.h"
+#include <QIODevice>
+#include <QTcpSocket>
+#include <QWebSocket>
+
+#ifdef Q_OS_LINUX
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/serial.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+// --- GrblTransport ---
+
+GrblTransport::GrblTransport(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QString GrblTransport::errorString() const
+{
+    return lastError;
+}
+
+bool GrblTransport::canReadLine() const
+{
+    return receiveBuffer.contains('\n');
+}
+
+QByteArray GrblTransport::readLine()
+{
+    int end = receiveBuffer.indexOf('\n');
+    if (end < 0) {
+        return QByteArray();
+    }
+    
+    QByteArray line = receiveBuffer.left(end + 1);
+    receiveBuffer.remove(0, end + 1);
+    return line;
+}
+
+void GrblTransport::appendReceived(const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+    
+    receiveBuffer.append(data);
+    emit bytesReceived(data);
+    emit readyRead();
+}
+
+void GrblTransport::clearReceived()
+{
+    receiveBuffer.clear();
+}
+
+void GrblTransport::setErrorString(const QString &error)
+{
+    lastError = error;
+}
+
+// --- SerialTransport ---
+
+SerialTransport::SerialTransport(const QString &portName, int baudRate, QObject *parent)
+    : GrblTransport(parent)
+    , serialPort(new QSerialPort(this))
+{
+    serialPort->setPortName(portName);
+    serialPort->setBaudRate(baudRate);
+    serialPort->setDataBits(QSerialPort::Data8);
+    serialPort->setParity(QSerialPort::NoParity);
+    serialPort->setStopBits(QSerialPort::OneStop);
+    serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    
+    connect(serialPort, &QSerialPort::readyRead, this, &SerialTransport::handleReadyRead);
+    connect(serialPort, &QSerialPort::errorOccurred, this, &SerialTransport::handleError);
+}
+
+bool SerialTransport::open()
+{
+    clearReceived();
+    if (!serialPort->open(QIODevice::ReadWrite)) {
+        setErrorString(serialPort->errorString());
+        return false;
+    }
+    
+    emit opened();
+    return true;
+}
+
+void SerialTransport::close()
+{
+    if (serialPort->isOpen()) {
+        serialPort->close();
+        emit closed();
+    }
+}
+
+bool SerialTransport::isOpen() const
+{
+    return serialPort->isOpen();
+}
+
+qint64 SerialTransport::write(const QByteArray &data)
+{
+    return serialPort->write(data);
+}
+
+QString SerialTransport::describe() const
+{
+    return QString("%1 @ %2").arg(serialPort->portName()).arg(serialPort->baudRate());
+}
+
+QSerialPort *SerialTransport::port() const
+{
+    return serialPort;
+}
+
+void SerialTransport::handleReadyRead()
+{
+    appendReceived(serialPort->readAll());
+}
+
+void SerialTransport::handleError(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError) {
+        return;
+    }
+    
+    setErrorString(serialPort->errorString());
+    emit errorOccurred("Seri port hatası: " + serialPort->errorString());
+    
+    // Kablo çekildi vb.: port artık kullanılamaz
+    if (error == QSerialPort::ResourceError) {
+        close();
+    }
+}
+
+// --- IODeviceTransport ---
+
+IODeviceTransport::IODeviceTransport(QIODevice *device, QObject *parent)
+    : GrblTransport(parent)
+    , device(device)
+{
+    connect(device, &QIODevice::readyRead, this, &IODeviceTransport::handleReadyRead);
+}
+
+bool IODeviceTransport::open()
+{
+    clearReceived();
+    
+    // Cihaz kapalıysa burada açılır
+    if (!device->isOpen() && !device->open(QIODevice::ReadWrite)) {
+        setErrorString(device->errorString());
+        return false;
+    }
+    
+    emit opened();
+    
+    // Açılış sırasında gelmiş veri (örn. karşılama satırı) kaybolmasın
+    handleReadyRead();
+    return true;
+}
+
+void IODeviceTransport::close()
+{
+    if (device->isOpen()) {
+        device->close();
+        emit closed();
+    }
+}
+
+bool IODeviceTransport::isOpen() const
+{
+    return device->isOpen();
+}
+
+qint64 IODeviceTransport::write(const QByteArray &data)
+{
+    return device->write(data);
+}
+
+QString IODeviceTransport::describe() const
+{
+    return QString("QIODevice (%1)").arg(device->metaObject()->className());
+}
+
+void IODeviceTransport::handleReadyRead()
+{
+    appendReceived(device->readAll());
+}
+
+// --- TcpTransport ---
+
+namespace {
+    const unsigned char TELNET_IAC = 255;
+    const unsigned char TELNET_SB = 250;
+    const unsigned char TELNET_SE = 240;
+    const unsigned char TELNET_WILL = 251;
+    const unsigned char TELNET_DONT = 254;
+    
+    enum TelnetState {
+        TelnetData,
+        TelnetCommand,     // IAC alındı
+        TelnetOption,      // WILL/WONT/DO/DONT sonrası seçenek baytı
+        TelnetSub,         // SB ... IAC SE arası
+        TelnetSubCommand   // SB içinde IAC alındı
+    };
+}
+
+TcpTransport::TcpTransport(const QString &host, quint16 port, QObject *parent)
+    : GrblTransport(parent)
+    , socket(new QTcpSocket(this))
+    , hostName(host)
+    , portNumber(port)
+    , telnetState(TelnetData)
+{
+    connect(socket, &QTcpSocket::connected, this, &TcpTransport::handleConnected);
+    connect(socket, &QTcpSocket::disconnected, this, &TcpTransport::handleDisconnected);
+    connect(socket, &QTcpSocket::readyRead, this, &TcpTransport::handleReadyRead);
+    connect(socket, &QTcpSocket::errorOccurred, this, &TcpTransport::handleSocketError);
+}
+
+bool TcpTransport::open()
+{
+    clearReceived();
+    telnetState = TelnetData;
+    socket->connectToHost(hostName, portNumber);
+    return true;
+}
+
+void TcpTransport::close()
+{
+    socket->abort();
+}
+
+bool TcpTransport::isOpen() const
+{
+    return socket->state() == QAbstractSocket::ConnectedState;
+}
+
+qint64 TcpTransport::write(const QByteArray &data)
+{
+    return socket->write(data);
+}
+
+QString TcpTransport::describe() const
+{
+    return QString("tcp://%1:%2").arg(hostName).arg(portNumber);
+}
+
+void TcpTransport::handleConnected()
+{
+    // Kısa satırlar Nagle algoritmasıyla bekletilmesin
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    emit opened();
+}
+
+void TcpTransport::handleDisconnected()
+{
+    emit closed();
+}
+
+void TcpTransport::handleReadyRead()
+{
+    appendReceived(stripTelnetCommands(socket->readAll()));
+}
+
+void TcpTransport::handleSocketError()
+{
+    setErrorString(socket->errorString());
+    emit errorOccurred("TCP hatası: " + socket->errorString());
+}
+
+QByteArray TcpTransport::stripTelnetCommands(const QByteArray &data)
+{
+    QByteArray result;
+    result.reserve(data.size());
+    
+    for (char c : data) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        switch (telnetState) {
+            case TelnetData:
+                if (byte == TELNET_IAC) {
+                    telnetState = TelnetCommand;
+                } else {
+                    result.append(c);
+                }
+                break;
+            case TelnetCommand:
+                if (byte == TELNET_IAC) {
+                    result.append(c); // Kaçışlı 0xFF
+                    telnetState = TelnetData;
+                } else if (byte == TELNET_SB) {
+                    telnetState = TelnetSub;
+                } else if (byte >= TELNET_WILL && byte <= TELNET_DONT) {
+                    telnetState = TelnetOption;
+                } else {
+                    telnetState = TelnetData;
+                }
+                break;
+            case TelnetOption:
+                telnetState = TelnetData;
+                break;
+            case TelnetSub:
+                if (byte == TELNET_IAC) {
+                    telnetState = TelnetSubCommand;
+                }
+                break;
+            case TelnetSubCommand:
+                telnetState = (byte == TELNET_SE) ? TelnetData : TelnetSub;
+                break;
+        }
+    }
+    
+    return result;
+}
+
+// --- WebSocketTransport ---
+
+WebSocketTransport::WebSocketTransport(const QUrl &url, QObject *parent)
+    : GrblTransport(parent)
+    , socket(new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this))
+    , serverUrl(url)
+{
+    connect(socket, &QWebSocket::connected, this, &WebSocketTransport::handleConnected);
+    connect(socket, &QWebSocket::disconnected, this, &WebSocketTransport::handleDisconnected);
+    connect(socket, &QWebSocket::binaryMessageReceived, this, &WebSocketTransport::handleBinaryMessage);
+    connect(socket, &QWebSocket::textMessageReceived, this, &WebSocketTransport::handleTextMessage);
+    connect(socket, &QWebSocket::errorOccurred, this, &WebSocketTransport::handleSocketError);
+}
+
+bool WebSocketTransport::open()
+{
+    if (!serverUrl.isValid()) {
+        setErrorString("Geçersiz WebSocket adresi: " + serverUrl.toString());
+        return false;
+    }
+    
+    clearReceived();
+    socket->open(serverUrl);
+    return true;
+}
+
+void WebSocketTransport::close()
+{
+    socket->abort();
+}
+
+bool WebSocketTransport::isOpen() const
+{
+    return socket->state() == QAbstractSocket::ConnectedState;
+}
+
+qint64 WebSocketTransport::write(const QByteArray &data)
+{
+    return socket->sendBinaryMessage(data);
+}
+
+QString WebSocketTransport::describe() const
+{
+    return serverUrl.toString();
+}
+
+void WebSocketTransport::handleConnected()
+{
+    emit opened();
+}
+
+void WebSocketTransport::handleDisconnected()
+{
+    emit closed();
+}
+
+void WebSocketTransport::handleBinaryMessage(const QByteArray &message)
+{
+    appendReceived(message);
+}
+
+void WebSocketTransport::handleTextMessage(const QString &message)
+{
+    // grbl_ESP32 durum mesajlarını (örn. "CURRENT_ID:0") metin çerçevesiyle
+    // yollar; satır sonu yoksa eklenir ki satır ayrıştırıcı takılmasın
+    QByteArray data = message.toUtf8();
+    if (!data.endsWith('\n')) {
+        data.append('\n');
+    }
+    appendReceived(data);
+}
+
+void WebSocketTransport::handleSocketError()
+{
+    setErrorString(socket->errorString());
+    emit errorOccurred("WebSocket hatası: " + socket->errorString());
+}
+
+#ifdef Q_OS_LINUX
+// --- LinuxSerialTransport ---
+
+static speed_t baudRateConstant(int baudRate)
+{
+    static const struct {
+        int rate;
+        speed_t constant;
+    } rates[] = {
+        {9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600},
+        {115200, B115200}, {230400, B230400}, {460800, B460800}, {500000, B500000},
+        {576000, B576000}, {921600, B921600}, {1000000, B1000000}, {1500000, B1500000},
+        {2000000, B2000000}
+    };
+    for (const auto &entry : rates) {
+        if (entry.rate == baudRate) {
+            return entry.constant;
+        }
+    }
+    return B0;
+}
+
+static QString systemError(const QString &context)
+{
+    return QString("%1: %2").arg(context, QString::fromLocal8Bit(std::strerror(errno)));
+}
+
+LinuxSerialTransport::LinuxSerialTransport(const QString &portName, int baudRate, QObject *parent)
+    : GrblTransport(parent)
+    , portName(portName)
+    , baudRate(baudRate)
+    , fd(-1)
+    , epollFd(-1)
+    , notifier(nullptr)
+    , lowLatency(false)
+{
+}
+
+LinuxSerialTransport::~LinuxSerialTransport()
+{
+    close();
+}
+
+bool LinuxSerialTransport::open()
+{
+    if (fd != -1) {
+        return true;
+    }
+    clearReceived();
+    pendingWrite.clear();
+    
+    // QSerialPort gibi kısa adları da kabul et ("ttyUSB0" -> /dev/ttyUSB0)
+    QString path = portName.startsWith('/') ? portName : "/dev/" + portName;
+    fd = ::open(QFile::encodeName(path).constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) {
+        setErrorString(systemError(path));
+        return false;
+    }
+    
+    if (!configureTermios()) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    enableLowLatency();
+    
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epollFd == -1 || epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        setErrorString(systemError("epoll"));
+        close();
+        return false;
+    }
+    
+    // epoll tanımlayıcısı, kayıtlı olaylardan biri hazır olduğunda okunabilir olur
+    notifier = new QSocketNotifier(epollFd, QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &LinuxSerialTransport::handleEpollReady);
+    
+    emit opened();
+    return true;
+}
+
+void LinuxSerialTransport::close()
+{
+    if (fd == -1) {
+        return;
+    }
+    
+    // close() notifier'ın kendi sinyali içinden de çağrılabilir (hata -> bağlantı kesme)
+    if (notifier) {
+        notifier->setEnabled(false);
+        notifier->deleteLater();
+        notifier = nullptr;
+    }
+    if (epollFd != -1) {
+        ::close(epollFd);
+        epollFd = -1;
+    }
+    ::close(fd);
+    fd = -1;
+    pendingWrite.clear();
+    emit closed();
+}
+
+bool LinuxSerialTransport::isOpen() const
+{
+    return fd != -1;
+}
+
+qint64 LinuxSerialTransport::write(const QByteArray &data)
+{
+    if (fd == -1) {
+        return -1;
+    }
+    
+    // Sıralama korunmalı: bekleyen veri varken yeni veri arkasına eklenir
+    if (!pendingWrite.isEmpty()) {
+        pendingWrite.append(data);
+        return data.size();
+    }
+    
+    ssize_t written = ::write(fd, data.constData(), static_cast<size_t>(data.size()));
+    if (written < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            setErrorString(systemError("write"));
+            return -1;
+        }
+        written = 0;
+    }
+    if (written < data.size()) {
+        pendingWrite = data.mid(static_cast<int>(written));
+        updateEpollEvents();
+    }
+    return data.size();
+}
+
+QString LinuxSerialTransport::describe() const
+{
+    return QString("%1 @ %2 (termios%3)").arg(portName).arg(baudRate)
+        .arg(lowLatency ? QString(", low-latency") : QString());
+}
+
+bool LinuxSerialTransport::isLowLatencyEnabled() const
+{
+    return lowLatency;
+}
+
+void LinuxSerialTransport::handleEpollReady()
+{
+    epoll_event events[4];
+    int count = epoll_wait(epollFd, events, 4, 0);
+    if (count < 0) {
+        if (errno != EINTR) {
+            failAndClose(systemError("epoll_wait"));
+        }
+        return;
+    }
+    
+    for (int i = 0; i < count; ++i) {
+        if (events[i].events & EPOLLOUT) {
+            flushPendingWrite();
+            if (fd == -1) {
+                return;
+            }
+        }
+        if (events[i].events & EPOLLIN) {
+            // Tek uyanışta çekirdekteki her şeyi al; satırlar GrblTransport'ta bölünür
+            QByteArray received;
+            char buffer[4096];
+            ssize_t bytes;
+            while ((bytes = ::read(fd, buffer, sizeof(buffer))) > 0) {
+                received.append(buffer, static_cast<int>(bytes));
+            }
+            bool hungUp = bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+            appendReceived(received);
+            if (fd == -1) {
+                return; // Yanıt işlenirken bağlantı kapatıldı
+            }
+            if (hungUp) {
+                failAndClose("Seri port bağlantısı kesildi");
+                return;
+            }
+        } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+            failAndClose("Seri port bağlantısı kesildi");
+            return;
+        }
+    }
+}
+
+bool LinuxSerialTransport::configureTermios()
+{
+    speed_t speed = baudRateConstant(baudRate);
+    if (speed == B0) {
+        setErrorString(QString("Desteklenmeyen baud hızı: %1").arg(baudRate));
+        return false;
+    }
+    
+    termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        setErrorString(systemError("tcgetattr"));
+        return false;
+    }
+    
+    // Ham mod, 8N1, akış kontrolü yok. VMIN=1/VTIME=0: ilk bayt gelir gelmez okunabilir
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS | PARENB | CSIZE);
+    tio.c_cflag |= CS8;
+    tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        setErrorString(systemError("tcsetattr"));
+        return false;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return true;
+}
+
+void LinuxSerialTransport::enableLowLatency()
+{
+    serial_struct serial;
+    std::memset(&serial, 0, sizeof(serial));
+    lowLatency = ioctl(fd, TIOCGSERIAL, &serial) == 0;
+    if (lowLatency) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        lowLatency = ioctl(fd, TIOCSSERIAL, &serial) == 0;
+    }
+    
+    // FTDI köprüleri varsayılan 16 ms gecikme zamanlayıcısı kullanır; yazılabiliyorsa 1 ms
+    QString device = QFileInfo(QFileInfo(portName.startsWith('/') ? portName : "/dev/" + portName)
+                               .canonicalFilePath()).fileName();
+    QFile latencyTimer(QString("/sys/bus/usb-serial/devices/%1/latency_timer").arg(device));
+    if (latencyTimer.exists() && latencyTimer.open(QIODevice::WriteOnly)) {
+        latencyTimer.write("1");
+    }
+}
+
+void LinuxSerialTransport::flushPendingWrite()
+{
+    while (!pendingWrite.isEmpty()) {
+        ssize_t written = ::write(fd, pendingWrite.constData(), static_cast<size_t>(pendingWrite.size()));
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            failAndClose(systemError("write"));
+            return;
+        }
+        pendingWrite.remove(0, static_cast<int>(written));
+    }
+    updateEpollEvents();
+}
+
+void LinuxSerialTransport::updateEpollEvents()
+{
+    epoll_event event = {};
+    event.events = EPOLLIN | (pendingWrite.isEmpty() ? 0u : static_cast<uint32_t>(EPOLLOUT));
+    event.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+}
+
+void LinuxSerialTransport::failAndClose(const QString &error)
+{
+    setErrorString(error);
+    emit errorOccurred(error);
+    close();
+}
+#endif
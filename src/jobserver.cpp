@@ -0,0 +1,433 @@
+#include "jobserver.h"
+#include "logger.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+JobServer::JobServer(QObject *parent)
+    : QObject(parent)
+    , server(new QLocalServer(this))
+    , manager(new MachineManager(this))
+{
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, &QLocalServer::newConnection, this, &JobServer::handleNewConnection);
+}
+
+JobServer::~JobServer()
+{
+    close();
+    manager->shutdown();
+}
+
+bool JobServer::listen(const QString &socketName)
+{
+    // Önceki çalışmadan kalan soket dosyası listen'i engeller
+    QLocalServer::removeServer(socketName);
+    if (!server->listen(socketName)) {
+        Logger::instance()->error(QString("İş sunucusu başlatılamadı: %1").arg(server->errorString()));
+        return false;
+    }
+    Logger::instance()->info(QString("İş sunucusu dinliyor: %1").arg(server->fullServerName()));
+    return true;
+}
+
+void JobServer::close()
+{
+    const QList<QLocalSocket *> clients = server->findChildren<QLocalSocket *>();
+    for (QLocalSocket *client : clients) {
+        client->disconnectFromServer();
+    }
+    subscribers.clear();
+    server->close();
+}
+
+bool JobServer::isListening() const
+{
+    return server->isListening();
+}
+
+QString JobServer::getServerPath() const
+{
+    return server->fullServerName();
+}
+
+QString JobServer::errorString() const
+{
+    return server->errorString();
+}
+
+MachineManager *JobServer::getMachineManager()
+{
+    return manager;
+}
+
+bool JobServer::addMachineFromSpec(const QString &spec, QString *error)
+{
+    const int separator = spec.indexOf('=');
+    if (separator <= 0 || separator == spec.size() - 1) {
+        if (error) {
+            *error = QString("Geçersiz makine tanımı: %1").arg(spec);
+        }
+        return false;
+    }
+    
+    const QString name = spec.left(separator).trimmed();
+    const QString target = spec.mid(separator + 1).trimmed();
+    QString portName;
+    QString host;
+    int baudRate = 115200;
+    quint16 tcpPort = 23;
+    
+    if (target.startsWith("tcp:")) {
+        const QString address = target.mid(4);
+        const int colon = address.lastIndexOf(':');
+        host = colon > 0 ? address.left(colon) : address;
+        if (colon > 0) {
+            tcpPort = static_cast<quint16>(address.mid(colon + 1).toUInt());
+        }
+    } else {
+        const int at = target.lastIndexOf('@');
+        portName = at > 0 ? target.left(at) : target;
+        if (at > 0) {
+            baudRate = target.mid(at + 1).toInt();
+        }
+    }
+    if ((host.isEmpty() && portName.isEmpty()) || baudRate <= 0 || tcpPort == 0) {
+        if (error) {
+            *error = QString("Geçersiz makine tanımı: %1").arg(spec);
+        }
+        return false;
+    }
+    
+    MachineSession *session = ensureMachine(name);
+    connectMachine(session, portName, baudRate, host, tcpPort);
+    return true;
+}
+
+void JobServer::handleNewConnection()
+{
+    while (QLocalSocket *client = server->nextPendingConnection()) {
+        client->setParent(server);
+        connect(client, &QLocalSocket::readyRead, this, &JobServer::handleClientReadyRead);
+        connect(client, &QLocalSocket::disconnected, this, &JobServer::handleClientDisconnected);
+    }
+}
+
+void JobServer::handleClientReadyRead()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+    if (!client) {
+        return;
+    }
+    
+    while (client->canReadLine()) {
+        const QByteArray line = client->readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+    
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+        QJsonObject response;
+        if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+            response["ok"] = false;
+            response["error"] = QString("Geçersiz JSON: %1").arg(parseError.errorString());
+        } else {
+            const QJsonObject request = document.object();
+            response = handleRequest(request, client);
+            if (request.contains("id")) {
+                response["id"] = request.value("id");
+            }
+        }
+        sendJson(client, response);
+    }
+    
+    // Satır sonu gelmeden büyüyen tampon: bozuk veya kötü niyetli istemci
+    if (client->bytesAvailable() > MAX_REQUEST_BYTES) {
+        Logger::instance()->warning("İş sunucusu: istek sınırı aşıldı, istemci kapatılıyor");
+        client->disconnectFromServer();
+    }
+}
+
+void JobServer::handleClientDisconnected()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+    if (!client) {
+        return;
+    }
+    subscribers.remove(client);
+    client->deleteLater();
+}
+
+void JobServer::handleSnapshotChanged(const QString &name)
+{
+    // Bildirim bayrağı yalnızca okumayla temizlenir: kuyruk boş ve abone yokken de
+    // okunmazsa sonraki değişiklikler hiç bildirilmez, sonradan abone olan istemci
+    // status olayı alamaz
+    if (MachineSession *session = manager->getMachine(name)) {
+        session->getSnapshot();
+    }
+    
+    // Kuyruk ilerlemesi aboneler olmasa da yapılmalı
+    startNextJob(name);
+    if (subscribers.isEmpty()) {
+        return;
+    }
+    QJsonObject event;
+    event["event"] = "status";
+    event["machine"] = machineToJson(name);
+    broadcast(event);
+}
+
+void JobServer::handleJobFinished(const QString &name, bool success)
+{
+    const QString file = runningJobs.take(name);
+    Logger::instance()->info(QString("%1: iş %2 (%3)").arg(name, QString(success ? "tamamlandı" : "başarısız"), file));
+    
+    QJsonObject event;
+    event["event"] = "jobFinished";
+    event["machine"] = name;
+    event["file"] = file;
+    event["success"] = success;
+    broadcast(event);
+    
+    startNextJob(name);
+}
+
+void JobServer::handleMachineError(const QString &name, const QString &error)
+{
+    QJsonObject event;
+    event["event"] = "error";
+    event["machine"] = name;
+    event["error"] = error;
+    broadcast(event);
+}
+
+QJsonObject JobServer::handleRequest(const QJsonObject &request, QLocalSocket *client)
+{
+    QJsonObject response;
+    const QString command = request.value("cmd").toString();
+    const QString name = request.value("machine").toString();
+    MachineSession *session = manager->getMachine(name);
+    
+    auto fail = [&response](const QString &error) {
+        response["ok"] = false;
+        response["error"] = error;
+        return response;
+    };
+    
+    if (command == "ping") {
+        response["version"] = QCoreApplication::applicationVersion();
+    } else if (command == "status" || command == "machines") {
+        if (!name.isEmpty()) {
+            if (!session) {
+                return fail(QString("Bilinmeyen makine: %1").arg(name));
+            }
+            response["machine"] = machineToJson(name);
+        } else {
+            QJsonArray machines;
+            const QStringList names = manager->getMachineNames();
+            for (const QString &machineName : names) {
+                machines.append(machineToJson(machineName));
+            }
+            response["machines"] = machines;
+        }
+    } else if (command == "subscribe") {
+        if (request.value("enabled").toBool(true)) {
+            subscribers.insert(client);
+        } else {
+            subscribers.remove(client);
+        }
+    } else if (command == "connect") {
+        if (name.isEmpty()) {
+            return fail("Makine adı gerekli");
+        }
+        const QString portName = request.value("port").toString();
+        const QString host = request.value("host").toString();
+        if (portName.isEmpty() == host.isEmpty()) {
+            return fail("\"port\" veya \"host\" alanlarından biri gerekli");
+        }
+        session = ensureMachine(name);
+        connectMachine(session, portName, request.value("baud").toInt(115200),
+                       host, static_cast<quint16>(request.value("tcpPort").toInt(23)));
+    } else if (command == "remove") {
+        if (!session) {
+            return fail(QString("Bilinmeyen makine: %1").arg(name));
+        }
+        jobQueues.remove(name);
+        runningJobs.remove(name);
+        manager->removeMachine(name);
+    } else if (!session) {
+        return fail(command.isEmpty() ? QString("\"cmd\" alanı gerekli")
+                                      : QString("Bilinmeyen makine: %1").arg(name));
+    } else if (command == "disconnect") {
+        QMetaObject::invokeMethod(session, [session]() { session->disconnectFromDevice(); });
+    } else if (command == "queue") {
+        const QFileInfo info(request.value("file").toString());
+        if (!info.isFile() || !info.isReadable()) {
+            return fail(QString("Dosya okunamıyor: %1").arg(info.filePath()));
+        }
+        QQueue<QueuedJob> &queue = jobQueues[name];
+        queue.enqueue({info.absoluteFilePath(), request.value("check").toBool() ? JobMode::Check : JobMode::Run});
+        response["position"] = queue.size();
+        startNextJob(name);
+    } else if (command == "clear") {
+        response["removed"] = jobQueues.value(name).size();
+        jobQueues.remove(name);
+    } else if (command == "pause") {
+        QMetaObject::invokeMethod(session, [session]() { session->pauseJob(); });
+    } else if (command == "hold") {
+        QMetaObject::invokeMethod(session, [session]() { session->feedHold(); });
+    } else if (command == "resume") {
+        QMetaObject::invokeMethod(session, [session]() { session->resumeJob(); });
+    } else if (command == "stop") {
+        // Kuyruk da durdurulur; aksi halde bir sonraki iş hemen başlardı
+        response["removed"] = jobQueues.value(name).size();
+        jobQueues.remove(name);
+        QMetaObject::invokeMethod(session, [session]() { session->stopJob(); });
+    } else if (command == "send") {
+        const QString line = request.value("line").toString().trimmed();
+        if (line.isEmpty()) {
+            return fail("\"line\" alanı gerekli");
+        }
+        QMetaObject::invokeMethod(session, [session, line]() { session->sendCommand(line); });
+    } else {
+        return fail(QString("Bilinmeyen komut: %1").arg(command));
+    }
+    
+    response["ok"] = true;
+    return response;
+}
+
+MachineSession *JobServer::ensureMachine(const QString &name)
+{
+    MachineSession *session = manager->getMachine(name);
+    if (session) {
+        return session;
+    }
+    
+    session = manager->addMachine(name);
+    connect(session, &MachineSession::snapshotChanged, this, &JobServer::handleSnapshotChanged);
+    connect(session, &MachineSession::jobFinished, this, &JobServer::handleJobFinished);
+    connect(session, &MachineSession::errorOccurred, this, &JobServer::handleMachineError);
+    return session;
+}
+
+void JobServer::connectMachine(MachineSession *session, const QString &portName, int baudRate,
+                               const QString &host, quint16 tcpPort)
+{
+    if (!host.isEmpty()) {
+        QMetaObject::invokeMethod(session, [session, host, tcpPort]() {
+            session->connectToHost(host, tcpPort);
+        });
+    } else {
+        QMetaObject::invokeMethod(session, [session, portName, baudRate]() {
+            session->connectToDevice(portName, baudRate);
+        });
+    }
+}
+
+void JobServer::startNextJob(const QString &name)
+{
+    MachineSession *session = manager->getMachine(name);
+    if (!session || runningJobs.contains(name) || jobQueues.value(name).isEmpty()) {
+        return;
+    }
+    
+    const MachineSnapshot snapshot = session->getSnapshot();
+    if (!snapshot.connected || snapshot.jobState != JobState::Idle || snapshot.pendingCommands > 0) {
+        return;
+    }
+    
+    QQueue<QueuedJob> &queue = jobQueues[name];
+    const QueuedJob job = queue.dequeue();
+    if (queue.isEmpty()) {
+        jobQueues.remove(name);
+    }
+    runningJobs.insert(name, job.filePath);
+    Logger::instance()->info(QString("%1: %2 başlatılıyor: %3")
+                             .arg(name, QString(job.mode == JobMode::Check ? "kontrol" : "iş"), job.filePath));
+    QMetaObject::invokeMethod(session, [session, job]() { session->startJob(job.filePath, job.mode); });
+}
+
+QJsonObject JobServer::machineToJson(const QString &name) const
+{
+    QJsonObject machine;
+    machine["name"] = name;
+    MachineSession *session = manager->getMachine(name);
+    if (!session) {
+        return machine;
+    }
+    
+    const MachineSnapshot snapshot = session->getSnapshot();
+    machine["connected"] = snapshot.connected;
+    machine["transport"] = snapshot.transport;
+    machine["state"] = snapshot.status.state;
+    machine["mpos"] = QJsonArray({snapshot.status.mposX, snapshot.status.mposY, snapshot.status.mposZ});
+    machine["wpos"] = QJsonArray({snapshot.status.wposX, snapshot.status.wposY, snapshot.status.wposZ});
+    machine["feed"] = snapshot.status.feedRate;
+    machine["spindle"] = snapshot.status.spindleSpeed;
+    machine["pendingCommands"] = snapshot.pendingCommands;
+    
+    QJsonObject job;
+    job["state"] = jobStateName(snapshot.jobState);
+    job["file"] = runningJobs.value(name);
+    job["lines"] = snapshot.linesCompleted;
+    job["percent"] = snapshot.progressPercent;
+    job["errors"] = snapshot.jobErrors;
+    job["mode"] = jobModeName(snapshot.jobMode);
+    job["linesPerSecond"] = snapshot.linesPerSecond;
+    machine["job"] = job;
+    
+    QJsonArray queue;
+    for (const QueuedJob &queued : jobQueues.value(name)) {
+        queue.append(queued.filePath);
+    }
+    machine["queue"] = queue;
+    return machine;
+}
+
+void JobServer::broadcast(const QJsonObject &event)
+{
+    for (QLocalSocket *client : std::as_const(subscribers)) {
+        // Okumayan istemci için olaylar bırakılır; sunucu belleği sınırsız büyümez
+        if (client->bytesToWrite() > MAX_PENDING_EVENT_BYTES) {
+            continue;
+        }
+        sendJson(client, event);
+    }
+}
+
+void JobServer::sendJson(QLocalSocket *socket, const QJsonObject &object)
+{
+    if (socket->state() != QLocalSocket::ConnectedState) {
+        return;
+    }
+    socket->write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    socket->write("\n");
+}
+
+QString JobServer::jobStateName(JobState state)
+{
+    switch (state) {
+        case JobState::Idle:
+            return "idle";
+        case JobState::Running:
+            return "running";
+        case JobState::Paused:
+            return "paused";
+        case JobState::FeedHold:
+            return "hold";
+        case JobState::Stopping:
+            return "stopping";
+    }
+    return "unknown";
+}
+
+QString JobServer::jobModeName(JobMode mode)
+{
+    return mode == JobMode::Check ? "check" : "run";
+}
@@ -0,0 +1,487 @@
+#include "jobstreamer.h"
+#include "logger.h"
+#include <QBuffer>
+#include <QFile>
+
+JobStreamer::JobStreamer(SerialCommunication *serial, QObject *parent)
+    : QObject(parent)
+    , serialComm(serial)
+    , source(nullptr)
+    , state(JobState::Idle)
+    , mode(JobMode::Run)
+    , checkPhase(CheckPhase::None)
+    , checkModeOwned(false)
+    , finishedElapsedMs(0)
+    , totalBytes(0)
+    , bytesRead(0)
+    , completedOffset(0)
+    , nextLineNumber(1)
+    , firstLineNumber(1)
+    , currentLine(0)
+    , linesCompleted(0)
+    , errorCount(0)
+    , prefetchLimit(256)
+    , queueDepth(4)   // Ack gelince pencere hemen dolsun, duraklatma gecikmesin
+    , stopOnError(false)
+    , sourceExhausted(true)
+{
+    connect(serialComm, &SerialCommunication::commandResolved, this, &JobStreamer::handleCommandResolved);
+    connect(serialComm, &SerialCommunication::statusReportReceived, this, &JobStreamer::handleStatusReport);
+    connect(serialComm, &SerialCommunication::dataReceived, this, &JobStreamer::handleDataReceived);
+    connect(serialComm, &SerialCommunication::disconnected, this, &JobStreamer::handleDisconnected);
+}
+
+JobStreamer::~JobStreamer()
+{
+    closeSource();
+}
+
+bool JobStreamer::startFile(const QString &filePath, int firstLine, JobMode jobMode)
+{
+    QFile *file = new QFile(filePath, this);
+    if (!file->open(QIODevice::ReadOnly)) {
+        LOG_ERROR("İş dosyası açılamadı: " + filePath, LogCategories::GCODE);
+        delete file;
+        return false;
+    }
+    
+    return startSource(file, firstLine, jobMode);
+}
+
+bool JobStreamer::startText(const QString &program, int firstLine, JobMode jobMode)
+{
+    QBuffer *buffer = new QBuffer(this);
+    buffer->setData(program.toUtf8());
+    buffer->open(QIODevice::ReadOnly);
+    return startSource(buffer, firstLine, jobMode);
+}
+
+bool JobStreamer::startSource(QIODevice *device, int firstLine, JobMode jobMode)
+{
+    if (isActive() || !serialComm->isConnected()) {
+        delete device;
+        return false;
+    }
+    
+    closeSource();
+    source = device;
+    totalBytes = device->size();
+    bytesRead = 0;
+    completedOffset = 0;
+    nextLineNumber = 1;
+    firstLineNumber = qMax(firstLine, 1);
+    currentLine = 0;
+    linesCompleted = 0;
+    errorCount = 0;
+    sourceExhausted = false;
+    prefetch.clear();
+    sentLines.clear();
+    lineErrors.clear();
+    mode = jobMode;
+    checkPhase = CheckPhase::None;
+    checkModeOwned = false;
+    finishedElapsedMs = -1;
+    jobClock.start();
+    
+    LOG_INFO(QString("%1 başlatıldı (%2 bayt, satır %3'den)")
+             .arg(QString(mode == JobMode::Check ? "Kontrol (check modu)" : "İş"))
+             .arg(totalBytes).arg(firstLineNumber), LogCategories::GCODE);
+    serialComm->addTrafficMarker(QString("job %1 %2 bytes")
+                                 .arg(QString(mode == JobMode::Check ? "check" : "start")).arg(totalBytes));
+    setState(JobState::Running);
+    if (mode == JobMode::Check) {
+        enterCheckMode();
+        return true;
+    }
+    pump();
+    return true;
+}
+
+void JobStreamer::enterCheckMode()
+{
+    // Kontrolcü zaten check modundaysa $C onu kapatırdı (ve reset atardı)
+    if (serialComm->getLastStatusReport().state == "Check") {
+        checkPhase = CheckPhase::Streaming;
+        pump();
+        return;
+    }
+    
+    // $C iş şeridinden gider: program satırları ondan önce yazılamaz
+    checkPhase = CheckPhase::Entering;
+    serialComm->sendCommandAsync("$C", CommandLane::Job).then(this, [this](const CommandResult &result) {
+        if (checkPhase != CheckPhase::Entering) {
+            return; // İş bu arada durduruldu
+        }
+        if (!result.isOk() || !result.data.contains("[MSG:Enabled]")) {
+            QString error = result.response.isEmpty() ? QString("yanıt yok") : result.response;
+            LOG_ERROR("Check moduna geçilemedi: " + error, LogCategories::GCODE);
+            errorCount++;
+            emit lineFailed(0, "$C", error);
+            finishJob(false);
+            return;
+        }
+        checkModeOwned = true;
+        checkPhase = CheckPhase::Streaming;
+        pump();
+    });
+}
+
+void JobStreamer::leaveCheckMode()
+{
+    checkPhase = CheckPhase::Leaving;
+    serialComm->sendCommandAsync("$C", CommandLane::Job).then(this, [this](const CommandResult &result) {
+        if (checkPhase != CheckPhase::Leaving) {
+            return;
+        }
+        checkModeOwned = false;
+        if (!result.isOk()) {
+            LOG_WARNING("Check modundan çıkılamadı: " + result.response, LogCategories::GCODE);
+        }
+        finishJob(errorCount == 0 && result.isOk());
+    });
+}
+
+void JobStreamer::pause()
+{
+    // Kontrolcüdeki ve kuyruktaki satırlar işlenmeye devam eder
+    if (state == JobState::Running) {
+        setState(JobState::Paused);
+    }
+}
+
+void JobStreamer::feedHold()
+{
+    if (state == JobState::Running || state == JobState::Paused) {
+        serialComm->sendFeedHold();
+        setState(JobState::FeedHold);
+    }
+}
+
+void JobStreamer::resume()
+{
+    if (state == JobState::FeedHold) {
+        serialComm->sendCycleStart();
+    } else if (state != JobState::Paused) {
+        return;
+    }
+    
+    setState(JobState::Running);
+    pump();
+}
+
+void JobStreamer::stop()
+{
+    if (!isActive() || state == JobState::Stopping) {
+        return;
+    }
+    
+    // Aşağıdaki iptaller handleCommandResolved'da iş hatası sayılmasın
+    setState(JobState::Stopping);
+    serialComm->clearPendingCommands(CommandLane::Job);
+    
+    // Hareket sürerken reset konum kaybına (alarm) yol açar: önce hold.
+    // Check modunda hareket yoktur; reset aynı zamanda check modundan çıkarır.
+    GrblStatusReport report = serialComm->getLastStatusReport();
+    if (report.state.isEmpty() || report.state == "Idle" || report.state.startsWith("Alarm")
+        || report.state == "Check" || (report.state == "Hold" && report.subState == 0)) {
+        serialComm->sendSoftReset();
+        finishJob(false);
+        return;
+    }
+    
+    serialComm->sendFeedHold();
+}
+
+JobState JobStreamer::getState() const
+{
+    return state;
+}
+
+JobMode JobStreamer::getMode() const
+{
+    return mode;
+}
+
+bool JobStreamer::isActive() const
+{
+    return state != JobState::Idle;
+}
+
+qint64 JobStreamer::getCurrentLine() const
+{
+    return currentLine;
+}
+
+qint64 JobStreamer::getLinesCompleted() const
+{
+    return linesCompleted;
+}
+
+qint64 JobStreamer::getErrorCount() const
+{
+    return errorCount;
+}
+
+int JobStreamer::getProgressPercent() const
+{
+    if (totalBytes <= 0) {
+        return 0;
+    }
+    return static_cast<int>(100 * completedOffset / totalBytes);
+}
+
+qint64 JobStreamer::getElapsedMs() const
+{
+    if (finishedElapsedMs >= 0) {
+        return finishedElapsedMs;
+    }
+    return jobClock.isValid() ? jobClock.elapsed() : 0;
+}
+
+double JobStreamer::getLinesPerSecond() const
+{
+    qint64 elapsed = getElapsedMs();
+    return elapsed > 0 ? linesCompleted * 1000.0 / elapsed : 0.0;
+}
+
+QVector<JobLineError> JobStreamer::getLineErrors() const
+{
+    return lineErrors;
+}
+
+void JobStreamer::setPrefetchLines(int lines)
+{
+    prefetchLimit = qMax(lines, 1);
+}
+
+void JobStreamer::setQueueDepth(int lines)
+{
+    queueDepth = qMax(lines, 1);
+}
+
+void JobStreamer::setStopOnError(bool enabled)
+{
+    stopOnError = enabled;
+}
+
+void JobStreamer::handleCommandResolved(quint64 sequence, CommandStatus status, const QString &response)
+{
+    // Araya giren MDI/jog komutları iş satırı değildir. Yazma hatası bir grubu
+    // sondan geri aldığından satır kuyruğun başında olmayabilir.
+    int index = -1;
+    for (int i = 0; i < sentLines.size(); ++i) {
+        if (sentLines.at(i).sequence == sequence) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        return;
+    }
+    
+    SentLine resolved = sentLines.takeAt(index);
+    const PrefetchedLine &line = resolved.line;
+    
+    if (status == CommandStatus::Cancelled) {
+        // stop() kendi iptallerini Stopping durumunda yapar; başka bir iptal
+        // (dışarıdan kuyruk temizleme, soft reset) programdan satır düşürmüş demektir
+        if (state != JobState::Stopping) {
+            recordLineError(line, response);
+            finishJob(false);
+            serialComm->clearPendingCommands(CommandLane::Job);
+        }
+        return;
+    }
+    
+    if (status != CommandStatus::Ok) {
+        recordLineError(line, status == CommandStatus::Timeout ? QString("Zaman aşımı") : response);
+        if (status == CommandStatus::Rejected) {
+            finishJob(false); // Port yazılamıyor: kalan satırlar da gidemez
+            return;
+        }
+    }
+    
+    linesCompleted++;
+    currentLine = line.lineNumber;
+    completedOffset = line.endOffset;
+    emit progressChanged(linesCompleted, getProgressPercent());
+    
+    if (status != CommandStatus::Ok && stopOnError && mode != JobMode::Check) {
+        stop();
+    }
+    pump();
+}
+
+void JobStreamer::recordLineError(const PrefetchedLine &line, const QString &error)
+{
+    errorCount++;
+    if (lineErrors.size() < MAX_RECORDED_ERRORS) {
+        lineErrors.append({line.lineNumber, line.text, error});
+    }
+    LOG_WARNING(QString("Satır %1 hata verdi: %2 (%3)").arg(line.lineNumber).arg(line.text, error),
+                LogCategories::GCODE);
+    emit lineFailed(line.lineNumber, line.text, error);
+}
+
+void JobStreamer::handleStatusReport(const GrblStatusReport &report)
+{
+    // Durdurma: hold tamamlanınca reset planlayıcıyı güvenle boşaltır
+    if (state == JobState::Stopping
+        && ((report.state == "Hold" && report.subState == 0) || report.state == "Idle"
+            || report.state.startsWith("Alarm"))) {
+        serialComm->sendSoftReset();
+        finishJob(false);
+        return;
+    }
+    
+    // Check modunda alarm (örn. soft limit) GRBL'i resetler ve moddan çıkarır
+    if (mode == JobMode::Check && checkPhase == CheckPhase::Streaming && report.state.startsWith("Alarm")) {
+        abortAfterControllerReset("kontrol alarmla kesildi");
+        return;
+    }
+    
+    // İş sırasında alarm (örn. hard limit): GRBL yoldaki satırları attı, kalanlar
+    // error:9 ile döner. $X sonrası programın ortasından devam etmek konum ve modal
+    // durum kaybı demektir; iş sonlandırılır.
+    if (mode == JobMode::Run && isActive() && report.state.startsWith("Alarm")) {
+        abortAfterControllerReset("alarm");
+    }
+}
+
+void JobStreamer::handleDataReceived(const QString &line)
+{
+    // Kendiliğinden reset banner'ı (reset düğmesi, ESP32 yeniden başlaması). Check
+    // modundan çıkan $C da reset atar; o banner beklenen bir yanıttır.
+    if (line.startsWith("Grbl ") && isActive() && checkPhase != CheckPhase::Leaving) {
+        abortAfterControllerReset("kontrolcü resetlendi");
+    }
+}
+
+void JobStreamer::abortAfterControllerReset(const QString &reason)
+{
+    LOG_WARNING(QString("İş kesildi: %1").arg(reason), LogCategories::GCODE);
+    checkModeOwned = false;
+    finishJob(false);   // Önce: temizlenen satırların iptalleri artık iş satırı değil
+    serialComm->clearPendingCommands(CommandLane::Job);
+}
+
+void JobStreamer::handleDisconnected()
+{
+    if (isActive()) {
+        LOG_WARNING("Bağlantı kesildi, iş yarıda kaldı", LogCategories::GCODE);
+        finishJob(false);
+    }
+}
+
+void JobStreamer::fillPrefetch()
+{
+    while (prefetch.size() < prefetchLimit && !sourceExhausted) {
+        if (source->atEnd()) {
+            sourceExhausted = true;
+            break;
+        }
+        
+        QByteArray raw = source->readLine();
+        bytesRead += raw.size();
+        qint64 lineNumber = nextLineNumber++;
+        if (lineNumber < firstLineNumber) {
+            continue;
+        }
+        
+        QString text = QString::fromUtf8(raw).trimmed();
+        if (isExecutableLine(text)) {
+            prefetch.enqueue({lineNumber, text, bytesRead});
+        }
+    }
+}
+
+void JobStreamer::pump()
+{
+    if (state != JobState::Running || checkPhase == CheckPhase::Entering || checkPhase == CheckPhase::Leaving) {
+        return;
+    }
+    
+    fillPrefetch();
+    
+    // Kuyrukta az satır tut: pencere ack'lerle dolar, duraklatma hızlı etkiler.
+    // Check modunda hareket yoktur, ok'lar hat hızında gelir: daha derin kuyruk.
+    int depth = (mode == JobMode::Check) ? qMax(queueDepth, CHECK_QUEUE_DEPTH) : queueDepth;
+    while (!prefetch.isEmpty() && serialComm->getLaneDepth(CommandLane::Job) < depth) {
+        PrefetchedLine line = prefetch.dequeue();
+        bool sent = serialComm->sendCommand(line.text, CommandLane::Job);
+        if (state != JobState::Running) {
+            return; // Aynı yazımda önceki satırlar reddedildi, iş bitirildi
+        }
+        // Yazma hatası satırı sendCommand dönmeden sonuçlandırmış olabilir
+        quint64 sequence = serialComm->getLastQueuedSequence();
+        if (!sent || !serialComm->isCommandPending(sequence)) {
+            errorCount++;
+            emit lineFailed(line.lineNumber, line.text, "Gönderilemedi");
+            finishJob(false);
+            return;
+        }
+        sentLines.enqueue({sequence, line});
+        fillPrefetch();
+    }
+    
+    if (sourceExhausted && prefetch.isEmpty() && sentLines.isEmpty()) {
+        if (mode == JobMode::Check && checkModeOwned) {
+            leaveCheckMode();
+            return;
+        }
+        finishJob(errorCount == 0);
+    }
+}
+
+void JobStreamer::finishJob(bool success)
+{
+    closeSource();
+    prefetch.clear();
+    sentLines.clear();
+    sourceExhausted = true;
+    checkPhase = CheckPhase::None;
+    checkModeOwned = false;
+    finishedElapsedMs = jobClock.isValid() ? jobClock.elapsed() : 0;
+    
+    LOG_INFO(QString("%1 %2: %3 satır, %4 hata, %5 satır/s")
+             .arg(QString(mode == JobMode::Check ? "Kontrol" : "İş"))
+             .arg(success ? "tamamlandı" : "durduruldu")
+             .arg(linesCompleted).arg(errorCount)
+             .arg(getLinesPerSecond(), 0, 'f', 1), LogCategories::GCODE);
+    
+    serialComm->addTrafficMarker(QString("job %1 lines=%2 errors=%3")
+                                 .arg(success ? "done" : "stopped").arg(linesCompleted).arg(errorCount));
+    setState(JobState::Idle);
+    emit finished(success);
+}
+
+void JobStreamer::closeSource()
+{
+    if (source) {
+        source->close();
+        source->deleteLater();
+        source = nullptr;
+    }
+}
+
+void JobStreamer::setState(JobState newState)
+{
+    if (state != newState) {
+        state = newState;
+        emit stateChanged(state);
+    }
+}
+
+bool JobStreamer::isExecutableLine(const QString &line)
+{
+    if (line.isEmpty() || line.startsWith(';') || line.startsWith('%')) {
+        return false;
+    }
+    
+    // Yalnızca yorumdan oluşan satır: "(...)"
+    if (line.startsWith('(') && line.endsWith(')') && line.count('(') == 1) {
+        return false;
+    }
+    
+    return true;
+}
@@ -0,0 +1,159 @@
+#include "jogcontroller.h"
+#include "logger.h"
+
+JogController::JogController(SerialCommunication *serial, QObject *parent)
+    : QObject(parent)
+    , serialComm(serial)
+    , jogAxis(' ')
+    , jogPositive(true)
+    , jogFeedRate(0.0)
+    , incrementDistance(0.0)
+    , acceleration(10.0)
+    , minIncrementTime(0.025) // Tek $J= satırının iletilip planlanma süresinin üstü
+    , jogging(false)
+{
+    connect(serialComm, &SerialCommunication::commandResolved, this, &JogController::handleCommandResolved);
+    connect(serialComm, &SerialCommunication::disconnected, this, &JogController::handleDisconnected);
+}
+
+bool JogController::start(char axis, bool positive, double feedRate)
+{
+    if (!serialComm->isConnected() || feedRate <= 0.0) {
+        return false;
+    }
+    
+    // Aynı yönde tekrar basma (tuş tekrarı) akışı bozmasın
+    if (jogging && axis == jogAxis && positive == jogPositive) {
+        return true;
+    }
+    if (jogging) {
+        stop();
+    }
+    
+    jogAxis = axis;
+    jogPositive = positive;
+    jogFeedRate = feedRate;
+    incrementDistance = (feedRate / 60.0) * calculateIncrementTime();
+    jogging = true;
+    
+    LOG_INFO(QString("Sürekli jog: %1%2 F%3, artım %4 mm")
+             .arg(axis).arg(positive ? "+" : "-").arg(feedRate).arg(incrementDistance, 0, 'f', 3),
+             LogCategories::AXIS);
+    
+    emit jogStarted(axis, positive);
+    sendIncrements();
+    return true;
+}
+
+void JogController::stop()
+{
+    if (!jogging) {
+        return;
+    }
+    
+    jogging = false;
+    outstanding.clear();
+    
+    // Yazılmamış jog satırlarını at; kontrolcüdekileri jog cancel boşaltır
+    serialComm->clearPendingCommands(CommandLane::Jog);
+    serialComm->sendJogCancel();
+    emit jogStopped();
+}
+
+bool JogController::isJogging() const
+{
+    return jogging;
+}
+
+void JogController::setAcceleration(double mmPerSec2)
+{
+    if (mmPerSec2 > 0.0) {
+        acceleration = mmPerSec2;
+    }
+}
+
+double JogController::getAcceleration() const
+{
+    return acceleration;
+}
+
+void JogController::setMinIncrementTime(double seconds)
+{
+    minIncrementTime = qMax(seconds, 0.001);
+}
+
+double JogController::getIncrementDistance() const
+{
+    return incrementDistance;
+}
+
+double JogController::calculateIncrementTime() const
+{
+    // Kontrolcü ayarları okunduysa eksenin gerçek ivmesi ve hız sınırı kullanılır
+    const ControllerSettings &settings = serialComm->getControllerSettings();
+    double axisAcceleration = settings.getAcceleration(jogAxis);
+    if (axisAcceleration <= 0.0) {
+        axisAcceleration = acceleration;
+    }
+    double maxRate = settings.getMaxRate(jogAxis);
+    double feed = (maxRate > 0.0) ? qMin(jogFeedRate, maxRate) : jogFeedRate;
+    
+    double v = feed / 60.0; // mm/s
+    int blocks = qMax(serialComm->getPlannerBlockCount(), 2);
+    double dt = (v * v) / (2.0 * axisAcceleration * (blocks - 1));
+    
+    // Satırın gidip ok dönmesi artımdan uzun sürerse planlayıcı boşalır
+    const LatencyHistogram &ack = serialComm->getAckLatencyHistogram();
+    if (ack.count() > 0) {
+        dt = qMax(dt, ack.percentile(90.0) / 1e6);
+    }
+    
+    return qMax(dt, minIncrementTime);
+}
+
+void JogController::sendIncrements()
+{
+    while (jogging && outstanding.size() < MAX_OUTSTANDING) {
+        double distance = jogPositive ? incrementDistance : -incrementDistance;
+        bool sent = serialComm->sendJogCommand(jogAxis, distance, jogFeedRate);
+        if (!jogging) {
+            return; // Aynı yazımda önceki artım reddedildi
+        }
+        // Yazma hatası satırı sendJogCommand dönmeden sonuçlandırmış olabilir
+        quint64 sequence = serialComm->getLastQueuedSequence();
+        if (!sent || !serialComm->isCommandPending(sequence)) {
+            stop();
+            return;
+        }
+        outstanding.enqueue(sequence);
+    }
+}
+
+void JogController::handleCommandResolved(quint64 sequence, CommandStatus status, const QString &response)
+{
+    int index = outstanding.indexOf(sequence);
+    if (index < 0) {
+        return;
+    }
+    outstanding.removeAt(index);
+    
+    if (status == CommandStatus::Ok) {
+        sendIncrements();
+        return;
+    }
+    
+    // Örn. error:15 (jog soft limit dışına çıkıyor), zaman aşımı veya yazma hatası.
+    // Dışarıdan iptal (soft reset, kuyruk temizleme) hata değildir ama jog biter.
+    if (status != CommandStatus::Cancelled) {
+        QString error = (status == CommandStatus::Timeout) ? QString("Zaman aşımı") : response;
+        LOG_WARNING("Jog reddedildi: " + error, LogCategories::AXIS);
+        emit jogError(error);
+    }
+    stop();
+}
+
+void JogController::handleDisconnected()
+{
+    jogging = false;
+    outstanding.clear();
+}
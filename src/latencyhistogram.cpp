@@ -0,0 +1,134 @@
+#include "latencyhistogram.h"
+#include <QtAlgorithms>
+#include <cmath>
+#include <limits>
+
+LatencyHistogram::LatencyHistogram()
+    : counts(bucketIndex(std::numeric_limits<quint64>::max()) + 1, 0)
+    , totalCount(0)
+    , minValue(0)
+    , maxValue(0)
+    , sum(0.0)
+{
+}
+
+void LatencyHistogram::record(qint64 value)
+{
+    if (value < 0) {
+        value = 0;
+    }
+    
+    counts[bucketIndex(static_cast<quint64>(value))]++;
+    
+    if (totalCount == 0 || value < minValue) {
+        minValue = value;
+    }
+    if (value > maxValue) {
+        maxValue = value;
+    }
+    totalCount++;
+    sum += value;
+}
+
+void LatencyHistogram::reset()
+{
+    counts.fill(0);
+    totalCount = 0;
+    minValue = 0;
+    maxValue = 0;
+    sum = 0.0;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.totalCount == 0) {
+        return;
+    }
+    
+    for (int i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    
+    minValue = totalCount == 0 ? other.minValue : qMin(minValue, other.minValue);
+    maxValue = qMax(maxValue, other.maxValue);
+    totalCount += other.totalCount;
+    sum += other.sum;
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return totalCount;
+}
+
+qint64 LatencyHistogram::min() const
+{
+    return minValue;
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return maxValue;
+}
+
+double LatencyHistogram::mean() const
+{
+    return totalCount > 0 ? sum / totalCount : 0.0;
+}
+
+qint64 LatencyHistogram::percentile(double percent) const
+{
+    if (totalCount == 0) {
+        return 0;
+    }
+    
+    quint64 target = static_cast<quint64>(std::ceil(qBound(0.0, percent, 100.0) / 100.0 * totalCount));
+    target = qMax<quint64>(target, 1);
+    
+    quint64 cumulative = 0;
+    for (int i = 0; i < counts.size(); ++i) {
+        cumulative += counts[i];
+        if (cumulative >= target) {
+            // Kovanın üst sınırı gerçek maksimumu aşmasın
+            return qMin(static_cast<qint64>(bucketUpperBound(i)), maxValue);
+        }
+    }
+    
+    return maxValue;
+}
+
+QString LatencyHistogram::summary() const
+{
+    return QString("n=%1 min=%2 p50=%3 p90=%4 p99=%5 max=%6")
+        .arg(totalCount)
+        .arg(minValue)
+        .arg(percentile(50.0))
+        .arg(percentile(90.0))
+        .arg(percentile(99.0))
+        .arg(maxValue);
+}
+
+int LatencyHistogram::bucketIndex(quint64 value)
+{
+    // Küçük değerler birebir saklanır
+    if (value < SubBucketCount) {
+        return static_cast<int>(value);
+    }
+    
+    // Üstteki 5 biti koru: top değeri [16, 31] aralığında
+    int msb = 63 - qCountLeadingZeroBits(value);
+    int shift = msb - 4;
+    int top = static_cast<int>(value >> shift);
+    return SubBucketCount + (shift - 1) * HalfSubBucketCount + (top - HalfSubBucketCount);
+}
+
+quint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < SubBucketCount) {
+        return static_cast<quint64>(index);
+    }
+    
+    int k = index - SubBucketCount;
+    int shift = k / HalfSubBucketCount + 1;
+    quint64 top = static_cast<quint64>(k % HalfSubBucketCount + HalfSubBucketCount);
+    return ((top + 1) << shift) - 1;
+}
@@ -0,0 +1,534 @@
+#include "machinemanager.h"
+#include "gcodeparser.h"
+#include "logger.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QThread>
+#include <limits>
+
+// ---------------------------------------------------------------------------
+// ProgramCache
+// ---------------------------------------------------------------------------
+
+ProgramCache::ProgramCache(int maxEntries)
+    : maxEntries(qMax(1, maxEntries))
+    , useCounter(0)
+    , hits(0)
+    , misses(0)
+{
+}
+
+QSharedPointer<const ProgramSummary> ProgramCache::lookup(const QString &filePath)
+{
+    QFileInfo info(filePath);
+    if (!info.exists()) {
+        return QSharedPointer<const ProgramSummary>();
+    }
+    
+    QMutexLocker locker(&mutex);
+    auto it = entries.find(info.absoluteFilePath());
+    if (it == entries.end() || !isCurrent(*it->summary, info.size(), info.lastModified())) {
+        return QSharedPointer<const ProgramSummary>();
+    }
+    ++hits;
+    it->lastUse = ++useCounter;
+    return it->summary;
+}
+
+QSharedPointer<const ProgramSummary> ProgramCache::summarize(const QString &filePath)
+{
+    QFileInfo info(filePath);
+    if (!info.exists()) {
+        return QSharedPointer<const ProgramSummary>();
+    }
+    const QString key = info.absoluteFilePath();
+    
+    QMutexLocker locker(&mutex);
+    forever {
+        auto it = entries.find(key);
+        if (it != entries.end() && isCurrent(*it->summary, info.size(), info.lastModified())) {
+            ++hits;
+            it->lastUse = ++useCounter;
+            return it->summary;
+        }
+        if (!parsing.contains(key)) {
+            break;
+        }
+        // Başka bir oturum aynı dosyayı ayrıştırıyor; sonucunu bekle
+        parseFinished.wait(&mutex);
+    }
+    parsing.insert(key);
+    ++misses;
+    locker.unlock();
+    
+    QSharedPointer<const ProgramSummary> summary = parseFile(key);
+    
+    locker.relock();
+    parsing.remove(key);
+    if (summary) {
+        entries.insert(key, {summary, ++useCounter});
+        evictLocked();
+    }
+    parseFinished.wakeAll();
+    return summary;
+}
+
+void ProgramCache::invalidate(const QString &filePath)
+{
+    QMutexLocker locker(&mutex);
+    entries.remove(QFileInfo(filePath).absoluteFilePath());
+}
+
+void ProgramCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    entries.clear();
+}
+
+quint64 ProgramCache::getHitCount() const
+{
+    QMutexLocker locker(&mutex);
+    return hits;
+}
+
+quint64 ProgramCache::getMissCount() const
+{
+    QMutexLocker locker(&mutex);
+    return misses;
+}
+
+bool ProgramCache::isCurrent(const ProgramSummary &summary, qint64 size, const QDateTime &modified) const
+{
+    return summary.fileSize == size && summary.lastModified == modified;
+}
+
+void ProgramCache::evictLocked()
+{
+    while (entries.size() > maxEntries) {
+        auto oldest = entries.begin();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->lastUse < oldest->lastUse) {
+                oldest = it;
+            }
+        }
+        entries.erase(oldest);
+    }
+}
+
+QSharedPointer<const ProgramSummary> ProgramCache::parseFile(const QString &filePath)
+{
+    QFileInfo info(filePath);
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QSharedPointer<const ProgramSummary>();
+    }
+    
+    QSharedPointer<ProgramSummary> summary(new ProgramSummary());
+    summary->filePath = filePath;
+    summary->fileSize = info.size();
+    summary->lastModified = info.lastModified();
+    summary->totalLines = 0;
+    summary->executableLines = 0;
+    summary->invalidLines = 0;
+    summary->hasExtents = false;
+    const double inf = std::numeric_limits<double>::infinity();
+    summary->minX = summary->minY = summary->minZ = inf;
+    summary->maxX = summary->maxY = summary->maxZ = -inf;
+    
+    static const QRegularExpression distanceModePattern("G0*9([01])(?![0-9.])");
+    static const QStringList nonMotionCommands = {"G4", "G04", "G10", "G28", "G30", "G53", "G92"};
+    
+    // Her çağrı kendi ayrıştırıcısını kullanır; GCodeParser iş parçacıkları arasında paylaşılmaz
+    GCodeParser parser;
+    bool absolute = true;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine();
+        const int lineNumber = static_cast<int>(++summary->totalLines);
+        const QString trimmed = line.trimmed();
+        if (trimmed.isEmpty()) {
+            continue;
+        }
+        if (trimmed.startsWith('$')) {
+            ++summary->executableLines;
+            continue;
+        }
+    
+        GCodeCommand command = parser.parseLine(trimmed, lineNumber);
+        if (command.command.isEmpty() && command.parameters.isEmpty()) {
+            if (!command.isValid) {
+                ++summary->invalidLines;
+                if (summary->errors.size() < MAX_REPORTED_ERRORS) {
+                    summary->errors << QString("Satır %1: %2").arg(lineNumber).arg(command.errorMessage);
+                }
+            }
+            continue;
+        }
+        // Komut kelimesi olmayan satırlar GRBL'de modal harekettir (örn. "X10 Y5")
+        if (!command.isValid && !command.command.isEmpty()) {
+            ++summary->invalidLines;
+            if (summary->errors.size() < MAX_REPORTED_ERRORS) {
+                summary->errors << QString("Satır %1: %2").arg(lineNumber).arg(command.errorMessage);
+            }
+            continue;
+        }
+        ++summary->executableLines;
+    
+        QRegularExpressionMatchIterator modes = distanceModePattern.globalMatch(trimmed.toUpper());
+        while (modes.hasNext()) {
+            absolute = modes.next().captured(1) == "0";
+        }
+        if (!absolute || nonMotionCommands.contains(command.command)) {
+            continue;
+        }
+    
+        auto extend = [&](QChar axis, double &minValue, double &maxValue) {
+            auto it = command.parameters.constFind(axis);
+            if (it != command.parameters.constEnd()) {
+                minValue = qMin(minValue, it.value());
+                maxValue = qMax(maxValue, it.value());
+                summary->hasExtents = true;
+            }
+        };
+        extend('X', summary->minX, summary->maxX);
+        extend('Y', summary->minY, summary->maxY);
+        extend('Z', summary->minZ, summary->maxZ);
+    }
+    
+    return summary;
+}
+
+// ---------------------------------------------------------------------------
+// MachineSession
+// ---------------------------------------------------------------------------
+
+MachineSession::MachineSession(const QString &name, ProgramCache *cache, QThreadPool *analysisPool)
+    : QObject(nullptr)
+    , name(name)
+    , programCache(cache)
+    , analysisPool(analysisPool)
+    , serialComm(new SerialCommunication(this))
+    , jobStreamer(new JobStreamer(serialComm, this))
+    , pendingJobMode(JobMode::Run)
+    , analysisToken(0)
+    , snapshot()
+    , notifyPending(false)
+{
+    setObjectName(name);
+    snapshot.name = name;
+    snapshot.connected = false;
+    snapshot.jobState = JobState::Idle;
+    snapshot.jobMode = JobMode::Run;
+    snapshot.linesCompleted = 0;
+    snapshot.progressPercent = 0;
+    snapshot.jobErrors = 0;
+    snapshot.linesPerSecond = 0.0;
+    snapshot.pendingCommands = 0;
+    snapshot.status.subState = -1;
+    snapshot.status.plannerBlocksAvailable = -1;
+    snapshot.status.rxBytesAvailable = -1;
+    
+    connect(serialComm, &SerialCommunication::connected, this, &MachineSession::updateSnapshot);
+    connect(serialComm, &SerialCommunication::disconnected, this, &MachineSession::updateSnapshot);
+    connect(serialComm, &SerialCommunication::statusReportReceived, this, &MachineSession::updateSnapshot);
+    connect(serialComm, &SerialCommunication::errorOccurred, this, [this](const QString &error) {
+        emit errorOccurred(this->name, error);
+    });
+    
+    connect(jobStreamer, &JobStreamer::stateChanged, this, &MachineSession::updateSnapshot);
+    connect(jobStreamer, &JobStreamer::progressChanged, this, &MachineSession::updateSnapshot);
+    connect(jobStreamer, &JobStreamer::lineFailed, this, [this](qint64 lineNumber, const QString &, const QString &error) {
+        emit errorOccurred(this->name, QString("Satır %1: %2").arg(lineNumber).arg(error));
+    });
+    connect(jobStreamer, &JobStreamer::finished, this, [this](bool success) {
+        updateSnapshot();
+        emit jobFinished(this->name, success);
+    });
+}
+
+MachineSession::~MachineSession()
+{
+}
+
+QString MachineSession::getName() const
+{
+    return name;
+}
+
+MachineSnapshot MachineSession::getSnapshot() const
+{
+    // Bayrak kopyadan önce temizlenir: okuma sırasında gelen güncelleme yeniden bildirilir
+    notifyPending.store(false);
+    QMutexLocker locker(&snapshotMutex);
+    return snapshot;
+}
+
+SerialCommunication *MachineSession::getSerialCommunication() const
+{
+    return serialComm;
+}
+
+JobStreamer *MachineSession::getJobStreamer() const
+{
+    return jobStreamer;
+}
+
+void MachineSession::connectToDevice(const QString &portName, int baudRate)
+{
+    if (!serialComm->connectToDevice(portName, baudRate)) {
+        emit errorOccurred(name, QString("Bağlantı kurulamadı: %1").arg(portName));
+    }
+    updateSnapshot();
+}
+
+void MachineSession::connectToHost(const QString &host, quint16 port)
+{
+    if (!serialComm->connectToHost(host, port)) {
+        emit errorOccurred(name, QString("Bağlantı kurulamadı: %1:%2").arg(host).arg(port));
+    }
+    updateSnapshot();
+}
+
+void MachineSession::disconnectFromDevice()
+{
+    abandonPendingJob();
+    serialComm->disconnectFromDevice();
+    updateSnapshot();
+}
+
+void MachineSession::sendCommand(const QString &command)
+{
+    // MDI şeridi: iş sürerken de kuyruktaki iş satırlarının önüne, satır sınırında girer
+    serialComm->sendCommand(command, CommandLane::Mdi);
+}
+
+void MachineSession::startJob(const QString &filePath, JobMode mode)
+{
+    if (jobStreamer->isActive() || !pendingJobFile.isEmpty()) {
+        emit errorOccurred(name, "Bir iş zaten çalışıyor");
+        return;
+    }
+    if (!serialComm->isConnected()) {
+        emit errorOccurred(name, "Makine bağlı değil");
+        emit jobFinished(name, false);
+        return;
+    }
+    
+    pendingJobFile = filePath;
+    pendingJobMode = mode;
+    const quint64 token = ++analysisToken;
+    {
+        QMutexLocker locker(&snapshotMutex);
+        snapshot.jobFile = filePath;
+    }
+    
+    // Ayrıştırma havuzda yapılır; oturum iş parçacığı bu sırada durum raporlarını işlemeye devam eder.
+    // Oturum, yönetici havuzu bekledikten sonra silindiği için ham işaretçi güvenlidir.
+    ProgramCache *cache = programCache;
+    MachineSession *session = this;
+    analysisPool->start([cache, session, token, filePath]() {
+        QSharedPointer<const ProgramSummary> summary = cache->summarize(filePath);
+        QMetaObject::invokeMethod(session, [session, token, filePath, summary]() {
+            session->handleProgramSummary(token, filePath, summary);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MachineSession::pauseJob()
+{
+    jobStreamer->pause();
+}
+
+void MachineSession::feedHold()
+{
+    jobStreamer->feedHold();
+}
+
+void MachineSession::resumeJob()
+{
+    jobStreamer->resume();
+}
+
+void MachineSession::stopJob()
+{
+    if (!pendingJobFile.isEmpty()) {
+        abandonPendingJob();
+        updateSnapshot();
+        return;
+    }
+    jobStreamer->stop();
+}
+
+void MachineSession::shutdown(QThread *targetThread)
+{
+    pendingJobFile.clear();
+    ++analysisToken;
+    if (serialComm->isConnected()) {
+        serialComm->disconnectFromDevice();
+    }
+    // Zamanlayıcılar ve alt nesneler birlikte taşınır; silme hedef iş parçacığında güvenlidir
+    moveToThread(targetThread);
+}
+
+void MachineSession::handleProgramSummary(quint64 token, const QString &filePath,
+                                          QSharedPointer<const ProgramSummary> summary)
+{
+    if (token != analysisToken || pendingJobFile != filePath) {
+        return;
+    }
+    pendingJobFile.clear();
+    
+    if (!summary) {
+        emit errorOccurred(name, QString("Program okunamadı: %1").arg(filePath));
+        emit jobFinished(name, false);
+        updateSnapshot();
+        return;
+    }
+    
+    emit programAnalyzed(name, filePath, summary->executableLines, summary->invalidLines);
+    if (summary->invalidLines > 0) {
+        Logger::instance()->warning(QString("%1: %2 satır ayrıştırılamadı, GRBL doğrulaması esas alınacak")
+                                    .arg(name).arg(summary->invalidLines));
+    }
+    
+    if (!jobStreamer->startFile(filePath, 1, pendingJobMode)) {
+        emit errorOccurred(name, QString("İş başlatılamadı: %1").arg(filePath));
+        emit jobFinished(name, false);
+    }
+    updateSnapshot();
+}
+
+void MachineSession::abandonPendingJob()
+{
+    if (pendingJobFile.isEmpty()) {
+        return;
+    }
+    // Henüz başlamamış iş: analiz sonucu geldiğinde yok sayılır
+    pendingJobFile.clear();
+    ++analysisToken;
+    emit jobFinished(name, false);
+}
+
+void MachineSession::updateSnapshot()
+{
+    {
+        QMutexLocker locker(&snapshotMutex);
+        snapshot.connected = serialComm->isConnected();
+        snapshot.transport = serialComm->getTransportDescription();
+        snapshot.status = serialComm->getLastStatusReport();
+        snapshot.jobState = jobStreamer->getState();
+        snapshot.jobMode = jobStreamer->getMode();
+        snapshot.linesCompleted = jobStreamer->getLinesCompleted();
+        snapshot.progressPercent = jobStreamer->getProgressPercent();
+        snapshot.jobErrors = jobStreamer->getErrorCount();
+        snapshot.linesPerSecond = jobStreamer->getLinesPerSecond();
+        snapshot.pendingCommands = serialComm->getPendingCommandCount();
+    }
+    notifySnapshot();
+}
+
+void MachineSession::notifySnapshot()
+{
+    // GUI önceki bildirimi okumadıysa yenisini kuyruğa ekleme
+    if (!notifyPending.exchange(true)) {
+        emit snapshotChanged(name);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// MachineManager
+// ---------------------------------------------------------------------------
+
+MachineManager::MachineManager(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<GrblStatusReport>();
+    analysisPool.setObjectName("ProgramAnalysis");
+}
+
+MachineManager::~MachineManager()
+{
+    shutdown();
+}
+
+MachineSession *MachineManager::addMachine(const QString &name)
+{
+    if (name.isEmpty() || machines.contains(name)) {
+        return nullptr;
+    }
+    
+    HostedMachine machine;
+    machine.thread = new QThread(this);
+    machine.thread->setObjectName(QString("Machine:%1").arg(name));
+    machine.session = new MachineSession(name, &programCache, &analysisPool);
+    machine.session->moveToThread(machine.thread);
+    machine.thread->start();
+    machines.insert(name, machine);
+    
+    Logger::instance()->info(QString("Makine oturumu eklendi: %1 (%2 oturum)").arg(name).arg(machines.size()));
+    emit machineAdded(name);
+    return machine.session;
+}
+
+bool MachineManager::removeMachine(const QString &name)
+{
+    auto it = machines.find(name);
+    if (it == machines.end()) {
+        return false;
+    }
+    
+    HostedMachine machine = it.value();
+    machines.erase(it);
+    stopMachine(machine);
+    emit machineRemoved(name);
+    return true;
+}
+
+MachineSession *MachineManager::getMachine(const QString &name) const
+{
+    auto it = machines.constFind(name);
+    return it != machines.constEnd() ? it->session : nullptr;
+}
+
+QStringList MachineManager::getMachineNames() const
+{
+    return machines.keys();
+}
+
+int MachineManager::getMachineCount() const
+{
+    return machines.size();
+}
+
+ProgramCache *MachineManager::getProgramCache()
+{
+    return &programCache;
+}
+
+void MachineManager::shutdown()
+{
+    const QStringList names = machines.keys();
+    for (const QString &name : names) {
+        removeMachine(name);
+    }
+}
+
+void MachineManager::stopMachine(HostedMachine &machine)
+{
+    if (machine.thread->isRunning()) {
+        MachineSession *session = machine.session;
+        QThread *home = thread();
+        QMetaObject::invokeMethod(session, [session, home]() {
+            session->shutdown(home);
+        }, Qt::BlockingQueuedConnection);
+        machine.thread->quit();
+        machine.thread->wait();
+    }
+    
+    // Havuzdaki analiz görevleri oturuma sonuç gönderebilir; silmeden önce bitmeleri beklenir
+    analysisPool.waitForDone();
+    delete machine.session;
+    delete machine.thread;
+}
@@ -1,9 +1,58 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
 #include <QStyleFactory>
+#include <QTextStream>
+#include <cstring>
+#include "jobserver.h"
 #include "mainwindow.h"
 
+// Masaüstü olmadan iş sunucusu: QApplication (ve dolayısıyla Widgets / platform
+// eklentisi) hiç oluşturulmaz, ekran gerektirmez.
+static int runHeadless(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("CNC Controller");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("CNC Software");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Başsız iş sunucusu: yerel soket üzerinden JSON satır API'si");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOption({"headless", "Arayüz olmadan iş sunucusu olarak çalış"});
+    parser.addOption({"socket", "Yerel soket adı veya yolu", "name", "cnc-controller"});
+    parser.addOption({"machine", "Başlangıçta bağlanılacak makine: ad=/dev/ttyUSB0@115200 veya ad=tcp:host:port", "spec"});
+    parser.process(app);
+    
+    JobServer server;
+    const QStringList machines = parser.values("machine");
+    for (const QString &spec : machines) {
+        QString error;
+        if (!server.addMachineFromSpec(spec, &error)) {
+            QTextStream(stderr) << error << "\n";
+            return 1;
+        }
+    }
+    
+    if (!server.listen(parser.value("socket"))) {
+        QTextStream(stderr) << "Soket açılamadı: " << server.errorString() << "\n";
+        return 1;
+    }
+    QTextStream(stdout) << "İş sunucusu: " << server.getServerPath() << "\n";
+    
+    return app.exec();
+}
+
 int main(int argc, char *argv[])
 {
+    // Başsız mod QApplication'dan önce seçilmeli
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            return runHeadless(argc, argv);
+        }
+    }
+    
     // Qt uygulaması oluşturma
     QApplication app(argc, argv);
     
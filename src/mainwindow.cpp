@@ -20,6 +20,9 @@ MainWindow::MainWindow(QWidget *parent)
     , gcodeParser(new GCodeParser(this))
     , serialComm(new SerialCommunication(this))
     , axisController(new AxisController(this))
+    , positionInterpolator(new PositionInterpolator(this))
+    , jobStreamer(new JobStreamer(serialComm, this))
+    , jogController(new JogController(serialComm, this))
     , settings(new Settings(this))
     , logger(Logger::instance())
     , currentX(0.0)
@@ -682,6 +685,7 @@ void MainWindow::openGCodeFile()
             QTextStream in(&file);
             QString content = in.readAll();
             gcodeEditor->setPlainText(content);
+            gcodeEditor->document()->setModified(false);
             currentGCodeFile = fileName;
             updateStatusBar("Dosya açıldı: " + fileName);
             logMessage("G-code dosyası açıldı: " + fileName);
@@ -702,6 +706,7 @@ void MainWindow::saveGCodeFile()
         if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
             QTextStream out(&file);
             out << gcodeEditor->toPlainText();
+            gcodeEditor->document()->setModified(false);
             currentGCodeFile = fileName;
             updateStatusBar("Dosya kaydedildi: " + fileName);
             logMessage("G-code dosyası kaydedildi: " + fileName);
@@ -792,6 +797,43 @@ void MainWindow::jogZNegative()
 
 void MainWindow::startCNC()
 {
+    // Duraklatılmış iş varsa devam ettir
+    if (jobStreamer->getState() == JobState::Paused || jobStreamer->getState() == JobState::FeedHold) {
+        jobStreamer->resume();
+        updateStatusBar("CNC Devam Ediyor");
+        logMessage("CNC işlemine devam edildi");
+        startBtn->setEnabled(false);
+        pauseBtn->setEnabled(true);
+        return;
+    }
+    
+    if (emergencyStopActive) {
+        logMessage("Emergency Stop aktif! İş başlatılamaz.");
+        return;
+    }
+    
+    if (!serialComm->isConnected()) {
+        logMessage("Kontrolcü bağlı değil, iş başlatılamadı");
+        return;
+    }
+    
+    // Kaydedilmiş dosya düzenlenmediyse doğrudan diskten akıt (sabit bellek)
+    bool started = false;
+    if (!currentGCodeFile.isEmpty() && !gcodeEditor->document()->isModified()) {
+        started = jobStreamer->startFile(currentGCodeFile);
+    } else {
+        started = jobStreamer->startText(gcodeEditor->toPlainText());
+    }
+    
+    if (!started) {
+        logMessage("İş başlatılamadı");
+        return;
+    }
+    
+    progressBar->setRange(0, 100);
+    progressBar->setValue(0);
+    progressBar->setVisible(true);
+    
     updateStatusBar("CNC Başlatıldı");
     logMessage("CNC işlemi başlatıldı");
     startBtn->setEnabled(false);
@@ -801,6 +843,8 @@ void MainWindow::startCNC()
 
 void MainWindow::stopCNC()
 {
+    jobStreamer->stop();
+    
     updateStatusBar("CNC Durduruldu");
     logMessage("CNC işlemi durduruldu");
     startBtn->setEnabled(true);
@@ -810,8 +854,17 @@ void MainWindow::stopCNC()
 
 void MainWindow::pauseCNC()
 {
+    if (jobStreamer->getState() != JobState::Running) {
+        return;
+    }
+    
+    // Feed hold: hareket yavaşlayarak durur, Başlat ile devam eder
+    jobStreamer->feedHold();
+    
     updateStatusBar("CNC Duraklatıldı");
     logMessage("CNC işlemi duraklatıldı");
+    startBtn->setEnabled(true);
+    pauseBtn->setEnabled(false);
 }
 
 void MainWindow::emergencyStop()
@@ -1295,22 +1348,6 @@ void MainWindow::sendGCodeCommand()
     }
 }
 
-void MainWindow::processGCodeFile()
-{
-    QString gcode = gcodeEditor->toPlainText();
-    if (!gcode.isEmpty() && gcodeParser) {
-        QVector<GCodeCommand> commands = gcodeParser->parseFile(gcode);
-        gcodeCommands.clear();
-        for (const GCodeCommand &cmd : commands) {
-            gcodeCommands.append(cmd.originalLine);
-        }
-        currentCommandIndex = 0;
-        progressBar->setVisible(true);
-        progressBar->setMaximum(gcodeCommands.size());
-        logMessage(QString("G-code dosyası işleniyor: %1 komut").arg(gcodeCommands.size()));
-    }
-}
-
 void MainWindow::updateStatusBar(const QString &message)
 {
     statusBar->showMessage(message);
@@ -1372,12 +1409,45 @@ void MainWindow::connectModules()
     connect(serialComm, &SerialCommunication::disconnected, this, [this]() {
         updateStatusBar("Seri port bağlantısı kesildi");
         logMessage("Seri port bağlantısı kesildi");
+        positionInterpolator->reset();
+    });
+    
+    // Status raporları arası pozisyon tahmini: DRO ve önizleme akıcı güncellenir
+    connect(serialComm, &SerialCommunication::statusReportReceived,
+            positionInterpolator, &PositionInterpolator::updateFromReport);
+    connect(positionInterpolator, &PositionInterpolator::interpolatedPositionChanged, this,
+            [this](double x, double y, double z) {
+        updateAxisPosition('X', x);
+        updateAxisPosition('Y', y);
+        updateAxisPosition('Z', z);
+        openGLWidget->updateCurrentPosition(QVector3D(x, y, z));
     });
     
     connect(serialComm, &SerialCommunication::errorOccurred, this, [this](const QString &error) {
         logMessage("Seri port hatası: " + error);
     });
     
+    // İş akışı sinyallerini bağla
+    connect(jobStreamer, &JobStreamer::progressChanged, this, [this](qint64, int percent) {
+        progressBar->setValue(percent);
+    });
+    
+    connect(jobStreamer, &JobStreamer::lineFailed, this,
+            [this](qint64 lineNumber, const QString &line, const QString &error) {
+        logMessage(QString("Satır %1 hatası: %2 (%3)").arg(lineNumber).arg(error, line));
+    });
+    
+    connect(jogController, &JogController::jogError, this, [this](const QString &error) {
+        logMessage("Jog hatası: " + error);
+    });
+    
+    connect(jobStreamer, &JobStreamer::finished, this, [this](bool success) {
+        updateStatusBar(success ? "İş tamamlandı" : "İş durduruldu");
+        startBtn->setEnabled(true);
+        stopBtn->setEnabled(false);
+        pauseBtn->setEnabled(false);
+    });
+    
     // G-code parser sinyallerini bağla
     connect(gcodeParser, &GCodeParser::parsingCompleted, this, [this](int totalCommands) {
         logMessage(QString("G-code parsing tamamlandı: %1 komut").arg(totalCommands));
@@ -1446,6 +1516,18 @@ void MainWindow::startContinuousJog(char axis, bool positive)
         return;
     }
     
+    // Kontrolcü bağlıysa gerçek makine $J= artımlarıyla sürülür
+    if (serialComm->isConnected()) {
+        if (jobStreamer->isActive()) {
+            logMessage("İş çalışırken jog yapılamaz");
+            return;
+        }
+        if (jogController->start(axis, positive, jogSpeed)) {
+            logMessage(QString("Sürekli %1%2 jog başlatıldı").arg(axis).arg(positive ? "+" : "-"));
+        }
+        return;
+    }
+    
     if (axisController) {
         axisController->startContinuousJog(axis, positive);
         logMessage(QString("Sürekli %1%2 jog başlatıldı").arg(axis).arg(positive ? "+" : "-"));
@@ -1454,7 +1536,12 @@ void MainWindow::startContinuousJog(char axis, bool positive)
 
 void MainWindow::stopContinuousJog()
 {
-    if (axisController) {
+    if (jogController->isJogging()) {
+        jogController->stop(); // 0x85 jog cancel
+        logMessage("Sürekli jog durduruldu");
+    }
+    
+    if (axisController && axisController->isJogging()) {
         axisController->stopContinuousJog();
         logMessage("Sürekli jog durduruldu");
     }
@@ -1495,6 +1582,12 @@ double MainWindow::getJogStep()
 // Klavye kısayolları
 void MainWindow::keyPressEvent(QKeyEvent *event)
 {
+    // Basılı tutulan tuşun tekrarları jog'u yeniden başlatmasın
+    if (event->isAutoRepeat()) {
+        QMainWindow::keyPressEvent(event);
+        return;
+    }
+    
     switch (event->key()) {
         case Qt::Key_X:
             if (event->modifiers() & Qt::ShiftModifier) {
@@ -1536,6 +1629,12 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
 
 void MainWindow::keyReleaseEvent(QKeyEvent *event)
 {
+    // Tuş tekrarı sahte bırakma olayları üretir; yalnızca gerçek bırakma durdurur
+    if (event->isAutoRepeat()) {
+        QMainWindow::keyReleaseEvent(event);
+        return;
+    }
+    
     switch (event->key()) {
         case Qt::Key_X:
         case Qt::Key_Y:
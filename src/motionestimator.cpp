@@ -0,0 +1,460 @@
+#include "motionestimator.h"
+#include "controllersettings.h"
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+// Ayarlar okunmamışsa GRBL 1.1 varsayılanları ($110, $120, $130, $25)
+static const double DEFAULT_MAX_RATE = 500.0;      // mm/min
+static const double DEFAULT_ACCELERATION = 10.0;   // mm/s²
+static const double DEFAULT_MAX_TRAVEL = 200.0;    // mm
+static const double DEFAULT_HOMING_SEEK = 500.0;   // mm/min
+static const char AXIS_LETTERS[MotionEstimator::AXIS_COUNT] = {'X', 'Y', 'Z'};
+
+MotionEstimator::MotionEstimator()
+    : settings(nullptr)
+{
+    invalidate();
+}
+
+void MotionEstimator::setSettings(const ControllerSettings *controllerSettings)
+{
+    settings = controllerSettings;
+}
+
+void MotionEstimator::invalidate()
+{
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        position[axis] = 0.0;
+        positionKnown[axis] = false;
+    }
+    // Reset sonrası GRBL varsayılan modal durumu: G0 G17 G21 G90 G94
+    motionMode = 0;
+    planeMode = 17;
+    absoluteMode = true;
+    inchUnits = false;
+    inverseTimeFeed = false;
+    feedRate = 0.0;
+}
+
+void MotionEstimator::syncPosition(double x, double y, double z)
+{
+    position[0] = x;
+    position[1] = y;
+    position[2] = z;
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        positionKnown[axis] = true;
+    }
+}
+
+bool MotionEstimator::isPositionKnown() const
+{
+    return positionKnown[0] && positionKnown[1] && positionKnown[2];
+}
+
+double MotionEstimator::estimate(const QString &line)
+{
+    // Yorumları ve boşlukları at: "G1 X10 (kenar) ; not" -> "G1X10"
+    QString clean;
+    clean.reserve(line.size());
+    bool inComment = false;
+    for (QChar c : line) {
+        if (c == ';') {
+            break;
+        }
+        if (c == '(') {
+            inComment = true;
+        } else if (c == ')') {
+            inComment = false;
+        } else if (!inComment && !c.isSpace()) {
+            clean.append(c.toUpper());
+        }
+    }
+    if (clean.isEmpty()) {
+        return 0.0;
+    }
+    
+    if (clean.startsWith("$J=")) {
+        return estimateJog(clean.mid(3));
+    }
+    if (clean.startsWith("$H")) {
+        // Homing makine sıfırını kurar; iş koordinatı konumu status ile eşitlenene kadar bilinmez
+        double seconds = estimateHoming();
+        for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+            positionKnown[axis] = false;
+        }
+        return seconds;
+    }
+    if (clean.startsWith('$')) {
+        return 0.0;
+    }
+    
+    double scale = inchUnits ? 25.4 : 1.0;
+    double words[AXIS_COUNT] = {0.0, 0.0, 0.0};
+    bool hasAxis[AXIS_COUNT] = {false, false, false};
+    double offset[AXIS_COUNT] = {0.0, 0.0, 0.0};
+    bool hasOffset = false;
+    double radius = 0.0;
+    bool hasRadius = false;
+    double dwell = 0.0;
+    double feed = -1.0;
+    int nonModal = -1;      // 4, 10, 28, 30, 53, 92 (x10)
+    bool programEnd = false;
+    
+    int i = 0;
+    while (i < clean.size()) {
+        QChar letter = clean[i++];
+        int start = i;
+        while (i < clean.size() && (clean[i].isDigit() || clean[i] == '.' || clean[i] == '-' || clean[i] == '+')) {
+            ++i;
+        }
+        bool ok = false;
+        double value = clean.mid(start, i - start).toDouble(&ok);
+        if (!ok) {
+            continue;
+        }
+    
+        switch (letter.unicode()) {
+            case 'G': {
+                int code = qRound(value * 10.0);
+                switch (code) {
+                    case 0: case 10: case 20: case 30:
+                        motionMode = code / 10;
+                        break;
+                    case 382: case 383: case 384: case 385:
+                        motionMode = 1;     // Prob hareketi besleme hızında
+                        break;
+                    case 800:
+                        motionMode = -1;
+                        break;
+                    case 170: case 180: case 190:
+                        planeMode = code / 10;
+                        break;
+                    case 200: case 210:
+                        inchUnits = code == 200;
+                        scale = inchUnits ? 25.4 : 1.0;
+                        break;
+                    case 900: case 910:
+                        absoluteMode = code == 900;
+                        break;
+                    case 930: case 940:
+                        inverseTimeFeed = code == 930;
+                        break;
+                    case 40: case 100: case 280: case 300: case 530: case 920:
+                        nonModal = code;
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            }
+            case 'X': case 'Y': case 'Z': {
+                int axis = letter.unicode() - 'X';
+                words[axis] = value;
+                hasAxis[axis] = true;
+                break;
+            }
+            case 'I': case 'J': case 'K':
+                offset[letter.unicode() - 'I'] = value;
+                hasOffset = true;
+                break;
+            case 'R':
+                radius = value;
+                hasRadius = true;
+                break;
+            case 'F':
+                feed = value;
+                break;
+            case 'P':
+                dwell = value;
+                break;
+            case 'M':
+                programEnd = programEnd || qRound(value) == 2 || qRound(value) == 30;
+                break;
+            default:
+                break;
+        }
+    }
+    
+    // Birim kipi aynı satırda değişmiş olabilir; sayılar satır sonunda ölçeklenir
+    if (feed >= 0.0) {
+        feedRate = inverseTimeFeed ? feed : feed * scale;
+    }
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        words[axis] *= scale;
+        offset[axis] *= scale;
+    }
+    radius *= scale;
+    
+    bool anyAxis = hasAxis[0] || hasAxis[1] || hasAxis[2];
+    if (programEnd && !anyAxis && nonModal < 0) {
+        applyProgramEnd();
+        return 0.0;
+    }
+    switch (nonModal) {
+        case 40:
+            return qMax(dwell, 0.0);   // GRBL: P saniye
+        case 100:
+            return 0.0;                // G10 L2/L20: koordinat sistemi yazımı
+        case 920:
+            for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+                if (hasAxis[axis]) {
+                    position[axis] = words[axis];
+                    positionKnown[axis] = true;
+                }
+            }
+            return 0.0;
+        case 280:
+        case 300: {
+            // Ara nokta + kayıtlı konum: en kötü durumda her eksen tüm kurs kadar gider
+            double delta[AXIS_COUNT];
+            double length = 0.0;
+            for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+                delta[axis] = axisMaxTravel(axis);
+                length += delta[axis] * delta[axis];
+                positionKnown[axis] = false;
+            }
+            return moveTime(delta, std::sqrt(length), true, 0.0);
+        }
+        default:
+            break;
+    }
+    
+    if (!anyAxis || motionMode < 0) {
+        if (programEnd) {
+            applyProgramEnd();
+        }
+        return 0.0;
+    }
+    
+    // G53 makine koordinatıdır; WCO'yu bilmeden iş koordinatındaki mesafe bilinmez
+    bool machineCoordinates = nonModal == 530;
+    double start[AXIS_COUNT];
+    double target[AXIS_COUNT];
+    double delta[AXIS_COUNT];
+    double length = 0.0;
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        start[axis] = position[axis];
+        target[axis] = position[axis];
+        delta[axis] = 0.0;
+        if (!hasAxis[axis]) {
+            continue;
+        }
+        bool absolute = absoluteMode || machineCoordinates;
+        target[axis] = absolute ? words[axis] : position[axis] + words[axis];
+        bool known = positionKnown[axis] && !machineCoordinates;
+        delta[axis] = (absolute && !known) ? axisMaxTravel(axis) : target[axis] - position[axis];
+        length += delta[axis] * delta[axis];
+    }
+    length = std::sqrt(length);
+    
+    bool rapid = motionMode == 0 || machineCoordinates;
+    if (!machineCoordinates && (motionMode == 2 || motionMode == 3)) {
+        int first = (planeMode == 18) ? 2 : (planeMode == 19) ? 1 : 0;
+        int second = (planeMode == 18) ? 0 : (planeMode == 19) ? 2 : 1;
+        int linear = 3 - first - second;
+        double planar = (isPositionKnown() || !absoluteMode)
+            ? arcLength(start, target, offset, hasOffset || !hasRadius, radius, motionMode == 2)
+            : length * M_PI / 2.0;
+        length = std::hypot(planar, delta[linear]);
+        // Yay boyunca iki düzlem ekseni de hareket eder; limitler ikisine de uygulanır
+        delta[first] = planar;
+        delta[second] = planar;
+    }
+    
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        if (hasAxis[axis]) {
+            position[axis] = target[axis];
+            positionKnown[axis] = machineCoordinates ? false
+                                                     : (positionKnown[axis] || absoluteMode);
+        }
+    }
+    
+    // Aynı satırdaki hareket program sonu modlarından önce yürütülür
+    double seconds = moveTime(delta, length, rapid, feedRate);
+    if (programEnd) {
+        applyProgramEnd();
+    }
+    return seconds;
+}
+
+void MotionEstimator::applyProgramEnd()
+{
+    // GRBL M2/M30: G1 G17 G90 G94 G54; birim ve F korunur. G54'e dönüş iş
+    // koordinatını değiştirebilir, konum status ile eşitlenene kadar bilinmez.
+    motionMode = 1;
+    planeMode = 17;
+    absoluteMode = true;
+    if (inverseTimeFeed) {
+        feedRate = 0.0;     // G93 değeri (1/dk) G94'te anlamsız
+    }
+    inverseTimeFeed = false;
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        positionKnown[axis] = false;
+    }
+}
+
+double MotionEstimator::estimateJog(const QString &body)
+{
+    // $J= satırı modal durumu değiştirmez: G90/G91, G20/G21 ve G53 yalnızca bu satır için
+    bool absolute = absoluteMode;
+    double scale = inchUnits ? 25.4 : 1.0;
+    bool machineCoordinates = false;
+    double words[AXIS_COUNT] = {0.0, 0.0, 0.0};
+    bool hasAxis[AXIS_COUNT] = {false, false, false};
+    double feed = 0.0;
+    
+    int i = 0;
+    while (i < body.size()) {
+        QChar letter = body[i++];
+        int start = i;
+        while (i < body.size() && (body[i].isDigit() || body[i] == '.' || body[i] == '-' || body[i] == '+')) {
+            ++i;
+        }
+        bool ok = false;
+        double value = body.mid(start, i - start).toDouble(&ok);
+        if (!ok) {
+            continue;
+        }
+        if (letter.unicode() == 'G') {
+            int code = qRound(value * 10.0);
+            if (code == 900 || code == 910) {
+                absolute = code == 900;
+            } else if (code == 200 || code == 210) {
+                scale = (code == 200) ? 25.4 : 1.0;
+            } else if (code == 530) {
+                machineCoordinates = true;
+            }
+        } else if (letter.unicode() >= 'X' && letter.unicode() <= 'Z') {
+            words[letter.unicode() - 'X'] = value;
+            hasAxis[letter.unicode() - 'X'] = true;
+        } else if (letter.unicode() == 'F') {
+            feed = value;
+        }
+    }
+    
+    double delta[AXIS_COUNT];
+    double length = 0.0;
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        delta[axis] = 0.0;
+        if (!hasAxis[axis]) {
+            continue;
+        }
+        double value = words[axis] * scale;
+        bool knownStart = positionKnown[axis] && !machineCoordinates;
+        if (absolute || machineCoordinates) {
+            delta[axis] = knownStart ? value - position[axis] : axisMaxTravel(axis);
+            position[axis] = value;
+            positionKnown[axis] = !machineCoordinates;
+        } else {
+            delta[axis] = value;
+            position[axis] += value;
+        }
+        length += delta[axis] * delta[axis];
+    }
+    
+    // Jog'da F her zaman dakikada birimdir (G93 yok sayılır)
+    bool savedInverse = inverseTimeFeed;
+    inverseTimeFeed = false;
+    double seconds = moveTime(delta, std::sqrt(length), false, feed * scale);
+    inverseTimeFeed = savedInverse;
+    return seconds;
+}
+
+double MotionEstimator::estimateHoming() const
+{
+    // Arama + geri çekilme + yavaş konumlama: her eksen için kursun en fazla iki katı
+    double seek = settings ? settings->value(ControllerSettings::HomingSeek) : 0.0;
+    if (seek <= 0.0) {
+        seek = DEFAULT_HOMING_SEEK;
+    }
+    double travel = 0.0;
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        travel += axisMaxTravel(axis);
+    }
+    return 2.0 * travel / (seek / 60.0);
+}
+
+double MotionEstimator::moveTime(const double delta[AXIS_COUNT], double length, bool rapid, double feed) const
+{
+    if (length <= 1e-9) {
+        return 0.0;
+    }
+    
+    // Hareket yönündeki hız/ivme: her eksenin limiti bileşenine izdüşürülür
+    double rate = std::numeric_limits<double>::max();
+    double acceleration = std::numeric_limits<double>::max();
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        double component = std::fabs(delta[axis]);
+        if (component <= 1e-9) {
+            continue;
+        }
+        rate = qMin(rate, axisMaxRate(axis) * length / component);
+        acceleration = qMin(acceleration, axisAcceleration(axis) * length / component);
+    }
+    
+    if (!rapid) {
+        if (inverseTimeFeed && feed > 0.0) {
+            return 60.0 / feed; // G93: F = 1 / dakika cinsinden süre
+        }
+        if (feed > 0.0) {
+            rate = qMin(rate, feed);
+        }
+    }
+    
+    double velocity = rate / 60.0; // mm/s
+    return length / velocity + velocity / acceleration;
+}
+
+double MotionEstimator::arcLength(const double start[AXIS_COUNT], const double target[AXIS_COUNT],
+                                  const double offset[AXIS_COUNT], bool hasOffset, double radius,
+                                  bool clockwise) const
+{
+    int first = (planeMode == 18) ? 2 : (planeMode == 19) ? 1 : 0;
+    int second = (planeMode == 18) ? 0 : (planeMode == 19) ? 2 : 1;
+    double dx = target[first] - start[first];
+    double dy = target[second] - start[second];
+    double chord = std::hypot(dx, dy);
+    
+    if (hasOffset) {
+        double cx = start[first] + offset[first];
+        double cy = start[second] + offset[second];
+        double r = std::hypot(offset[first], offset[second]);
+        double a0 = std::atan2(start[second] - cy, start[first] - cx);
+        double a1 = std::atan2(target[second] - cy, target[first] - cx);
+        double sweep = clockwise ? a0 - a1 : a1 - a0;
+        while (sweep <= 1e-9) {
+            sweep += 2.0 * M_PI; // Başlangıç = bitiş: tam daire
+        }
+        return r * sweep;
+    }
+    
+    // R biçimi: negatif yarıçap 180°'den büyük yay demektir
+    double r = qMax(std::fabs(radius), chord / 2.0);
+    if (r <= 1e-9) {
+        return chord;
+    }
+    double sweep = 2.0 * std::asin(qMin(1.0, chord / (2.0 * r)));
+    if (radius < 0.0) {
+        sweep = 2.0 * M_PI - sweep;
+    }
+    return r * sweep;
+}
+
+double MotionEstimator::axisMaxRate(int axis) const
+{
+    double rate = settings ? settings->getMaxRate(AXIS_LETTERS[axis]) : 0.0;
+    return rate > 0.0 ? rate : DEFAULT_MAX_RATE;
+}
+
+double MotionEstimator::axisAcceleration(int axis) const
+{
+    double acceleration = settings ? settings->getAcceleration(AXIS_LETTERS[axis]) : 0.0;
+    return acceleration > 0.0 ? acceleration : DEFAULT_ACCELERATION;
+}
+
+double MotionEstimator::axisMaxTravel(int axis) const
+{
+    double travel = settings ? settings->getMaxTravel(AXIS_LETTERS[axis]) : 0.0;
+    return travel > 0.0 ? travel : DEFAULT_MAX_TRAVEL;
+}
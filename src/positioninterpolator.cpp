@@ -0,0 +1,97 @@
+#include "positioninterpolator.h"
+#include <QtMath>
+
+PositionInterpolator::PositionInterpolator(QObject *parent)
+    : QObject(parent)
+    , displayTimer(new QTimer(this))
+    , feedRateMMPerSec(0.0)
+    , lastReportTimeMs(0)
+    , reportIntervalMs(0)
+    , maxExtrapolationMs(250)
+    , hasReport(false)
+{
+    displayTimer->setInterval(16); // ~60Hz ekran güncellemesi
+    connect(displayTimer, &QTimer::timeout, this, &PositionInterpolator::updateDisplay);
+}
+
+void PositionInterpolator::setDisplayRate(int hz)
+{
+    displayTimer->setInterval(1000 / qBound(1, hz, 120));
+}
+
+int PositionInterpolator::getDisplayRate() const
+{
+    return 1000 / displayTimer->interval();
+}
+
+void PositionInterpolator::setMaxExtrapolationTime(int milliseconds)
+{
+    maxExtrapolationMs = milliseconds;
+}
+
+QVector3D PositionInterpolator::getInterpolatedPosition() const
+{
+    if (!hasReport || !displayTimer->isActive()) {
+        return lastReportedPosition;
+    }
+    
+    // Son rapordan beri geçen süre kadar raporlanan hızla ilerle. Rapor
+    // gecikirse tahmini sınırla ki takım hedefin ötesine kaymasın.
+    qint64 elapsedMs = reportClock.elapsed() - lastReportTimeMs;
+    qint64 limitMs = qMin<qint64>(maxExtrapolationMs, qMax<qint64>(reportIntervalMs, 1));
+    double seconds = qMin(elapsedMs, limitMs) / 1000.0;
+    
+    return lastReportedPosition + direction * static_cast<float>(feedRateMMPerSec * seconds);
+}
+
+void PositionInterpolator::updateFromReport(const GrblStatusReport &report)
+{
+    if (!reportClock.isValid()) {
+        reportClock.start();
+    }
+    
+    qint64 now = reportClock.elapsed();
+    // DRO ve takım yolu iş koordinatında: MPos değil WPos (MPos - WCO) izlenir
+    QVector3D position(report.wposX, report.wposY, report.wposZ);
+    
+    previousReportedPosition = hasReport ? lastReportedPosition : position;
+    lastReportedPosition = position;
+    reportIntervalMs = hasReport ? now - lastReportTimeMs : 0;
+    lastReportTimeMs = now;
+    hasReport = true;
+    
+    // Yön son iki rapordan, büyüklük raporlanan ilerleme hızından alınır
+    QVector3D delta = lastReportedPosition - previousReportedPosition;
+    direction = delta.length() > 1e-6f ? delta.normalized() : QVector3D();
+    feedRateMMPerSec = report.feedRate / 60.0;
+    
+    if (isMovingState(report.state) && !direction.isNull()) {
+        if (!displayTimer->isActive()) {
+            displayTimer->start();
+        }
+    } else {
+        displayTimer->stop();
+    }
+    
+    emit interpolatedPositionChanged(position.x(), position.y(), position.z());
+}
+
+void PositionInterpolator::reset()
+{
+    displayTimer->stop();
+    hasReport = false;
+    direction = QVector3D();
+    feedRateMMPerSec = 0.0;
+    reportIntervalMs = 0;
+}
+
+void PositionInterpolator::updateDisplay()
+{
+    QVector3D position = getInterpolatedPosition();
+    emit interpolatedPositionChanged(position.x(), position.y(), position.z());
+}
+
+bool PositionInterpolator::isMovingState(const QString &state) const
+{
+    return state == "Run" || state == "Jog" || state == "Home";
+}
@@ -1,28 +1,65 @@
 #include "serialcommunication.h"
 #include <QDebug>
 #include <QSerialPortInfo>
+#include <QRegularExpression>
+#include "logger.h"
+#include <limits>
 
 SerialCommunication::SerialCommunication(QObject *parent)
     : QObject(parent)
-    , serialPort(new QSerialPort(this))
+    , transport(nullptr)
+    , linkEstablished(false)
     , timeoutTimer(new QTimer(this))
     , safetyTimer(new QTimer(this))
     , statusTimer(new QTimer(this))
+    , latencySummaryTimer(new QTimer(this))
+    , trafficFlushTimer(new QTimer(this))
     , isProcessingCommand(false)
+    , nextSequence(1)
+    , streamingMode(StreamingMode::PingPong)
+    , serialBackend(SerialBackend::QtSerialPort)
+    , rxBufferSize(128)      // GRBL varsayılanı; $I yanıtından güncellenir
+    , plannerBlockCount(15)
+    , inFlightBytes(0)
+    , plannerAwareFlowControl(true)
+    , starvationRisk(false)
+    , plannerStarvationCount(0)
+    , starvationStatusInterval(20) // 50Hz açlık riski varken
+    , lastSummarizedCount(0)
+    , gcodeCompactionEnabled(true)
+    , statusMaskNegotiation(true)
+    , statusMaskNegotiated(false)
     , limitSwitchMonitoringEnabled(false)
-    , homingInProgress(false)
     , homingEnabled(true)
     , safetyChecksEnabled(true)
     , safetyTimeout(10000) // 10 saniye
+    , ackTimeout(5000)     // Hareketsiz komut için; hareket tahminiyle uzar
+    , lastHeartbeatMs(-1)
+    , ackTimeoutExtensions(0)
+    , statusRequestSentMs(0)
+    , statusRequestPending(false)
+    , idleStatusInterval(500)  // 2Hz boştayken
+    , activeStatusInterval(40) // 25Hz Run/Jog sırasında
+    , statusBackoffFactor(1)
 {
     // Timer ayarları
     timeoutTimer->setSingleShot(true);
-    timeoutTimer->setInterval(5000); // 5 saniye timeout
+    timeoutTimer->setInterval(ackTimeout); // Her kurulumda restartAckTimer() ile hesaplanır
     
     safetyTimer->setSingleShot(true);
     safetyTimer->setInterval(safetyTimeout);
     
-    statusTimer->setInterval(100); // 100ms = 10Hz status polling
+    statusTimer->setInterval(idleStatusInterval); // Makine durumuna göre uyarlanır
+    monotonicClock.start();
+    
+    latencySummaryTimer->setInterval(60000); // Dakikada bir gecikme özeti
+    trafficFlushTimer->setInterval(1000);    // Trafik kaydı trafik kesilse de diske iner
+    motionEstimator.setSettings(&controllerSettings);
+    
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        laneStatistics[lane] = {0, 0, 0, 0, 0};
+        laneHeld[lane] = false;
+    }
     
     // Limit switch durumunu başlat
     limitSwitchStatus = {
@@ -44,12 +81,26 @@ SerialCommunication::SerialCommunication(QObject *parent)
         false
     };
     
-    // Seri port bağlantıları
-    connect(serialPort, &QSerialPort::readyRead, this, &SerialCommunication::handleReadyRead);
-    connect(serialPort, &QSerialPort::errorOccurred, this, &SerialCommunication::handleError);
+    // Status raporunu başlat
+    lastStatusReport = {
+        QString(),
+        -1,
+        0.0, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        0.0,
+        0.0,
+        -1,
+        -1,
+        0
+    };
+    
+    // Timer bağlantıları
     connect(timeoutTimer, &QTimer::timeout, this, &SerialCommunication::handleTimeout);
     connect(safetyTimer, &QTimer::timeout, this, &SerialCommunication::handleSafetyTimeout);
-    connect(statusTimer, &QTimer::timeout, this, &SerialCommunication::requestStatus);
+    connect(statusTimer, &QTimer::timeout, this, &SerialCommunication::handleStatusPoll);
+    connect(latencySummaryTimer, &QTimer::timeout, this, &SerialCommunication::logLatencySummary);
+    connect(trafficFlushTimer, &QTimer::timeout, this, [this]() { trafficRecorder.flush(); });
 }
 
 SerialCommunication::~SerialCommunication()
@@ -59,51 +110,192 @@ SerialCommunication::~SerialCommunication()
 
 bool SerialCommunication::connectToDevice(const QString &portName, int baudRate)
 {
-    if (serialPort->isOpen()) {
+#ifdef Q_OS_LINUX
+    if (serialBackend == SerialBackend::LinuxNative) {
+        return connectWithTransport(new LinuxSerialTransport(portName, baudRate));
+    }
+#endif
+    return connectWithTransport(new SerialTransport(portName, baudRate));
+}
+
+void SerialCommunication::setSerialBackend(SerialBackend backend)
+{
+#ifndef Q_OS_LINUX
+    if (backend == SerialBackend::LinuxNative) {
+        LOG_WARNING("Yerel seri altyapı yalnızca Linux'ta var, QSerialPort kullanılacak", LogCategories::SERIAL);
+        backend = SerialBackend::QtSerialPort;
+    }
+#endif
+    serialBackend = backend;
+}
+
+SerialBackend SerialCommunication::getSerialBackend() const
+{
+    return serialBackend;
+}
+
+bool SerialCommunication::connectToHost(const QString &host, quint16 port)
+{
+    return connectWithTransport(new TcpTransport(host, port));
+}
+
+bool SerialCommunication::connectToWebSocket(const QUrl &url)
+{
+    return connectWithTransport(new WebSocketTransport(url));
+}
+
+bool SerialCommunication::connectToIODevice(QIODevice *device)
+{
+    if (!device) {
+        emit errorOccurred("Bağlantı hatası: geçersiz cihaz");
+        return false;
+    }
+    
+    // Sanal kontrolcü veya başka bir QIODevice; kapalıysa taşıyıcı açar
+    return connectWithTransport(new IODeviceTransport(device));
+}
+
+bool SerialCommunication::connectWithTransport(GrblTransport *newTransport)
+{
+    if (transport) {
         disconnectFromDevice();
     }
     
-    serialPort->setPortName(portName);
-    serialPort->setBaudRate(baudRate);
-    serialPort->setDataBits(QSerialPort::Data8);
-    serialPort->setParity(QSerialPort::NoParity);
-    serialPort->setStopBits(QSerialPort::OneStop);
-    serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    newTransport->setParent(this);
+    setTransport(newTransport);
     
-    if (serialPort->open(QIODevice::ReadWrite)) {
-        emit connected();
-        
-        // Bağlantı sonrası güvenlik kontrollerini başlat
-        if (safetyChecksEnabled) {
-            startStatusMonitoring();
-            requestLimitSwitchStatus();
-        }
-        
-        return true;
-    } else {
-        emit errorOccurred("Bağlantı hatası: " + serialPort->errorString());
+    // Ağ taşıyıcılarında bağlantı asenkron kurulur; connected() opened() ile gelir
+    if (!newTransport->open()) {
+        emit errorOccurred("Bağlantı hatası: " + newTransport->errorString());
+        disconnectFromDevice();
         return false;
     }
+    
+    return true;
+}
+
+QString SerialCommunication::getTransportDescription() const
+{
+    return transport ? transport->describe() : QString();
+}
+
+void SerialCommunication::setTransport(GrblTransport *newTransport)
+{
+    transport = newTransport;
+    connect(transport, &GrblTransport::readyRead, this, &SerialCommunication::handleReadyRead);
+    connect(transport, &GrblTransport::bytesReceived, this, [this](const QByteArray &data) {
+        trafficRecorder.record(TrafficDirection::Rx, monotonicClock.nsecsElapsed(), data);
+    });
+    connect(transport, &GrblTransport::opened, this, &SerialCommunication::handleConnectionEstablished);
+    connect(transport, &GrblTransport::closed, this, &SerialCommunication::handleTransportClosed);
+    connect(transport, &GrblTransport::errorOccurred, this, &SerialCommunication::handleTransportError);
+}
+
+QSerialPort *SerialCommunication::activeSerialPort() const
+{
+    SerialTransport *serial = qobject_cast<SerialTransport *>(transport);
+    return serial ? serial->port() : nullptr;
+}
+
+void SerialCommunication::handleTransportClosed()
+{
+    // Karşı taraf bağlantıyı kapattı (kablo, WiFi kopması, sunucu)
+    if (linkEstablished) {
+        emit errorOccurred("Bağlantı kesildi: " + getTransportDescription());
+    }
+    disconnectFromDevice();
+}
+
+void SerialCommunication::handleTransportError(const QString &error)
+{
+    emit errorOccurred(error);
+    
+    // Bağlantı kurulamadıysa bekleyen taşıyıcıyı bırak
+    if (!linkEstablished) {
+        disconnectFromDevice();
+    }
+}
+
+void SerialCommunication::handleConnectionEstablished()
+{
+    linkEstablished = true;
+    LOG_INFO("Bağlantı kuruldu: " + getTransportDescription(), LogCategories::SERIAL);
+    addTrafficMarker("connected " + getTransportDescription());
+    
+    if (latencySummaryTimer->interval() > 0) {
+        latencySummaryTimer->start();
+    }
+    emit connected();
+    
+    // Bağlantı sonrası güvenlik kontrollerini başlat
+    if (safetyChecksEnabled) {
+        startStatusMonitoring();
+        requestLimitSwitchStatus();
+    }
+    
+    // Ayar önbelleğini doldur; sonraki okumalar seri gidiş-dönüş gerektirmez
+    requestSettings();
 }
 
 void SerialCommunication::disconnectFromDevice()
 {
-    if (serialPort->isOpen()) {
-        stopStatusMonitoring();
-        serialPort->close();
+    if (transport) {
+        GrblTransport *oldTransport = transport;
+        transport = nullptr;
+        disconnect(oldTransport, nullptr, this, nullptr);
+        
+        if (linkEstablished) {
+            stopStatusMonitoring();
+            latencySummaryTimer->stop();
+            logLatencySummary();
+        }
+        oldTransport->close();
+        oldTransport->deleteLater();
+    }
+    
+    if (linkEstablished) {
+        linkEstablished = false;
+        addTrafficMarker("disconnected");
         emit disconnected();
     }
     
     // Bekleyen komutları temizle
-    commandQueue.clear();
+    cancelPendingResults(sentCommands, "Bağlantı kapandı");
+    pendingResponseLines.clear();
+    clearPendingCommands();
+    sentCommands.clear();
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        laneStatistics[lane].inFlight = 0;
+    }
     isProcessingCommand = false;
+    inFlightBytes = 0;
     timeoutTimer->stop();
     safetyTimer->stop();
+    plannedMotion.clear();
+    lastHeartbeatMs = -1;
+    
+    // Status sorgulama durumunu sıfırla
+    statusRequestPending = false;
+    statusBackoffFactor = 1;
+    machineState.clear();
+    lastStatusReport.plannerBlocksAvailable = -1;
+    lastStatusReport.rxBytesAvailable = -1;
+    lastStatusReport.wcoX = 0.0;
+    lastStatusReport.wcoY = 0.0;
+    lastStatusReport.wcoZ = 0.0;
+    statusMaskNegotiated = false;
+    starvationRisk = false;
+    updateStatusPollInterval();
+    
+    // Yeni bağlantıda kontrolcünün modal durumu ve ayarları bilinmez
+    gcodeCompactor.invalidate();
+    motionEstimator.invalidate();
+    controllerSettings.clear();
 }
 
 bool SerialCommunication::isConnected() const
 {
-    return serialPort->isOpen();
+    return transport && linkEstablished && transport->isOpen();
 }
 
 // YENİ: Hardware limit switch kontrolü
@@ -238,10 +430,16 @@ bool SerialCommunication::startHoming()
         return false;
     }
     
-    homingInProgress = true;
-    emit homingStarted();
+    homingResult = sendCommandAsync("$H", CommandLane::Safety); // GRBL homing komutu
+    if (homingResult.isFinished()) {
+        return false; // Reddedildi
+    }
     
-    return sendCommand("$H"); // GRBL homing komutu
+    emit homingStarted();
+    homingResult.then(this, [this](const CommandResult &result) {
+        handleHomingResult(result);
+    });
+    return true;
 }
 
 bool SerialCommunication::startHomingAxis(char axis)
@@ -256,16 +454,32 @@ bool SerialCommunication::startHomingAxis(char axis)
         return false;
     }
     
-    homingInProgress = true;
-    emit homingStarted();
+    homingResult = sendCommandAsync(QString("$H%1").arg(axis), CommandLane::Safety);
+    if (homingResult.isFinished()) {
+        return false;
+    }
     
-    QString command = QString("$H%1").arg(axis);
-    return sendCommand(command);
+    emit homingStarted();
+    homingResult.then(this, [this](const CommandResult &result) {
+        handleHomingResult(result);
+    });
+    return true;
 }
 
 bool SerialCommunication::isHoming() const
 {
-    return homingInProgress;
+    // Varsayılan QFuture tamamlanmış sayılır
+    return !homingResult.isFinished();
+}
+
+void SerialCommunication::handleHomingResult(const CommandResult &result)
+{
+    // Homing $H komutunun kendi ok'u ile tamamlanır; başka komutların yanıtı karışmaz
+    if (result.isOk()) {
+        emit homingCompleted();
+    } else {
+        emit homingFailed("Homing hatası: " + (result.response.isEmpty() ? QString("yanıt yok") : result.response));
+    }
 }
 
 void SerialCommunication::setHomingEnabled(bool enabled)
@@ -285,6 +499,100 @@ int SerialCommunication::getSafetyTimeout() const
     return safetyTimeout;
 }
 
+void SerialCommunication::setAckTimeout(int milliseconds)
+{
+    ackTimeout = qMax(milliseconds, 100);
+}
+
+int SerialCommunication::getAckTimeout() const
+{
+    return ackTimeout;
+}
+
+double SerialCommunication::getPlannedMotionSeconds() const
+{
+    double seconds = 0.0;
+    for (double blockSeconds : plannedMotion) {
+        seconds += blockSeconds;
+    }
+    return seconds;
+}
+
+quint64 SerialCommunication::getAckTimeoutExtensionCount() const
+{
+    return ackTimeoutExtensions;
+}
+
+void SerialCommunication::restartAckTimer()
+{
+    // ok, satır planlayıcıya girince gelir; planlayıcı doluysa önündeki blokların
+    // bitmesini bekler. Sistem komutları ($) ve senkron M kodları planlayıcının
+    // boşalmasını bekler. Süre: taban + (planlayıcıdaki + baştaki satır) x 1.5.
+    double motionSeconds = getPlannedMotionSeconds();
+    if (!sentCommands.isEmpty()) {
+        motionSeconds += sentCommands.head().estimatedSeconds;
+    }
+    qint64 deadline = ackTimeout + qRound64(motionSeconds * 1500.0);
+    timeoutTimer->start(static_cast<int>(qMin<qint64>(deadline, 24LL * 3600 * 1000)));
+}
+
+bool SerialCommunication::isHeartbeatAlive() const
+{
+    // Sorgulama yoksa nabız da yok; birkaç sorgu aralığı kadar sessizlik tolere edilir
+    if (!statusTimer->isActive() || lastHeartbeatMs < 0) {
+        return false;
+    }
+    qint64 window = qMax(3 * statusTimer->interval(), 1000);
+    return monotonicClock.elapsed() - lastHeartbeatMs <= window;
+}
+
+void SerialCommunication::recordTelemetry(const GrblStatusReport &report)
+{
+    TelemetrySample sample;
+    sample.mpos[0] = float(report.mposX);
+    sample.mpos[1] = float(report.mposY);
+    sample.mpos[2] = float(report.mposZ);
+    sample.feedRate = float(report.feedRate);
+    sample.spindleSpeed = float(report.spindleSpeed);
+    sample.rxBytesAvailable = qint16(qBound(-1, report.rxBytesAvailable, 32767));
+    sample.plannerBlocksAvailable = qint8(qBound(-1, report.plannerBlocksAvailable, 127));
+    sample.state = quint8(TelemetryRecorder::stateFromString(report.state));
+    telemetryRecorder.record(report.timestampMs, sample);
+}
+
+void SerialCommunication::updatePlannedMotion(const GrblStatusReport &report, bool hasPosition)
+{
+    // Bf: raporu planlayıcıda kaç blok kaldığını söyler; eski (çalışmış) tahminler düşülür.
+    // Yay satırları birden çok bloğa bölünür, bu yüzden satır sayısı üst sınırdır.
+    if (report.plannerBlocksAvailable >= 0) {
+        int plannedBlocks = qMax(0, plannerBlockCount - report.plannerBlocksAvailable);
+        while (plannedMotion.size() > plannedBlocks) {
+            plannedMotion.dequeue();
+        }
+    }
+    
+    // Boşta ve yolda satır yok: planlayıcı boş, konum kesin
+    if (report.state == "Idle" && sentCommands.isEmpty()) {
+        plannedMotion.clear();
+        if (hasPosition) {
+            motionEstimator.syncPosition(report.wposX, report.wposY, report.wposZ);
+        }
+    }
+}
+
+void SerialCommunication::updateSafetyWatchdog(bool heartbeat)
+{
+    // Bekçi yalnızca izlenecek iş varken ve status sorgulanırken kurulur; her rapor onu
+    // yeniden başlatır. Uzun bir hareket veya boşta bekleme artık acil durdurma tetiklemez.
+    bool watching = safetyChecksEnabled && statusTimer->isActive()
+        && (!sentCommands.isEmpty() || isActiveMachineState(machineState));
+    if (!watching) {
+        safetyTimer->stop();
+    } else if (heartbeat || !safetyTimer->isActive()) {
+        safetyTimer->start();
+    }
+}
+
 void SerialCommunication::enableSafetyChecks(bool enabled)
 {
     safetyChecksEnabled = enabled;
@@ -315,6 +623,60 @@ void SerialCommunication::stopStatusMonitoring()
     }
 }
 
+void SerialCommunication::handleStatusPoll()
+{
+    if (statusRequestPending) {
+        // Önceki rapor henüz gelmedi: bağlantı gecikiyor, bu tick'i atla ve yavaşla.
+        // Bir saniyeden eski istek kaybolmuş sayılır ve yeniden gönderilir.
+        if (monotonicClock.elapsed() - statusRequestSentMs < 1000) {
+            if (statusBackoffFactor < 8) {
+                statusBackoffFactor *= 2;
+                updateStatusPollInterval();
+            }
+            return;
+        }
+    }
+    
+    requestStatus();
+}
+
+void SerialCommunication::setStatusPollIntervals(int idleMs, int activeMs)
+{
+    idleStatusInterval = qMax(idleMs, 10);
+    activeStatusInterval = qMax(activeMs, 10);
+    updateStatusPollInterval();
+}
+
+int SerialCommunication::getStatusPollInterval() const
+{
+    return statusTimer->interval();
+}
+
+QString SerialCommunication::getMachineState() const
+{
+    return machineState;
+}
+
+bool SerialCommunication::isActiveMachineState(const QString &state) const
+{
+    return state == "Run" || state == "Jog" || state == "Home" || state == "Hold";
+}
+
+void SerialCommunication::updateStatusPollInterval()
+{
+    // Kuyrukta bekleyen komut varsa makine birazdan hareket edecek demektir
+    bool active = isActiveMachineState(machineState) || getPendingCommandCount() > 0;
+    int baseInterval = active ? activeStatusInterval : idleStatusInterval;
+    if (starvationRisk) {
+        baseInterval = qMin(baseInterval, starvationStatusInterval);
+    }
+    int interval = qMin(baseInterval * statusBackoffFactor, qMax(idleStatusInterval, 2000));
+    
+    if (statusTimer->interval() != interval) {
+        statusTimer->setInterval(interval);
+    }
+}
+
 void SerialCommunication::checkSafetyConditions()
 {
     // Limit switch kontrolü
@@ -390,45 +752,74 @@ void SerialCommunication::parseSpindleResponse(const QString &response)
     }
 }
 
-void SerialCommunication::parseHomingResponse(const QString &response)
-{
-    if (response.contains("ok") && homingInProgress) {
-        homingInProgress = false;
-        emit homingCompleted();
-    } else if (response.contains("error") && homingInProgress) {
-        homingInProgress = false;
-        emit homingFailed("Homing hatası: " + response);
-    }
-}
-
 void SerialCommunication::handleSafetyTimeout()
 {
+    // Kontrolcü yolda iş varken safetyTimeout boyunca tek bir status raporu göndermedi
+    if (sentCommands.isEmpty() && !isActiveMachineState(machineState)) {
+        return;
+    }
     emit safetyTimeoutOccurred();
     emit errorOccurred("Güvenlik timeout - sistem durduruldu");
     sendEmergencyStop();
 }
 
 // Mevcut fonksiyonlar devam ediyor...
-bool SerialCommunication::sendCommand(const QString &command)
+bool SerialCommunication::sendCommand(const QString &command, CommandLane lane)
+{
+    return enqueueCommand(command, lane, QSharedPointer<QPromise<CommandResult>>()) != 0;
+}
+
+QFuture<CommandResult> SerialCommunication::sendCommandAsync(const QString &command, CommandLane lane)
+{
+    QSharedPointer<QPromise<CommandResult>> promise = QSharedPointer<QPromise<CommandResult>>::create();
+    promise->start();
+    QFuture<CommandResult> future = promise->future();
+    
+    if (enqueueCommand(command, lane, promise) == 0) {
+        CommandResult result = {0, command.trimmed(), CommandStatus::Rejected, 0, QString(), QStringList(), -1};
+        promise->addResult(result);
+        promise->finish();
+    }
+    return future;
+}
+
+quint64 SerialCommunication::enqueueCommand(const QString &command, CommandLane lane,
+                                            const QSharedPointer<QPromise<CommandResult>> &promise)
 {
     if (!isConnected()) {
         emit errorOccurred("Seri port bağlı değil");
-        return false;
+        return 0;
     }
     
     // Güvenlik kontrolü
     if (safetyChecksEnabled && !validateSafetyCommand(command)) {
-        return false;
+        return 0;
     }
     
-    QString formattedCommand = command.trimmed() + "\n";
-    commandQueue.enqueue(formattedCommand);
+    QueuedCommand queued;
+    queued.sequence = nextSequence++;
+    queued.lane = lane;
+    queued.text = command.trimmed();
+    queued.rawSize = queued.text.toUtf8().size() + 1;
+    queued.compactorLine = 0;
+    queued.enqueuedNs = monotonicClock.nsecsElapsed();
+    queued.writtenNs = 0;
+    queued.ackNs = 0;
+    queued.estimatedSeconds = 0.0;
     
-    if (!isProcessingCommand) {
-        sendNextCommand();
+    QQueue<QueuedCommand> &queue = laneQueues[static_cast<int>(lane)];
+    LaneStatistics &statistics = laneStatistics[static_cast<int>(lane)];
+    queue.enqueue(queued);
+    statistics.queued = queue.size();
+    statistics.maxQueued = qMax(statistics.maxQueued, statistics.queued);
+    // Yazma hatası sendNextCommand içinde sonucu hemen tamamlayabilir; önce kaydedilir
+    if (promise) {
+        pendingResults.insert(queued.sequence, promise);
     }
+    updateStatusPollInterval();
+    sendNextCommand();
     
-    return true;
+    return queued.sequence;
 }
 
 bool SerialCommunication::sendGCodeCommand(const QString &gcode)
@@ -438,24 +829,90 @@ bool SerialCommunication::sendGCodeCommand(const QString &gcode)
 
 bool SerialCommunication::sendJogCommand(char axis, double distance, double speed)
 {
-    return sendCommand(formatJogCommand(axis, distance, speed));
+    return sendCommand(formatJogCommand(axis, distance, speed), CommandLane::Jog);
 }
 
 bool SerialCommunication::sendEmergencyStop()
 {
-    // Emergency stop komutu
-    return sendCommand("!");
+    // Emergency stop komutu (feed hold, realtime)
+    return sendRealtimeCommand('!');
 }
 
 bool SerialCommunication::sendReset()
 {
     // Reset komutu
-    return sendCommand("$X");
+    return sendCommand("$X", CommandLane::Safety);
+}
+
+bool SerialCommunication::sendFeedHold()
+{
+    return sendRealtimeCommand('!');
+}
+
+bool SerialCommunication::sendCycleStart()
+{
+    return sendRealtimeCommand('~');
+}
+
+bool SerialCommunication::sendJogCancel()
+{
+    return sendRealtimeCommand(static_cast<char>(0x85));
+}
+
+bool SerialCommunication::sendSoftReset()
+{
+    if (!sendRealtimeCommand(0x18)) {
+        return false;
+    }
+    
+    // GRBL reset ile RX tamponunu ve planlayıcıyı boşaltır; yoldaki
+    // satırlar için ok gelmeyecek
+    cancelPendingResults(sentCommands, "Soft reset");
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        cancelPendingResults(laneQueues[lane], "Soft reset");
+        laneQueues[lane].clear();
+        laneStatistics[lane].queued = 0;
+        laneStatistics[lane].inFlight = 0;
+        laneHeld[lane] = false;
+    }
+    sentCommands.clear();
+    isProcessingCommand = false;
+    inFlightBytes = 0;
+    timeoutTimer->stop();
+    plannedMotion.clear();
+    gcodeCompactor.invalidate();
+    motionEstimator.invalidate();
+    updateSafetyWatchdog(false);
+    return true;
 }
 
 void SerialCommunication::requestStatus()
 {
-    sendCommand("?");
+    if (sendRealtimeCommand('?')) {
+        statusRequestPending = true;
+        statusRequestSentMs = monotonicClock.elapsed();
+    }
+}
+
+bool SerialCommunication::sendRealtimeCommand(char command)
+{
+    if (!isConnected()) {
+        return false;
+    }
+    
+    // GRBL realtime komutları satır sonu beklemez ve ok yanıtı üretmez
+    return writeToTransport(QByteArray(1, command)) == 1;
+}
+
+qint64 SerialCommunication::writeToTransport(const QByteArray &data)
+{
+    trafficRecorder.record(TrafficDirection::Tx, monotonicClock.nsecsElapsed(), data);
+    return transport->write(data);
+}
+
+bool SerialCommunication::isAckResponse(const QString &response) const
+{
+    return response == "ok" || response.startsWith("error");
 }
 
 void SerialCommunication::requestPosition()
@@ -470,36 +927,36 @@ void SerialCommunication::requestSettings()
 
 void SerialCommunication::setBaudRate(int baudRate)
 {
-    if (isConnected()) {
-        serialPort->setBaudRate(baudRate);
+    if (QSerialPort *port = activeSerialPort()) {
+        port->setBaudRate(baudRate);
     }
 }
 
 void SerialCommunication::setDataBits(int dataBits)
 {
-    if (isConnected()) {
-        serialPort->setDataBits(static_cast<QSerialPort::DataBits>(dataBits));
+    if (QSerialPort *port = activeSerialPort()) {
+        port->setDataBits(static_cast<QSerialPort::DataBits>(dataBits));
     }
 }
 
 void SerialCommunication::setParity(int parity)
 {
-    if (isConnected()) {
-        serialPort->setParity(static_cast<QSerialPort::Parity>(parity));
+    if (QSerialPort *port = activeSerialPort()) {
+        port->setParity(static_cast<QSerialPort::Parity>(parity));
     }
 }
 
 void SerialCommunication::setStopBits(int stopBits)
 {
-    if (isConnected()) {
-        serialPort->setStopBits(static_cast<QSerialPort::StopBits>(stopBits));
+    if (QSerialPort *port = activeSerialPort()) {
+        port->setStopBits(static_cast<QSerialPort::StopBits>(stopBits));
     }
 }
 
 void SerialCommunication::setFlowControl(int flowControl)
 {
-    if (isConnected()) {
-        serialPort->setFlowControl(static_cast<QSerialPort::FlowControl>(flowControl));
+    if (QSerialPort *port = activeSerialPort()) {
+        port->setFlowControl(static_cast<QSerialPort::FlowControl>(flowControl));
     }
 }
 
@@ -515,8 +972,9 @@ QStringList SerialCommunication::getAvailablePorts()
 
 void SerialCommunication::handleReadyRead()
 {
-    while (serialPort->canReadLine()) {
-        QString line = serialPort->readLine().trimmed();
+    // Yanıt işlenirken bağlantı kapanabilir (örn. hata sonrası)
+    while (transport && transport->canReadLine()) {
+        QString line = QString::fromUtf8(transport->readLine()).trimmed();
         if (!line.isEmpty()) {
             emit dataReceived(line);
             
@@ -525,86 +983,915 @@ void SerialCommunication::handleReadyRead()
             parsePositionResponse(line);
             parseLimitSwitchResponse(line);
             parseSpindleResponse(line);
-            parseHomingResponse(line);
+            parseBuildOptions(line);
+            controllerSettings.parseLine(line);
+            
+            // Reset/alarm sonrası modal durum artık bilinmiyor, planlayıcı boşaldı
+            if (line.startsWith("Grbl ") || line.startsWith("ALARM")) {
+                gcodeCompactor.invalidate();
+                motionEstimator.invalidate();
+                plannedMotion.clear();
+            }
+            
+            // Kendiliğinden reset (alarm sonrası reset, reset düğmesi, ESP32 yeniden
+            // başlaması): GRBL yoldaki satırları attı, onlar için ok gelmeyecek
+            if (line.startsWith("Grbl ")) {
+                discardInFlightCommands("Kontrolcü resetlendi");
+                continue;
+            }
             
-            processReceivedData();
+            // Yalnızca ok/error yanıtları bekleyen komutu tamamlar
+            if (isAckResponse(line)) {
+                processReceivedData(line);
+            } else if (!sentCommands.isEmpty()) {
+                if (line.startsWith("ALARM")) {
+                    // Çalışan komut alarmla sonlandı (örn. $H -> ALARM:9)
+                    resolveCommand(sentCommands.head(), CommandStatus::Alarm, line, -1);
+                } else if (!line.startsWith('<') && !line.startsWith("Grbl ")
+                           && pendingResults.contains(sentCommands.head().sequence)) {
+                    pendingResponseLines << line;
+                }
+            }
         }
     }
 }
 
-void SerialCommunication::handleError(QSerialPort::SerialPortError error)
+void SerialCommunication::handleTimeout()
 {
-    if (error != QSerialPort::NoError) {
-        QString errorString = "Seri port hatası: " + serialPort->errorString();
-        emit errorOccurred(errorString);
-        
-        if (error == QSerialPort::ResourceError) {
-            disconnectFromDevice();
+    if (sentCommands.isEmpty()) {
+        isProcessingCommand = false;
+        return;
+    }
+    
+    if (isHeartbeatAlive()) {
+        // Kontrolcü canlı ve hareket ediyor: ok planlayıcıda yer açılmasını bekliyor.
+        // Feed override, hold veya tahminden yavaş bloklar bunu uzatabilir; atlamak
+        // akışı bozardı.
+        if (isActiveMachineState(machineState) || machineState == "Door") {
+            ackTimeoutExtensions++;
+            restartAckTimer();
+            return;
         }
+    } else if (statusTimer->isActive()) {
+        // Status raporları da kesildi: satırın akıbeti bilinmiyor. Atlanmaz;
+        // bağlantı kapanana veya safetyTimer durdurana kadar beklenir.
+        emit errorOccurred("Komut timeout: kontrolcü yanıt vermiyor");
+        restartAckTimer();
+        return;
     }
-}
-
-void SerialCommunication::handleTimeout()
-{
+    
+    // Kontrolcü boşta (veya nabız izlenmiyor) ve ok gelmedi: satır kaybolmuş, atla
     emit errorOccurred("Komut timeout");
-    isProcessingCommand = false;
+    QueuedCommand skipped = sentCommands.dequeue();
+    inFlightBytes -= skipped.data.size();
+    gcodeCompactor.invalidate(); // Satırın uygulanıp uygulanmadığı bilinmiyor
+    laneStatistics[static_cast<int>(skipped.lane)].inFlight--;
+    resolveCommand(skipped, CommandStatus::Timeout, QString(), -1);
+    
+    isProcessingCommand = !sentCommands.isEmpty();
+    if (isProcessingCommand) {
+        restartAckTimer();
+    }
     sendNextCommand();
 }
 
-void SerialCommunication::processReceivedData()
+void SerialCommunication::processReceivedData(const QString &response)
 {
-    // Basit implementasyon: her satır bir yanıt olarak kabul edilir
-    if (isProcessingCommand && !commandQueue.isEmpty()) {
-        QString sentCommand = commandQueue.dequeue();
-        emit commandCompleted(sentCommand.trimmed());
-        isProcessingCommand = false;
-        timeoutTimer->stop();
-        sendNextCommand();
+    // Hatalı satır modal durumu güncellemez; sıkıştırıcının varsayımı geçersiz.
+    // Yoldaki satırlar yalnızca onaylı satırların kurduğu kelimeleri düşürdüğünden etkilenmez.
+    if (response.startsWith("error")) {
+        gcodeCompactor.invalidate();
     }
-}
-
-void SerialCommunication::sendNextCommand()
-{
-    if (commandQueue.isEmpty() || isProcessingCommand) {
+    
+    // Her ok/error en eski gönderilmiş komutu tamamlar
+    if (sentCommands.isEmpty()) {
         return;
     }
     
-    QString command = commandQueue.head();
-    qint64 bytesWritten = serialPort->write(command.toUtf8());
-    
-    if (bytesWritten == command.length()) {
-        emit commandSent(command.trimmed());
-        isProcessingCommand = true;
-        timeoutTimer->start();
-        
-        // Güvenlik kontrolü
-        if (safetyChecksEnabled) {
-            safetyTimer->start();
+    QueuedCommand completed = sentCommands.dequeue();
+    if (completed.compactorLine > 0 && !response.startsWith("error")) {
+        gcodeCompactor.acknowledge(completed.compactorLine);
+    }
+    completed.ackNs = monotonicClock.nsecsElapsed();
+    inFlightBytes -= completed.data.size();
+    if (completed.estimatedSeconds > 0.0 && !response.startsWith("error")) {
+        // Satır planlayıcıya girdi; status Bf: ile çalışanlar düşülür
+        plannedMotion.enqueue(completed.estimatedSeconds);
+        while (plannedMotion.size() > plannerBlockCount) {
+            plannedMotion.dequeue();
         }
+    }
+    laneStatistics[static_cast<int>(completed.lane)].inFlight--;
+    
+    qint64 queueWaitUs = (completed.writtenNs - completed.enqueuedNs) / 1000;
+    qint64 ackLatencyUs = (completed.ackNs - completed.writtenNs) / 1000;
+    queueWaitHistogram.record(queueWaitUs);
+    ackLatencyHistogram.record(ackLatencyUs);
+    resolveCommand(completed, response.startsWith("error") ? CommandStatus::Error : CommandStatus::Ok,
+                   response, ackLatencyUs);
+    
+    if (response.startsWith("error")) {
+        emit commandFailed(completed.sequence, response);
+    }
+    emit commandAcknowledged(completed.sequence, queueWaitUs, ackLatencyUs);
+    QString command = completed.text;
+    if (command.startsWith('$')) {
+        handleSettingsAck(command, response);
+    }
+    emit commandCompleted(command);
+    
+    isProcessingCommand = !sentCommands.isEmpty();
+    
+    // Sıradaki yanıt için süreyi yeniden başlat
+    if (isProcessingCommand) {
+        restartAckTimer();
     } else {
-        emit errorOccurred("Komut gönderilemedi");
-        commandQueue.dequeue(); // Hatalı komutu kaldır
-        sendNextCommand();
+        timeoutTimer->stop();
     }
+    sendNextCommand();
 }
 
-void SerialCommunication::parseStatusResponse(const QString &response)
+void SerialCommunication::resolveCommand(const QueuedCommand &command, CommandStatus status,
+                                         const QString &response, qint64 ackLatencyUs)
 {
-    // GRBL status response parsing
-    if (response.startsWith("<")) {
-        // Status response format: <Idle|Run|Hold|Jog|Alarm|Door|Check|Home|Sleep|Cycle>,MPos:X,Y,Z,FS:F,S
-        QStringList parts = response.mid(1, response.length() - 2).split(',');
-        if (parts.size() >= 1) {
-            QString status = parts[0];
-            emit statusUpdated(status);
-            
-            // Homing durumu kontrolü
-            if (status == "Home" && homingInProgress) {
-                homingInProgress = false;
-                emit homingCompleted();
+    // ok öncesi satırlar yalnızca yanıtla biten komuta aittir
+    QStringList data;
+    if (status == CommandStatus::Ok || status == CommandStatus::Error || status == CommandStatus::Alarm) {
+        data.swap(pendingResponseLines);
+    }
+    
+    // Alarm komutu kuyruktan düşürmez: satır ok/error ile ya da ardından gelen
+    // reset banner'ında (discardInFlightCommands) iptal olarak sonuçlanır
+    if (status != CommandStatus::Alarm) {
+        emit commandResolved(command.sequence, status, response);
+    }
+    
+    QSharedPointer<QPromise<CommandResult>> promise = pendingResults.take(command.sequence);
+    if (!promise) {
+        return;
+    }
+    
+    CommandResult result;
+    result.sequence = command.sequence;
+    result.command = command.text;
+    result.status = status;
+    result.code = parseResponseCode(response);
+    result.response = response;
+    result.data = data;
+    result.ackLatencyUs = ackLatencyUs;
+    promise->addResult(result);
+    promise->finish();
+}
+
+void SerialCommunication::discardInFlightCommands(const QString &reason)
+{
+    // Önce muhasebe sıfırlanır: iptal sinyalini işleyenler yeni satır gönderebilir
+    QQueue<QueuedCommand> discarded;
+    discarded.swap(sentCommands);
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        laneStatistics[lane].inFlight = 0;
+    }
+    isProcessingCommand = false;
+    inFlightBytes = 0;
+    timeoutTimer->stop();
+    pendingResponseLines.clear();
+    updateSafetyWatchdog(false);
+    
+    cancelPendingResults(discarded, reason);
+    sendNextCommand();
+}
+
+void SerialCommunication::cancelPendingResults(const QQueue<QueuedCommand> &commands, const QString &reason)
+{
+    for (const QueuedCommand &command : commands) {
+        resolveCommand(command, CommandStatus::Cancelled, reason, -1);
+    }
+}
+
+int SerialCommunication::parseResponseCode(const QString &response)
+{
+    // "error:20" -> 20, "ALARM:9" -> 9
+    if (!response.startsWith("error:") && !response.startsWith("ALARM:")) {
+        return 0;
+    }
+    return response.mid(response.indexOf(':') + 1).toInt();
+}
+
+void SerialCommunication::sendNextCommand()
+{
+    updateLaneHolds();
+    if (!canSendNextCommand()) {
+        return;
+    }
+    
+    // Pencereye sığan tüm satırları tek tampona topla ve tek write() ile gönder:
+    // satır başına sistem çağrısı ve olay döngüsü uyanması yerine bir tane.
+    int firstBatchIndex = sentCommands.size();
+    QByteArray batch;
+    int lane;
+    while ((lane = selectNextLane()) >= 0) {
+        QueuedCommand command = laneQueues[lane].dequeue();
+        encodeCommand(command);
+        command.estimatedSeconds = motionEstimator.estimate(command.text);
+        batch.append(command.data);
+        inFlightBytes += command.data.size();
+        laneStatistics[lane].queued = laneQueues[lane].size();
+        laneStatistics[lane].inFlight++;
+        laneStatistics[lane].sent++;
+        sentCommands.enqueue(command);
+    }
+    
+    qint64 bytesWritten = writeToTransport(batch);
+    qint64 writtenNs = monotonicClock.nsecsElapsed();
+    
+    if (bytesWritten != batch.size()) {
+        // Yazılamayan satırları geri al ve kaldır
+        emit errorOccurred("Komut gönderilemedi");
+        gcodeCompactor.invalidate(); // Sıkıştırılan ama gitmeyen satırların modal kelimeleri
+        while (sentCommands.size() > firstBatchIndex) {
+            QueuedCommand failed = sentCommands.takeLast();
+            inFlightBytes -= failed.data.size();
+            laneStatistics[static_cast<int>(failed.lane)].inFlight--;
+            resolveCommand(failed, CommandStatus::Rejected, "Komut gönderilemedi", -1);
+        }
+        isProcessingCommand = !sentCommands.isEmpty();
+        return;
+    }
+    
+    batchSizeHistogram.record(sentCommands.size() - firstBatchIndex);
+    bytesInFlightHistogram.record(inFlightBytes);
+    
+    for (int i = firstBatchIndex; i < sentCommands.size(); ++i) {
+        sentCommands[i].writtenNs = writtenNs;
+        laneQueueWait[static_cast<int>(sentCommands[i].lane)].record((writtenNs - sentCommands[i].enqueuedNs) / 1000);
+        emit commandSent(sentCommands[i].text); // Kuyruktaki hali; yazılan baytlar yeniden çözülmez
+    }
+    
+    isProcessingCommand = true;
+    if (!timeoutTimer->isActive()) {
+        restartAckTimer();
+    }
+    
+    // Güvenlik kontrolü: gönderim nabız değildir, bekçi yalnızca kurulur
+    updateSafetyWatchdog(false);
+}
+
+bool SerialCommunication::canSendNextCommand() const
+{
+    return selectNextLane() >= 0;
+}
+
+int SerialCommunication::selectNextLane() const
+{
+    if (!isConnected()) {
+        return -1;
+    }
+    
+    // Katı öncelik: uygun ilk dolu şeridin başı sığmıyorsa alt şeritler de beklenir,
+    // aksi halde büyük bir güvenlik/MDI satırı küçük iş satırlarının arkasında aç kalırdı.
+    // Kontrolcü durumu nedeniyle bekletilen şerit (örn. Run sırasında jog) atlanır.
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        if (laneQueues[lane].isEmpty() || !isLaneEligible(static_cast<CommandLane>(lane))) {
+            continue;
+        }
+        
+        if (streamingMode == StreamingMode::PingPong) {
+            return sentCommands.isEmpty() ? lane : -1;
+        }
+        
+        // Karakter sayma: GRBL RX tamponunu taşırmadan sığan her satır gönderilir.
+        // Halka tampon bir baytı boş tuttuğu için sınır rxBufferSize - 1'dir.
+        // Sıkıştırma yazım anında yapılır ve satırı uzatmaz; ham boyut üst sınırdır.
+        int nextSize = laneQueues[lane].head().rawSize;
+        if (!sentCommands.isEmpty() && inFlightBytes + nextSize >= rxBufferSize) {
+            return -1;
+        }
+        return sentCommands.size() < getMaxLinesInFlight() ? lane : -1;
+    }
+    return -1;
+}
+
+bool SerialCommunication::isLaneEligible(CommandLane lane) const
+{
+    if (lane != CommandLane::Jog) {
+        return true;
+    }
+    
+    // GRBL $J= satırını yalnızca Idle/Jog durumunda kabul eder (aksi halde error:8).
+    // Yolda başka şeritten satır varsa makine birazdan Run'a geçecek demektir.
+    for (const QueuedCommand &command : sentCommands) {
+        if (command.lane != CommandLane::Jog) {
+            return false;
+        }
+    }
+    return machineState.isEmpty() || machineState == "Idle" || machineState == "Jog";
+}
+
+void SerialCommunication::updateLaneHolds()
+{
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        bool held = !laneQueues[lane].isEmpty() && !isLaneEligible(static_cast<CommandLane>(lane));
+        if (held && !laneHeld[lane]) {
+            laneStatistics[lane].heldCount++;
+        }
+        laneHeld[lane] = held;
+    }
+}
+
+void SerialCommunication::encodeCommand(QueuedCommand &command)
+{
+    QString line = command.text;
+    if (gcodeCompactionEnabled) {
+        line = gcodeCompactor.compact(command.text);
+        command.compactorLine = gcodeCompactor.getLastLineId();
+        if (line.size() > command.text.size()) {
+            line = command.text; // RX tampon hesabı ham boyuta göre yapıldı
+        }
+    }
+    command.data = line.toUtf8();
+    command.data.append('\n');
+}
+
+int SerialCommunication::getMaxLinesInFlight() const
+{
+    // Planlayıcı doluyken RX tamponunu satırla doldurmanın faydası yok: satırlar
+    // uzun bloklar bitene kadar bekler ve sonradan gelen MDI/jog'u geciktirir.
+    // Her ok bir blok yeri açıldığını gösterdiğinden birkaç satır yeterlidir.
+    if (plannerAwareFlowControl && lastStatusReport.plannerBlocksAvailable == 0 && !starvationRisk) {
+        return 4;
+    }
+    return std::numeric_limits<int>::max();
+}
+
+void SerialCommunication::updatePlannerFlowControl(const GrblStatusReport &previous, const GrblStatusReport &report)
+{
+    if (report.plannerBlocksAvailable < 0) {
+        return; // Rapor Bf: alanı içermiyor ($10 bit 1 kapalı)
+    }
+    
+    bool running = report.state == "Run" || report.state == "Jog";
+    bool wasRunning = previous.state == "Run" || previous.state == "Jog";
+    bool hasPendingLines = getPendingCommandCount() > 0;
+    int plannedBlocks = plannerBlockCount - report.plannerBlocksAvailable;
+    
+    // Açlık: iş sürerken planlayıcı tamamen boşaldı ve makine durdu/yavaşladı
+    bool plannerEmpty = plannedBlocks <= 0;
+    bool wasEmpty = previous.plannerBlocksAvailable >= plannerBlockCount;
+    if (plannerEmpty && !wasEmpty && wasRunning && hasPendingLines) {
+        plannerStarvationCount++;
+        emit plannerStarvation(plannerStarvationCount);
+        LOG_WARNING(QString("Planlayıcı açlığı: kuyrukta %1 satır varken tampon boşaldı")
+                    .arg(getPendingCommandCount()), LogCategories::SERIAL);
+    }
+    
+    // Risk: hareket sürerken planlayıcıda iki bloktan az kaldı ve gönderilecek satır var
+    bool risk = plannerAwareFlowControl && hasPendingLines && (running || wasRunning) && plannedBlocks <= 2;
+    if (risk != starvationRisk) {
+        starvationRisk = risk;
+        emit starvationRiskChanged(risk);
+    }
+    
+    sendNextCommand();
+}
+
+void SerialCommunication::setPlannerAwareFlowControl(bool enabled)
+{
+    plannerAwareFlowControl = enabled;
+    if (!enabled && starvationRisk) {
+        starvationRisk = false;
+        emit starvationRiskChanged(false);
+    }
+    updateStatusPollInterval();
+    sendNextCommand();
+}
+
+bool SerialCommunication::isPlannerAwareFlowControlEnabled() const
+{
+    return plannerAwareFlowControl;
+}
+
+bool SerialCommunication::isStarvationRiskHigh() const
+{
+    return starvationRisk;
+}
+
+quint64 SerialCommunication::getPlannerStarvationCount() const
+{
+    return plannerStarvationCount;
+}
+
+int SerialCommunication::bytesInFlight() const
+{
+    return inFlightBytes;
+}
+
+// YENİ: Akış kontrolü
+void SerialCommunication::setStreamingMode(StreamingMode mode)
+{
+    streamingMode = mode;
+    sendNextCommand();
+}
+
+StreamingMode SerialCommunication::getStreamingMode() const
+{
+    return streamingMode;
+}
+
+void SerialCommunication::setRxBufferSize(int bytes)
+{
+    rxBufferSize = qMax(bytes, 16);
+    sendNextCommand();
+}
+
+int SerialCommunication::getRxBufferSize() const
+{
+    return rxBufferSize;
+}
+
+int SerialCommunication::getPlannerBlockCount() const
+{
+    return plannerBlockCount;
+}
+
+int SerialCommunication::getPendingCommandCount() const
+{
+    return getQueuedCommandCount() + sentCommands.size();
+}
+
+int SerialCommunication::getQueuedCommandCount() const
+{
+    int queued = 0;
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        queued += laneQueues[lane].size();
+    }
+    return queued;
+}
+
+quint64 SerialCommunication::getLastQueuedSequence() const
+{
+    return nextSequence - 1;
+}
+
+bool SerialCommunication::isCommandPending(quint64 sequence) const
+{
+    // Yazma hatası komutu sendCommand dönmeden sonuçlandırabilir; çağıran bununla ayırt eder
+    for (const QueuedCommand &command : sentCommands) {
+        if (command.sequence == sequence) {
+            return true;
+        }
+    }
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        for (const QueuedCommand &command : laneQueues[lane]) {
+            if (command.sequence == sequence) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void SerialCommunication::clearPendingCommands()
+{
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        clearPendingCommands(static_cast<CommandLane>(lane));
+    }
+}
+
+void SerialCommunication::clearPendingCommands(CommandLane lane)
+{
+    int index = static_cast<int>(lane);
+    cancelPendingResults(laneQueues[index], "Kuyruk temizlendi");
+    laneQueues[index].clear();
+    laneStatistics[index].queued = 0;
+    laneHeld[index] = false;
+}
+
+int SerialCommunication::getLaneDepth(CommandLane lane) const
+{
+    return laneQueues[static_cast<int>(lane)].size();
+}
+
+LaneStatistics SerialCommunication::getLaneStatistics(CommandLane lane) const
+{
+    return laneStatistics[static_cast<int>(lane)];
+}
+
+const LatencyHistogram &SerialCommunication::getLaneQueueWaitHistogram(CommandLane lane) const
+{
+    return laneQueueWait[static_cast<int>(lane)];
+}
+
+QString SerialCommunication::laneName(CommandLane lane)
+{
+    switch (lane) {
+        case CommandLane::Safety:
+            return "safety";
+        case CommandLane::Jog:
+            return "jog";
+        case CommandLane::Mdi:
+            return "mdi";
+        case CommandLane::Job:
+            return "job";
+    }
+    return QString();
+}
+
+void SerialCommunication::parseBuildOptions(const QString &response)
+{
+    // $I yanıtı: [OPT:V,15,128] -> seçenekler, planlayıcı blok sayısı, RX tampon boyutu
+    if (!response.startsWith("[OPT:")) {
+        return;
+    }
+    
+    QStringList parts = response.mid(5, response.length() - 6).split(',');
+    if (parts.size() >= 3) {
+        bool blocksOk = false;
+        bool rxOk = false;
+        int blocks = parts[1].toInt(&blocksOk);
+        int rxSize = parts[2].toInt(&rxOk);
+        if (blocksOk && blocks > 0) {
+            plannerBlockCount = blocks;
+        }
+        if (rxOk && rxSize > 0) {
+            rxBufferSize = rxSize;
+        }
+    }
+}
+
+void SerialCommunication::handleSettingsAck(const QString &command, const QString &response)
+{
+    bool ok = (response == "ok");
+    
+    if (command == "$$") {
+        if (ok) {
+            controllerSettings.setLoaded(true);
+            LOG_INFO(QString("Kontrolcü ayarları okundu: %1 ayar")
+                     .arg(controllerSettings.numericSettings().size()), LogCategories::SERIAL);
+            negotiateStatusReportMask();
+            emit settingsLoaded();
+        }
+        return;
+    }
+    
+    int number = 0;
+    double value = 0.0;
+    if (!ok || !ControllerSettings::parseWrite(command, number, value)) {
+        return;
+    }
+    
+    // Kontrolcü değeri yuvarlayabilir; önbellekteki değer geçersiz
+    controllerSettings.invalidate(number);
+    
+    // Yazım dizisi bitince önbelleği tek $$ ile tazele. Karakter saymada birden
+    // çok $N= aynı anda yolda olur: yoldakiler de sayılmazsa her ack ayrı $$ atar.
+    auto isSettingsTraffic = [](const QueuedCommand &queued) {
+        return queued.text == "$$"
+            || (queued.text.size() > 1 && queued.text.startsWith('$') && queued.text.at(1).isDigit());
+    };
+    for (const QueuedCommand &sent : sentCommands) {
+        if (isSettingsTraffic(sent)) {
+            return;
+        }
+    }
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        for (const QueuedCommand &queued : laneQueues[lane]) {
+            if (isSettingsTraffic(queued)) {
+                return;
             }
         }
     }
+    requestSettings();
+}
+
+void SerialCommunication::negotiateStatusReportMask()
+{
+    if (!statusMaskNegotiation || statusMaskNegotiated) {
+        return;
+    }
+    statusMaskNegotiated = true;
+    
+    int desired = getDesiredStatusReportMask();
+    int current = controllerSettings.getStatusReportMask();
+    if (current == desired) {
+        return;
+    }
+    
+    LOG_INFO(QString("Status rapor maskesi $10=%1 -> %2").arg(current).arg(desired), LogCategories::SERIAL);
+    pushSettingsProfile({{ControllerSettings::StatusReportMask, static_cast<double>(desired)}});
+}
+
+void SerialCommunication::setStatusMaskNegotiation(bool enabled)
+{
+    statusMaskNegotiation = enabled;
+}
+
+int SerialCommunication::getDesiredStatusReportMask() const
+{
+    // Yalnızca MPos (WPos WCO ile türetilir); Bf: sadece planlayıcıya duyarlı
+    // akış kontrolü için. Mod değişince yeniden yazılmaz (EEPROM aşınması).
+    return 1 | (plannerAwareFlowControl ? 2 : 0);
+}
+
+GrblStatusReport SerialCommunication::getLastStatusReport() const
+{
+    return lastStatusReport;
+}
+
+const ControllerSettings &SerialCommunication::getControllerSettings() const
+{
+    return controllerSettings;
+}
+
+int SerialCommunication::pushSettingsProfile(const QMap<int, double> &profile)
+{
+    if (!controllerSettings.isLoaded()) {
+        emit errorOccurred("Ayar profili yazılamadı: kontrolcü ayarları henüz okunmadı");
+        return -1;
+    }
+    
+    // Yalnızca farklı değerler yazılır (her yazım EEPROM/flash yazımıdır)
+    const QStringList writes = controllerSettings.diff(profile);
+    for (const QString &write : writes) {
+        sendCommand(write);
+    }
+    
+    LOG_INFO(QString("Ayar profili: %1 ayardan %2 tanesi yazıldı").arg(profile.size()).arg(writes.size()),
+             LogCategories::SETTINGS);
+    return writes.size();
+}
+
+// YENİ: Gecikme istatistikleri
+const LatencyHistogram &SerialCommunication::getQueueWaitHistogram() const
+{
+    return queueWaitHistogram;
+}
+
+const LatencyHistogram &SerialCommunication::getAckLatencyHistogram() const
+{
+    return ackLatencyHistogram;
+}
+
+const LatencyHistogram &SerialCommunication::getBytesInFlightHistogram() const
+{
+    return bytesInFlightHistogram;
+}
+
+const LatencyHistogram &SerialCommunication::getBatchSizeHistogram() const
+{
+    return batchSizeHistogram;
+}
+
+void SerialCommunication::resetLatencyStatistics()
+{
+    queueWaitHistogram.reset();
+    ackLatencyHistogram.reset();
+    bytesInFlightHistogram.reset();
+    batchSizeHistogram.reset();
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        laneQueueWait[lane].reset();
+        laneStatistics[lane].maxQueued = laneStatistics[lane].queued;
+        laneStatistics[lane].sent = 0;
+        laneStatistics[lane].heldCount = 0;
+    }
+    lastSummarizedCount = 0;
+}
+
+QString SerialCommunication::getLatencySummary() const
+{
+    qint64 bytesIn = gcodeCompactor.getBytesIn();
+    double savedPercent = bytesIn > 0 ? 100.0 * gcodeCompactor.getBytesSaved() / bytesIn : 0.0;
+    
+    return QString("Kuyruk bekleme (us): %1 | Ack gecikmesi (us): %2 | Yoldaki bayt: %3 | Yazım başına satır: %4 | Sıkıştırma: %5 bayt (%%6)")
+        .arg(queueWaitHistogram.summary())
+        .arg(ackLatencyHistogram.summary())
+        .arg(bytesInFlightHistogram.summary())
+        .arg(batchSizeHistogram.summary())
+        .arg(gcodeCompactor.getBytesSaved())
+        .arg(savedPercent, 0, 'f', 1)
+        + getLaneSummary();
+}
+
+QString SerialCommunication::getLaneSummary() const
+{
+    // Yalnızca kullanılan şeritler: " | jog: derinlik=0 (en çok 3) bekletme=2 bekleme(us) p50=.. p99=.."
+    QString summary;
+    for (int lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        const LaneStatistics &statistics = laneStatistics[lane];
+        if (statistics.sent == 0 && statistics.queued == 0) {
+            continue;
+        }
+        summary += QString(" | %1: derinlik=%2 (en çok %3) gönderilen=%4 bekletme=%5 bekleme(us) p50=%6 p99=%7")
+            .arg(laneName(static_cast<CommandLane>(lane)))
+            .arg(statistics.queued)
+            .arg(statistics.maxQueued)
+            .arg(statistics.sent)
+            .arg(statistics.heldCount)
+            .arg(laneQueueWait[lane].percentile(50.0))
+            .arg(laneQueueWait[lane].percentile(99.0));
+    }
+    return summary;
+}
+
+void SerialCommunication::setLatencySummaryInterval(int milliseconds)
+{
+    if (milliseconds <= 0) {
+        latencySummaryTimer->stop();
+        latencySummaryTimer->setInterval(0);
+        return;
+    }
+    
+    latencySummaryTimer->setInterval(milliseconds);
+    if (isConnected()) {
+        latencySummaryTimer->start();
+    }
+}
+
+void SerialCommunication::setGCodeCompactionEnabled(bool enabled)
+{
+    gcodeCompactionEnabled = enabled;
+    gcodeCompactor.invalidate();
+}
+
+bool SerialCommunication::isGCodeCompactionEnabled() const
+{
+    return gcodeCompactionEnabled;
+}
+
+void SerialCommunication::setCompactionDecimals(int mmDecimals, int inchDecimals)
+{
+    gcodeCompactor.setDecimals(mmDecimals, inchDecimals);
+}
+
+qint64 SerialCommunication::getCompactionBytesSaved() const
+{
+    return gcodeCompactor.getBytesSaved();
+}
+
+const GCodeCompactor &SerialCommunication::getGCodeCompactor() const
+{
+    return gcodeCompactor;
+}
+
+bool SerialCommunication::startTrafficCapture(const QString &filePath)
+{
+    if (!trafficRecorder.open(filePath, monotonicClock.nsecsElapsed())) {
+        emit errorOccurred("Trafik kaydı açılamadı: " + trafficRecorder.errorString());
+        return false;
+    }
+    
+    trafficFlushTimer->start();
+    LOG_INFO("Trafik kaydı başladı: " + filePath, LogCategories::SERIAL);
+    if (isConnected()) {
+        addTrafficMarker("connected " + getTransportDescription());
+    }
+    return true;
+}
+
+void SerialCommunication::stopTrafficCapture()
+{
+    trafficFlushTimer->stop();
+    if (trafficRecorder.isOpen()) {
+        LOG_INFO(QString("Trafik kaydı bitti: %1 kayıt, %2 bayt")
+                 .arg(trafficRecorder.getRecordCount()).arg(trafficRecorder.getBytesWritten()),
+                 LogCategories::SERIAL);
+        trafficRecorder.close();
+    }
+}
+
+bool SerialCommunication::isTrafficCaptureActive() const
+{
+    return trafficRecorder.isOpen();
+}
+
+void SerialCommunication::addTrafficMarker(const QString &text)
+{
+    trafficRecorder.record(TrafficDirection::Marker, monotonicClock.nsecsElapsed(), text.toUtf8());
+}
+
+TelemetryRecorder *SerialCommunication::getTelemetryRecorder()
+{
+    return &telemetryRecorder;
+}
+
+void SerialCommunication::logLatencySummary()
+{
+    // Son özetten beri yeni komut yoksa log'u kirletme
+    if (ackLatencyHistogram.count() == lastSummarizedCount) {
+        return;
+    }
+    
+    lastSummarizedCount = ackLatencyHistogram.count();
+    LOG_INFO(getLatencySummary(), LogCategories::SERIAL);
+}
+
+void SerialCommunication::parseStatusResponse(const QString &response)
+{
+    // GRBL status response parsing
+    if (!response.startsWith("<") || !response.endsWith(">")) {
+        return;
+    }
+    
+    // GRBL 1.1 formatı: <Idle|MPos:0.000,0.000,0.000|Bf:15,128|FS:0,0>
+    // Eski 0.9 formatı: <Idle,MPos:0.000,0.000,0.000,WPos:0.000,0.000,0.000>
+    QString body = response.mid(1, response.length() - 2);
+    QStringList fields = body.contains('|') ? body.split('|') : QStringList{body};
+    if (fields.isEmpty()) {
+        return;
+    }
+    
+    GrblStatusReport report = lastStatusReport;
+    report.state = fields[0].section(':', 0, 0).section(',', 0, 0);
+    bool hasSubState = false;
+    int subState = fields[0].section(',', 0, 0).section(':', 1, 1).toInt(&hasSubState);
+    report.subState = hasSubState ? subState : -1;
+    report.timestampMs = monotonicClock.elapsed();
+    bool hasMachinePosition = false;
+    bool hasWorkPosition = false;
+    
+    for (const QString &field : fields) {
+        int colon = field.indexOf(':');
+        if (colon == -1) {
+            continue;
+        }
+        QString key = field.left(colon);
+        QStringList values = field.mid(colon + 1).split(',');
+        
+        if (key == "MPos" && values.size() >= 3) {
+            report.mposX = values[0].toDouble();
+            report.mposY = values[1].toDouble();
+            report.mposZ = values[2].toDouble();
+            hasMachinePosition = true;
+        } else if (key == "WPos" && values.size() >= 3) {
+            report.wposX = values[0].toDouble();
+            report.wposY = values[1].toDouble();
+            report.wposZ = values[2].toDouble();
+            hasWorkPosition = true;
+        } else if (key == "WCO" && values.size() >= 3) {
+            report.wcoX = values[0].toDouble();
+            report.wcoY = values[1].toDouble();
+            report.wcoZ = values[2].toDouble();
+        } else if (key == "Bf" && values.size() >= 2) {
+            report.plannerBlocksAvailable = values[0].toInt();
+            report.rxBytesAvailable = values[1].toInt();
+        } else if (key == "FS" && values.size() >= 2) {
+            report.feedRate = values[0].toDouble();
+            report.spindleSpeed = values[1].toDouble();
+        } else if (key == "F" && !values.isEmpty()) {
+            report.feedRate = values[0].toDouble();
+        }
+    }
+    
+    // Eski format: MPos alanı virgülle ayrılmış gövdenin içinde
+    if (!hasMachinePosition && !hasWorkPosition) {
+        static const QRegularExpression legacyPosRegex(R"(MPos:(-?[\d.]+),(-?[\d.]+),(-?[\d.]+))");
+        QRegularExpressionMatch match = legacyPosRegex.match(body);
+        if (match.hasMatch()) {
+            report.mposX = match.captured(1).toDouble();
+            report.mposY = match.captured(2).toDouble();
+            report.mposZ = match.captured(3).toDouble();
+            hasMachinePosition = true;
+        }
+    }
+    
+    // Raporda tek konum gelir; diğeri son bilinen WCO ile türetilir
+    if (hasMachinePosition) {
+        report.wposX = report.mposX - report.wcoX;
+        report.wposY = report.mposY - report.wcoY;
+        report.wposZ = report.mposZ - report.wcoZ;
+    } else if (hasWorkPosition) {
+        report.mposX = report.wposX + report.wcoX;
+        report.mposY = report.wposY + report.wcoY;
+        report.mposZ = report.wposZ + report.wcoZ;
+    }
+    bool hasPosition = hasMachinePosition || hasWorkPosition;
+    
+    // Yanıt geldi: sorgulama hızını bağlantı gecikmesine göre toparla
+    qint64 latency = report.timestampMs - statusRequestSentMs;
+    statusRequestPending = false;
+    if (statusBackoffFactor > 1 && latency < statusTimer->interval() / 2) {
+        statusBackoffFactor /= 2;
+    }
+    
+    GrblStatusReport previous = lastStatusReport;
+    lastStatusReport = report;
+    machineState = report.state;
+    lastHeartbeatMs = report.timestampMs;
+    recordTelemetry(report);
+    updatePlannedMotion(report, hasPosition);
+    updateSafetyWatchdog(true);
+    updatePlannerFlowControl(previous, report);
+    updateStatusPollInterval();
+    
+    // Durum değişikliği bekletilen şeridi (örn. Idle'ı bekleyen jog) serbest bırakabilir
+    if (report.state != previous.state) {
+        sendNextCommand();
+    }
+    
+    emit statusUpdated(report.state);
+    if (hasPosition) {
+        emit positionUpdated(report.mposX, report.mposY, report.mposZ);
+    }
+    emit statusReportReceived(report);
 }
 
 void SerialCommunication::parsePositionResponse(const QString &response)
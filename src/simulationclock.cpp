@@ -0,0 +1,154 @@
+#include "simulationclock.h"
+#include <QtGlobal>
+
+namespace {
+    const qint64 DEFAULT_STEP_NS = 1000000;    // 1 ms
+    const int DEFAULT_FRAME_MS = 20;           // 50 Hz
+    const int DEFAULT_MAX_CATCH_UP_STEPS = 1000;
+}
+
+SimulationClock::SimulationClock(QObject *parent)
+    : QObject(parent)
+    , wakeTimer(new QTimer(this))
+    , mode(Mode::RealTime)
+    , running(false)
+    , stepDuration(DEFAULT_STEP_NS)
+    , accumulator(0)
+    , stepCount(0)
+    , droppedSteps(0)
+    , maxCatchUpSteps(DEFAULT_MAX_CATCH_UP_STEPS)
+{
+    wakeTimer->setInterval(DEFAULT_FRAME_MS);
+    wakeTimer->setTimerType(Qt::PreciseTimer);
+    connect(wakeTimer, &QTimer::timeout, this, &SimulationClock::onWake);
+}
+
+void SimulationClock::setMode(Mode newMode)
+{
+    if (mode == newMode) {
+        return;
+    }
+    
+    mode = newMode;
+    if (running) {
+        // Yeni modda temiz başla: biriken duvar saati süresi taşınmaz
+        stop();
+        start();
+    }
+}
+
+SimulationClock::Mode SimulationClock::getMode() const
+{
+    return mode;
+}
+
+void SimulationClock::setStepInterval(double seconds)
+{
+    if (seconds > 0.0) {
+        stepDuration = std::chrono::nanoseconds(qMax<qint64>(1, qRound64(seconds * 1e9)));
+    }
+}
+
+double SimulationClock::getStepInterval() const
+{
+    return stepDuration.count() / 1e9;
+}
+
+void SimulationClock::setFrameInterval(int milliseconds)
+{
+    wakeTimer->setInterval(qMax(1, milliseconds));
+}
+
+void SimulationClock::setMaxCatchUpSteps(int steps)
+{
+    maxCatchUpSteps = qMax(1, steps);
+}
+
+void SimulationClock::start()
+{
+    if (running) {
+        return;
+    }
+    
+    // Durgun geçen süre telafi edilmez
+    running = true;
+    accumulator = std::chrono::nanoseconds(0);
+    lastWake = std::chrono::steady_clock::now();
+    if (mode == Mode::RealTime) {
+        wakeTimer->start();
+    }
+}
+
+void SimulationClock::stop()
+{
+    wakeTimer->stop();
+    running = false;
+    accumulator = std::chrono::nanoseconds(0);
+}
+
+bool SimulationClock::isRunning() const
+{
+    return running;
+}
+
+double SimulationClock::advance(double seconds)
+{
+    if (seconds <= 0.0) {
+        return 0.0;
+    }
+    
+    quint64 count = static_cast<quint64>(qRound64(seconds * 1e9 / stepDuration.count()));
+    runSteps(count);
+    emit frameAdvanced(getSimulationTime());
+    return count * getStepInterval();
+}
+
+double SimulationClock::getSimulationTime() const
+{
+    return stepCount * getStepInterval();
+}
+
+quint64 SimulationClock::getStepCount() const
+{
+    return stepCount;
+}
+
+quint64 SimulationClock::getDroppedSteps() const
+{
+    return droppedSteps;
+}
+
+void SimulationClock::onWake()
+{
+    if (!running || mode != Mode::RealTime) {
+        return;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    accumulator += std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastWake);
+    lastWake = now;
+    
+    quint64 due = static_cast<quint64>(accumulator / stepDuration);
+    accumulator -= stepDuration * static_cast<qint64>(due);
+    
+    // Uzun bir donmadan sonra (hata ayıklayıcı, uyku) simülasyonu yetiştirmeye
+    // çalışıp olay döngüsünü kilitlemek yerine fazlası atılır
+    if (due > static_cast<quint64>(maxCatchUpSteps)) {
+        droppedSteps += due - maxCatchUpSteps;
+        due = maxCatchUpSteps;
+    }
+    
+    if (due > 0) {
+        runSteps(due);
+        emit frameAdvanced(getSimulationTime());
+    }
+}
+
+void SimulationClock::runSteps(quint64 count)
+{
+    const double dt = getStepInterval();
+    for (quint64 i = 0; i < count; ++i) {
+        ++stepCount;
+        emit stepped(dt);
+    }
+}
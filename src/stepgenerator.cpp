@@ -0,0 +1,353 @@
+#include "stepgenerator.h"
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // GRBL 1.1 varsayılanları ($100, $110, $120, $11) ve stepper.c sabitleri
+    const double DEFAULT_STEPS_PER_MM = 250.0;
+    const double DEFAULT_MAX_RATE = 500.0;          // mm/min
+    const double DEFAULT_ACCELERATION = 10.0;       // mm/s²
+    const double DEFAULT_JUNCTION_DEVIATION = 0.01; // mm
+    const double DEFAULT_SEGMENT_TIME = 0.01;       // ACCELERATION_TICKS_PER_SECOND = 100
+    const int MAX_AMASS_LEVEL = 3;
+    const double AMASS_LEVEL1_RATE = 8000.0;        // Hz; altında kesme frekansı 2x
+    const double AMASS_LEVEL2_RATE = 4000.0;        // 4x
+    const double AMASS_LEVEL3_RATE = 2000.0;        // 8x
+    const double MIN_BLOCK_LENGTH = 1e-9;           // mm
+    
+    // Planlanmış blok; hızlar karesiyle tutulur (GRBL planner.c gibi)
+    struct PlannedBlock {
+        double unit[StepGenerator::AXIS_COUNT];
+        double length;          // mm
+        double nominalSpeed;    // mm/s
+        double acceleration;    // mm/s²
+        double maxEntrySqr;
+        double entrySqr;
+        qint64 steps[StepGenerator::AXIS_COUNT];
+        qint64 stepEventCount;
+        int lineNumber;
+    };
+    
+    // Bresenham: n ana eksen olayından sonra eksenin attığı adım. GRBL sayacı
+    // step_event_count/2'den başlatır ve AMASS için adımları 2^3 ile ölçekler.
+    qint64 bresenhamSteps(qint64 events, qint64 axisSteps, qint64 stepEventCount)
+    {
+        if (stepEventCount <= 0 || axisSteps <= 0) {
+            return 0;
+        }
+        qint64 scaled = stepEventCount << MAX_AMASS_LEVEL;
+        return ((scaled >> 1) + events * (axisSteps << MAX_AMASS_LEVEL) - 1) / scaled;
+    }
+}
+
+StepGenerator::StepGenerator()
+    : junctionDeviation(DEFAULT_JUNCTION_DEVIATION)
+    , segmentTime(DEFAULT_SEGMENT_TIME)
+    , stepRateCeiling(DEFAULT_STEP_RATE_CEILING)
+    , recordSegments(false)
+{
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        stepsPerMm[axis] = DEFAULT_STEPS_PER_MM;
+        maxRate[axis] = DEFAULT_MAX_RATE;
+        acceleration[axis] = DEFAULT_ACCELERATION;
+    }
+}
+
+void StepGenerator::setAxis(int axis, double steps, double rate, double accel)
+{
+    if (axis < 0 || axis >= AXIS_COUNT) {
+        return;
+    }
+    
+    if (steps > 0.0) {
+        stepsPerMm[axis] = steps;
+    }
+    if (rate > 0.0) {
+        maxRate[axis] = rate;
+    }
+    if (accel > 0.0) {
+        acceleration[axis] = accel;
+    }
+}
+
+double StepGenerator::getStepsPerMm(int axis) const
+{
+    return (axis >= 0 && axis < AXIS_COUNT) ? stepsPerMm[axis] : 0.0;
+}
+
+void StepGenerator::setJunctionDeviation(double mm)
+{
+    junctionDeviation = qMax(0.0, mm);
+}
+
+void StepGenerator::setSegmentTime(double seconds)
+{
+    if (seconds > 0.0) {
+        segmentTime = seconds;
+    }
+}
+
+void StepGenerator::setStepRateCeiling(double hz)
+{
+    stepRateCeiling = hz;
+}
+
+double StepGenerator::getStepRateCeiling() const
+{
+    return stepRateCeiling;
+}
+
+void StepGenerator::setRecordSegments(bool enabled)
+{
+    recordSegments = enabled;
+}
+
+int StepGenerator::amassLevel(double dominantRate)
+{
+    if (dominantRate > AMASS_LEVEL1_RATE) {
+        return 0;
+    }
+    if (dominantRate > AMASS_LEVEL2_RATE) {
+        return 1;
+    }
+    if (dominantRate > AMASS_LEVEL3_RATE) {
+        return 2;
+    }
+    return MAX_AMASS_LEVEL;
+}
+
+StepRateReport StepGenerator::analyze(const double startPosition[AXIS_COUNT], const QVector<StepBlock> &blocks) const
+{
+    StepRateReport report;
+    report.stepRateCeiling = stepRateCeiling;
+    report.totalTime = 0.0;
+    report.segmentCount = 0;
+    report.peakIsrRate = 0.0;
+    report.peakLineNumber = -1;
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        report.totalSteps[axis] = 0;
+        report.peakStepRate[axis] = 0.0;
+    }
+    
+    // 1) Planlayıcı: birim vektör, izdüşürülmüş limitler ve birleşim hızı sınırı
+    QVector<PlannedBlock> planned;
+    planned.reserve(blocks.size());
+    double position[AXIS_COUNT];
+    qint64 stepPosition[AXIS_COUNT];
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        position[axis] = startPosition[axis];
+        stepPosition[axis] = std::llround(startPosition[axis] * stepsPerMm[axis]);
+    }
+    
+    for (const StepBlock &block : blocks) {
+        PlannedBlock plan;
+        plan.lineNumber = block.lineNumber;
+        plan.length = 0.0;
+        plan.stepEventCount = 0;
+        for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+            double delta = block.target[axis] - position[axis];
+            plan.unit[axis] = delta;
+            plan.length += delta * delta;
+            
+            qint64 targetSteps = std::llround(block.target[axis] * stepsPerMm[axis]);
+            plan.steps[axis] = qAbs(targetSteps - stepPosition[axis]);
+            plan.stepEventCount = qMax(plan.stepEventCount, plan.steps[axis]);
+            stepPosition[axis] = targetSteps;
+            position[axis] = block.target[axis];
+        }
+        plan.length = std::sqrt(plan.length);
+        if (plan.length < MIN_BLOCK_LENGTH) {
+            continue;
+        }
+        
+        // Besleme yoksa (GRBL bunu reddeder) rapid gibi eksen limitleri uygulanır
+        plan.nominalSpeed = (!block.rapid && block.feedRate > 0.0) ? block.feedRate / 60.0
+                                                                   : std::numeric_limits<double>::max();
+        plan.acceleration = std::numeric_limits<double>::max();
+        for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+            plan.unit[axis] /= plan.length;
+            double component = qAbs(plan.unit[axis]);
+            if (component > 0.0) {
+                plan.nominalSpeed = qMin(plan.nominalSpeed, maxRate[axis] / 60.0 / component);
+                plan.acceleration = qMin(plan.acceleration, acceleration[axis] / component);
+            }
+        }
+        
+        plan.maxEntrySqr = 0.0;
+        if (!planned.isEmpty()) {
+            const PlannedBlock &previous = planned.last();
+            double cosTheta = 0.0;
+            double junction[AXIS_COUNT];
+            double junctionLength = 0.0;
+            for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+                cosTheta -= previous.unit[axis] * plan.unit[axis];
+                junction[axis] = plan.unit[axis] - previous.unit[axis];
+                junctionLength += junction[axis] * junction[axis];
+            }
+            junctionLength = std::sqrt(junctionLength);
+            
+            double junctionSqr;
+            if (cosTheta > 0.999999) {
+                junctionSqr = 0.0;      // Geri dönüş: dur
+            } else if (cosTheta < -0.999999 || junctionLength <= 0.0) {
+                junctionSqr = std::numeric_limits<double>::max();  // Düz devam
+            } else {
+                // Birleşim ivmesi birleşim vektörüne izdüşürülür (planner.c)
+                double junctionAcceleration = std::numeric_limits<double>::max();
+                for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+                    double component = qAbs(junction[axis]) / junctionLength;
+                    if (component > 0.0) {
+                        junctionAcceleration = qMin(junctionAcceleration, acceleration[axis] / component);
+                    }
+                }
+                double sinHalf = std::sqrt(0.5 * (1.0 - cosTheta));
+                junctionSqr = junctionAcceleration * junctionDeviation * sinHalf / (1.0 - sinHalf);
+            }
+            plan.maxEntrySqr = qMin(junctionSqr, qMin(previous.nominalSpeed * previous.nominalSpeed,
+                                                      plan.nominalSpeed * plan.nominalSpeed));
+        }
+        plan.entrySqr = plan.maxEntrySqr;
+        planned.append(plan);
+    }
+    
+    // 2) Geri geçiş: her blok bir sonrakinin girişine yavaşlayabilmeli; program sonunda dur
+    double exitSqr = 0.0;
+    for (int i = planned.size() - 1; i >= 0; --i) {
+        PlannedBlock &plan = planned[i];
+        plan.entrySqr = qMin(plan.maxEntrySqr, exitSqr + 2.0 * plan.acceleration * plan.length);
+        exitSqr = plan.entrySqr;
+    }
+    // 3) İleri geçiş: giriş hızı önceki bloğun ulaşabildiğini aşamaz
+    for (int i = 0; i + 1 < planned.size(); ++i) {
+        double reachable = planned[i].entrySqr + 2.0 * planned[i].acceleration * planned[i].length;
+        planned[i + 1].entrySqr = qMin(planned[i + 1].entrySqr, reachable);
+    }
+    
+    // 4) Segment hazırlayıcı: yamuk profili sabit sürelerle dilimle
+    double clock = 0.0;
+    for (int i = 0; i < planned.size(); ++i) {
+        const PlannedBlock &plan = planned[i];
+        const double a = plan.acceleration;
+        const double entry = std::sqrt(plan.entrySqr);
+        const double exit = (i + 1 < planned.size()) ? std::sqrt(planned[i + 1].entrySqr) : 0.0;
+        
+        double peak = plan.nominalSpeed;
+        double accelDistance = (peak * peak - entry * entry) / (2.0 * a);
+        double decelDistance = (peak * peak - exit * exit) / (2.0 * a);
+        if (accelDistance + decelDistance > plan.length) {
+            // Tepe hıza ulaşılamıyor: üçgen profil
+            double peakSqr = (2.0 * a * plan.length + entry * entry + exit * exit) / 2.0;
+            peak = std::sqrt(qMax(peakSqr, qMax(entry * entry, exit * exit)));
+            accelDistance = qBound(0.0, (peak * peak - entry * entry) / (2.0 * a), plan.length);
+            decelDistance = plan.length - accelDistance;
+        }
+        const double accelTime = (peak - entry) / a;
+        const double cruiseTime = (plan.length - accelDistance - decelDistance) / peak;
+        const double decelTime = (peak - exit) / a;
+        const double blockTime = accelTime + cruiseTime + decelTime;
+        
+        auto distanceAt = [&](double t) {
+            if (t <= accelTime) {
+                return entry * t + a * t * t / 2.0;
+            }
+            t -= accelTime;
+            if (t <= cruiseTime) {
+                return accelDistance + peak * t;
+            }
+            t = qMin(t - cruiseTime, decelTime);
+            return accelDistance + peak * cruiseTime + peak * t - a * t * t / 2.0;
+        };
+        
+        // Aynı satırın ardışık blokları (yay parçaları) tek raporda toplanır
+        if (report.lines.isEmpty() || report.lines.last().lineNumber != plan.lineNumber) {
+            StepLineReport line;
+            line.lineNumber = plan.lineNumber;
+            line.startTime = clock;
+            line.duration = 0.0;
+            line.peakIsrRate = 0.0;
+            for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+                line.steps[axis] = 0;
+                line.peakStepRate[axis] = 0.0;
+            }
+            report.lines.append(line);
+        }
+        StepLineReport &line = report.lines.last();
+        
+        int dominantAxis = 0;
+        for (int axis = 1; axis < AXIS_COUNT; ++axis) {
+            if (plan.steps[axis] > plan.steps[dominantAxis]) {
+                dominantAxis = axis;
+            }
+        }
+        
+        const qint64 segmentCount = qMax<qint64>(1, static_cast<qint64>(std::ceil(blockTime / segmentTime - 1e-9)));
+        double previousDistance = 0.0;
+        qint64 previousEvents = 0;
+        for (qint64 k = 0; k < segmentCount; ++k) {
+            double t0 = k * segmentTime;
+            double t1 = (k + 1 == segmentCount) ? blockTime : (k + 1) * segmentTime;
+            double dt = t1 - t0;
+            double distance = (k + 1 == segmentCount) ? plan.length : distanceAt(t1);
+            double fraction = (distance - previousDistance) / plan.length;
+            qint64 events = (k + 1 == segmentCount) ? plan.stepEventCount
+                                                    : std::llround(plan.stepEventCount * distance / plan.length);
+            
+            // Frekans kesirli adımla hesaplanır (GRBL kalan adım kesrini taşır); tamsayı
+            // adımlar yalnızca sayım içindir, yuvarlama titreşimi frekansa karışmaz
+            StepSegment segment;
+            segment.lineNumber = plan.lineNumber;
+            segment.startTime = clock + t0;
+            segment.duration = dt;
+            segment.dominantRate = dt > 0.0 ? plan.stepEventCount * fraction / dt : 0.0;
+            segment.amassLevel = amassLevel(segment.dominantRate);
+            segment.isrRate = segment.dominantRate * (1 << segment.amassLevel);
+            for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+                segment.steps[axis] = static_cast<int>(bresenhamSteps(events, plan.steps[axis], plan.stepEventCount)
+                                                       - bresenhamSteps(previousEvents, plan.steps[axis], plan.stepEventCount));
+                segment.stepRate[axis] = dt > 0.0 ? plan.steps[axis] * fraction / dt : 0.0;
+                line.steps[axis] += segment.steps[axis];
+                report.totalSteps[axis] += segment.steps[axis];
+                line.peakStepRate[axis] = qMax(line.peakStepRate[axis], segment.stepRate[axis]);
+                report.peakStepRate[axis] = qMax(report.peakStepRate[axis], segment.stepRate[axis]);
+            }
+            if (plan.stepEventCount == 0) {
+                segment.isrRate = 0.0;
+            }
+            
+            line.peakIsrRate = qMax(line.peakIsrRate, segment.isrRate);
+            if (segment.isrRate > report.peakIsrRate) {
+                report.peakIsrRate = segment.isrRate;
+                report.peakLineNumber = plan.lineNumber;
+            }
+            
+            if (segment.isrRate > stepRateCeiling) {
+                bool contiguous = !report.violations.isEmpty()
+                    && report.violations.last().lineNumber == plan.lineNumber
+                    && qAbs(report.violations.last().endTime - segment.startTime) < 1e-9;
+                if (contiguous) {
+                    StepRateViolation &violation = report.violations.last();
+                    violation.endTime = segment.startTime + dt;
+                    violation.peakIsrRate = qMax(violation.peakIsrRate, segment.isrRate);
+                } else {
+                    report.violations.append(StepRateViolation{plan.lineNumber, segment.startTime,
+                                                               segment.startTime + dt, segment.isrRate,
+                                                               dominantAxis});
+                }
+            }
+            
+            if (recordSegments) {
+                report.segments.append(segment);
+            }
+            previousDistance = distance;
+            previousEvents = events;
+        }
+        
+        report.segmentCount += segmentCount;
+        line.duration += blockTime;
+        clock += blockTime;
+    }
+    
+    report.totalTime = clock;
+    return report;
+}
@@ -0,0 +1,342 @@
+#include "telemetryrecorder.h"
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+    const char TELEMETRY_MAGIC[8] = {'C', 'N', 'C', 'T', 'L', 'M', '0', '1'};
+    const quint32 TELEMETRY_VERSION = 1;
+    const int SAMPLE_WIRE_SIZE = 28;
+    const int EXPORT_CHUNK_SAMPLES = 4096;
+    
+    // Sıra TelemetryState ile aynı
+    const char *const STATE_NAMES[] = {
+        "Unknown", "Idle", "Run", "Hold", "Jog", "Home", "Alarm", "Door", "Check", "Sleep"
+    };
+    
+    void appendFloat(QByteArray &out, float value)
+    {
+        quint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        char buffer[4];
+        qToLittleEndian<quint32>(bits, buffer);
+        out.append(buffer, 4);
+    }
+}
+
+TelemetryRecorder::TelemetryRecorder(int capacity)
+    : blockCount(qMax(1, (qMax(capacity, 1) + BLOCK_SIZE - 1) / BLOCK_SIZE))
+    , blocks(new TelemetrySample *[blockCount])
+    , writeIndex(0)
+    , originMs(-1)
+    , originEpochMs(0)
+    , allocatedBlocks(0)
+{
+    for (int i = 0; i < blockCount; ++i) {
+        blocks[i] = nullptr;
+    }
+}
+
+TelemetryRecorder::~TelemetryRecorder()
+{
+    for (int i = 0; i < blockCount; ++i) {
+        delete[] blocks[i];
+    }
+    delete[] blocks;
+}
+
+void TelemetryRecorder::record(qint64 monotonicMs, const TelemetrySample &sample)
+{
+    qint64 origin = originMs.load(std::memory_order_relaxed);
+    if (origin < 0) {
+        origin = monotonicMs;
+        originEpochMs.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+        originMs.store(origin, std::memory_order_relaxed);
+    }
+    
+    quint64 index = writeIndex.load(std::memory_order_relaxed);
+    quint64 position = index % static_cast<quint64>(capacity());
+    int block = static_cast<int>(position / BLOCK_SIZE);
+    if (!blocks[block]) {
+        // Okuyucular bu bloğa ancak yayınlanan sayaçtan sonra bakar; release yeterli
+        blocks[block] = new TelemetrySample[BLOCK_SIZE];
+        allocatedBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    TelemetrySample &target = blocks[block][position % BLOCK_SIZE];
+    target = sample;
+    target.timeMs = static_cast<quint32>(qBound<qint64>(0, monotonicMs - origin, 0xFFFFFFFFLL));
+    writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void TelemetryRecorder::clear()
+{
+    writeIndex.store(0, std::memory_order_release);
+    originMs.store(-1, std::memory_order_relaxed);
+    originEpochMs.store(0, std::memory_order_relaxed);
+}
+
+int TelemetryRecorder::capacity() const
+{
+    return blockCount * BLOCK_SIZE;
+}
+
+int TelemetryRecorder::size() const
+{
+    return static_cast<int>(qMin<quint64>(writeIndex.load(std::memory_order_acquire), capacity()));
+}
+
+quint64 TelemetryRecorder::totalRecorded() const
+{
+    return writeIndex.load(std::memory_order_acquire);
+}
+
+qint64 TelemetryRecorder::memoryBytes() const
+{
+    return static_cast<qint64>(allocatedBlocks.load(std::memory_order_relaxed)) * BLOCK_SIZE
+        * static_cast<qint64>(sizeof(TelemetrySample));
+}
+
+qint64 TelemetryRecorder::startEpochMs() const
+{
+    return originEpochMs.load(std::memory_order_relaxed);
+}
+
+quint32 TelemetryRecorder::latestTimeMs() const
+{
+    quint64 written = writeIndex.load(std::memory_order_acquire);
+    return written > 0 ? slot(written - 1).timeMs : 0;
+}
+
+const TelemetrySample &TelemetryRecorder::slot(quint64 index) const
+{
+    quint64 position = index % static_cast<quint64>(capacity());
+    return blocks[position / BLOCK_SIZE][position % BLOCK_SIZE];
+}
+
+quint64 TelemetryRecorder::firstValidIndex(quint64 written) const
+{
+    // Yazar written numaralı örneği yazıyor olabilir: onun eski yuvası da geçersiz
+    quint64 cap = static_cast<quint64>(capacity());
+    return written >= cap ? written - cap + 1 : 0;
+}
+
+quint64 TelemetryRecorder::lowerBound(quint64 first, quint64 last, quint32 timeMs) const
+{
+    // Zaman damgaları yazım sırasıyla artar: ikili arama
+    while (first < last) {
+        quint64 middle = first + (last - first) / 2;
+        if (slot(middle).timeMs < timeMs) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+QVector<TelemetrySample> TelemetryRecorder::samples(quint32 fromMs, quint32 toMs) const
+{
+    QVector<TelemetrySample> result;
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        quint64 written = writeIndex.load(std::memory_order_acquire);
+        quint64 first = lowerBound(firstValidIndex(written), written, fromMs);
+        
+        result.clear();
+        for (quint64 index = first; index < written; ++index) {
+            const TelemetrySample &sample = slot(index);
+            if (sample.timeMs > toMs) {
+                break;
+            }
+            result.append(sample);
+        }
+        
+        // Kopyalama sırasında halka döndüyse baştaki örnekler bozulmuş olabilir
+        quint64 valid = firstValidIndex(writeIndex.load(std::memory_order_acquire));
+        if (valid <= first) {
+            return result;
+        }
+        if (valid - first < static_cast<quint64>(result.size())) {
+            result.remove(0, static_cast<int>(valid - first));
+            return result;
+        }
+    }
+    return result;
+}
+
+QVector<TelemetryBucket> TelemetryRecorder::decimate(quint32 fromMs, quint32 toMs, int bucketCount) const
+{
+    QVector<TelemetryBucket> buckets;
+    if (bucketCount <= 0 || toMs < fromMs) {
+        return buckets;
+    }
+    
+    const quint64 span = static_cast<quint64>(toMs - fromMs) + 1;
+    buckets.resize(bucketCount);
+    for (int i = 0; i < bucketCount; ++i) {
+        TelemetryBucket &bucket = buckets[i];
+        std::memset(&bucket, 0, sizeof(bucket));
+        bucket.startMs = fromMs + static_cast<quint32>(span * i / bucketCount);
+        bucket.endMs = fromMs + static_cast<quint32>(span * (i + 1) / bucketCount) - 1;
+    }
+    
+    // Kopya almadan doğrudan halka üzerinde tek geçiş; kapasite kadar örnekte bile
+    // bellek ayrılmaz. Geçiş sırasında halka döndüyse geçerli aralıktan tekrarlanır.
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        quint64 written = writeIndex.load(std::memory_order_acquire);
+        quint64 first = lowerBound(firstValidIndex(written), written, fromMs);
+        
+        for (TelemetryBucket &bucket : buckets) {
+            bucket.sampleCount = 0;
+        }
+        for (quint64 index = first; index < written; ++index) {
+            const TelemetrySample &sample = slot(index);
+            if (sample.timeMs > toMs) {
+                break;
+            }
+            if (sample.timeMs < fromMs) {
+                continue; // Yazarla yarışan eski yuva; geçiş sonunda ayıklanır
+            }
+            int b = static_cast<int>(static_cast<quint64>(sample.timeMs - fromMs) * bucketCount / span);
+            TelemetryBucket &bucket = buckets[qMin(b, bucketCount - 1)];
+            if (bucket.sampleCount == 0) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    bucket.minPos[axis] = bucket.maxPos[axis] = sample.mpos[axis];
+                }
+                bucket.minFeed = bucket.maxFeed = sample.feedRate;
+                bucket.minSpindle = bucket.maxSpindle = sample.spindleSpeed;
+                bucket.minPlannerBlocks = sample.plannerBlocksAvailable;
+                bucket.minRxBytes = sample.rxBytesAvailable;
+            } else {
+                for (int axis = 0; axis < 3; ++axis) {
+                    bucket.minPos[axis] = qMin(bucket.minPos[axis], sample.mpos[axis]);
+                    bucket.maxPos[axis] = qMax(bucket.maxPos[axis], sample.mpos[axis]);
+                }
+                bucket.minFeed = qMin(bucket.minFeed, sample.feedRate);
+                bucket.maxFeed = qMax(bucket.maxFeed, sample.feedRate);
+                bucket.minSpindle = qMin(bucket.minSpindle, sample.spindleSpeed);
+                bucket.maxSpindle = qMax(bucket.maxSpindle, sample.spindleSpeed);
+                // -1 (raporda yok) en küçük değer olarak kalmasın
+                if (sample.plannerBlocksAvailable >= 0
+                    && (bucket.minPlannerBlocks < 0 || sample.plannerBlocksAvailable < bucket.minPlannerBlocks)) {
+                    bucket.minPlannerBlocks = sample.plannerBlocksAvailable;
+                }
+                if (sample.rxBytesAvailable >= 0
+                    && (bucket.minRxBytes < 0 || sample.rxBytesAvailable < bucket.minRxBytes)) {
+                    bucket.minRxBytes = sample.rxBytesAvailable;
+                }
+            }
+            bucket.lastState = sample.state;
+            bucket.sampleCount++;
+        }
+        
+        if (firstValidIndex(writeIndex.load(std::memory_order_acquire)) <= first) {
+            break;
+        }
+    }
+    return buckets;
+}
+
+bool TelemetryRecorder::exportCsv(const QString &filePath, QString *error) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    
+    const QVector<TelemetrySample> data = samples();
+    QTextStream out(&file);
+    out << "# start_epoch_ms=" << startEpochMs() << "\n";
+    out << "time_ms,state,mpos_x,mpos_y,mpos_z,feed,spindle,planner_blocks,rx_bytes\n";
+    for (const TelemetrySample &sample : data) {
+        out << sample.timeMs << ',' << stateName(sample.state) << ','
+            << QString::number(sample.mpos[0], 'f', 3) << ','
+            << QString::number(sample.mpos[1], 'f', 3) << ','
+            << QString::number(sample.mpos[2], 'f', 3) << ','
+            << QString::number(sample.feedRate, 'f', 1) << ','
+            << QString::number(sample.spindleSpeed, 'f', 0) << ','
+            << int(sample.plannerBlocksAvailable) << ',' << int(sample.rxBytesAvailable) << '\n';
+    }
+    out.flush();
+    
+    if (out.status() != QTextStream::Ok) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool TelemetryRecorder::exportBinary(const QString &filePath, QString *error) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    
+    const QVector<TelemetrySample> data = samples();
+    QByteArray header(TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+    char buffer[8];
+    qToLittleEndian<quint32>(TELEMETRY_VERSION, buffer);
+    header.append(buffer, 4);
+    qToLittleEndian<qint64>(startEpochMs(), buffer);
+    header.append(buffer, 8);
+    qToLittleEndian<quint64>(static_cast<quint64>(data.size()), buffer);
+    header.append(buffer, 8);
+    bool ok = file.write(header) == header.size();
+    
+    // Alanlar tek tek little-endian yazılır; yapı dolgusu ve bayt sırası dosyaya sızmaz
+    QByteArray chunk;
+    chunk.reserve(EXPORT_CHUNK_SAMPLES * SAMPLE_WIRE_SIZE);
+    for (int i = 0; i < data.size() && ok; ++i) {
+        const TelemetrySample &sample = data[i];
+        qToLittleEndian<quint32>(sample.timeMs, buffer);
+        chunk.append(buffer, 4);
+        for (int axis = 0; axis < 3; ++axis) {
+            appendFloat(chunk, sample.mpos[axis]);
+        }
+        appendFloat(chunk, sample.feedRate);
+        appendFloat(chunk, sample.spindleSpeed);
+        qToLittleEndian<qint16>(sample.rxBytesAvailable, buffer);
+        chunk.append(buffer, 2);
+        chunk.append(static_cast<char>(sample.plannerBlocksAvailable));
+        chunk.append(static_cast<char>(sample.state));
+        
+        if (chunk.size() >= EXPORT_CHUNK_SAMPLES * SAMPLE_WIRE_SIZE || i == data.size() - 1) {
+            ok = file.write(chunk) == chunk.size();
+            chunk.clear();
+        }
+    }
+    
+    if (!ok && error) {
+        *error = file.errorString();
+    }
+    return ok;
+}
+
+TelemetryState TelemetryRecorder::stateFromString(const QString &state)
+{
+    for (int i = 1; i < static_cast<int>(sizeof(STATE_NAMES) / sizeof(STATE_NAMES[0])); ++i) {
+        if (state == QLatin1String(STATE_NAMES[i])) {
+            return static_cast<TelemetryState>(i);
+        }
+    }
+    return TelemetryState::Unknown;
+}
+
+const char *TelemetryRecorder::stateName(quint8 state)
+{
+    if (state >= sizeof(STATE_NAMES) / sizeof(STATE_NAMES[0])) {
+        return STATE_NAMES[0];
+    }
+    return STATE_NAMES[state];
+}
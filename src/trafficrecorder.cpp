@@ -0,0 +1,236 @@
+#include "trafficrecorder.h"
+#include <QDateTime>
+#include <QtEndian>
+
+namespace {
+    const char CAPTURE_MAGIC[8] = {'C', 'N', 'C', 'C', 'A', 'P', '0', '1'};
+    const quint32 CAPTURE_VERSION = 1;
+    const int FLUSH_THRESHOLD = 4 * 1024;            // 115200 baud'da saniyede birkaç yazım
+    const qint64 FLUSH_INTERVAL_NS = 1000000000LL;  // Düşük trafikte de en geç saniyede bir
+    
+    void appendVarint(QByteArray &out, quint64 value)
+    {
+        do {
+            quint8 byte = value & 0x7F;
+            value >>= 7;
+            if (value) {
+                byte |= 0x80;
+            }
+            out.append(static_cast<char>(byte));
+        } while (value);
+    }
+}
+
+// --- TrafficRecorder ---
+
+TrafficRecorder::TrafficRecorder()
+    : baseNs(0)
+    , lastNs(0)
+    , lastFlushNs(0)
+    , recordCount(0)
+    , bytesWritten(0)
+{
+}
+
+TrafficRecorder::~TrafficRecorder()
+{
+    close();
+}
+
+bool TrafficRecorder::open(const QString &filePath, qint64 startNs)
+{
+    close();
+    
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    
+    QByteArray header(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    char buffer[8];
+    qToLittleEndian<quint32>(CAPTURE_VERSION, buffer);
+    header.append(buffer, 4);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), buffer);
+    header.append(buffer, 8);
+    file.write(header);
+    
+    baseNs = startNs;
+    lastNs = 0;
+    lastFlushNs = 0;
+    recordCount = 0;
+    bytesWritten = header.size();
+    pending.clear();
+    return true;
+}
+
+void TrafficRecorder::close()
+{
+    if (file.isOpen()) {
+        flushPending();
+        file.close();
+    }
+}
+
+bool TrafficRecorder::isOpen() const
+{
+    return file.isOpen();
+}
+
+QString TrafficRecorder::errorString() const
+{
+    return file.errorString();
+}
+
+void TrafficRecorder::record(TrafficDirection direction, qint64 timestampNs, const QByteArray &data)
+{
+    if (!file.isOpen()) {
+        return;
+    }
+    
+    // Saat geri gidemez ama kayıtlar farklı yollardan gelebilir; fark negatif olmasın
+    qint64 relativeNs = qMax(timestampNs - baseNs, lastNs);
+    
+    int before = pending.size();
+    pending.append(static_cast<char>(direction));
+    appendVarint(pending, static_cast<quint64>(relativeNs - lastNs));
+    appendVarint(pending, static_cast<quint64>(data.size()));
+    pending.append(data);
+    
+    lastNs = relativeNs;
+    recordCount++;
+    bytesWritten += pending.size() - before;
+    
+    // İşaretler (bağlantı, reset, iş başlangıcı) çökme sonrası analiz için hemen
+    // diske iner; boşta gelen seyrek status yanıtları da saniyeden fazla bekletilmez
+    if (direction == TrafficDirection::Marker
+        || pending.size() >= FLUSH_THRESHOLD
+        || relativeNs - lastFlushNs >= FLUSH_INTERVAL_NS) {
+        flushPending();
+    }
+}
+
+void TrafficRecorder::flush()
+{
+    if (file.isOpen()) {
+        flushPending();
+    }
+}
+
+qint64 TrafficRecorder::getRecordCount() const
+{
+    return recordCount;
+}
+
+qint64 TrafficRecorder::getBytesWritten() const
+{
+    return bytesWritten;
+}
+
+void TrafficRecorder::flushPending()
+{
+    if (!pending.isEmpty()) {
+        file.write(pending);
+        file.flush();
+        pending.clear();
+    }
+    lastFlushNs = lastNs;
+}
+
+// --- TrafficCaptureReader ---
+
+TrafficCaptureReader::TrafficCaptureReader()
+    : startEpochMs(0)
+    , lastNs(0)
+{
+}
+
+bool TrafficCaptureReader::open(const QString &filePath)
+{
+    close();
+    
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        lastError = file.errorString();
+        return false;
+    }
+    
+    QByteArray header = file.read(sizeof(CAPTURE_MAGIC) + 12);
+    if (header.size() < static_cast<int>(sizeof(CAPTURE_MAGIC) + 12)
+        || !header.startsWith(QByteArray(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)))) {
+        lastError = "Geçersiz yakalama dosyası";
+        file.close();
+        return false;
+    }
+    
+    const char *fields = header.constData() + sizeof(CAPTURE_MAGIC);
+    quint32 version = qFromLittleEndian<quint32>(fields);
+    if (version != CAPTURE_VERSION) {
+        lastError = QString("Desteklenmeyen yakalama sürümü: %1").arg(version);
+        file.close();
+        return false;
+    }
+    
+    startEpochMs = qFromLittleEndian<qint64>(fields + 4);
+    lastNs = 0;
+    return true;
+}
+
+void TrafficCaptureReader::close()
+{
+    if (file.isOpen()) {
+        file.close();
+    }
+}
+
+QString TrafficCaptureReader::errorString() const
+{
+    return lastError;
+}
+
+qint64 TrafficCaptureReader::getCaptureStartEpochMs() const
+{
+    return startEpochMs;
+}
+
+bool TrafficCaptureReader::readNext(TrafficRecord &record)
+{
+    char type;
+    if (!file.getChar(&type)) {
+        return false; // Dosya sonu
+    }
+    
+    quint64 deltaNs = 0;
+    quint64 length = 0;
+    if (!readVarint(deltaNs) || !readVarint(length)) {
+        lastError = "Kesik kayıt";
+        return false;
+    }
+    
+    record.direction = static_cast<TrafficDirection>(type);
+    lastNs += static_cast<qint64>(deltaNs);
+    record.timestampNs = lastNs;
+    record.data = file.read(static_cast<qint64>(length));
+    
+    if (record.data.size() != static_cast<int>(length)) {
+        lastError = "Kesik kayıt";
+        return false;
+    }
+    return true;
+}
+
+bool TrafficCaptureReader::readVarint(quint64 &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        char c;
+        if (!file.getChar(&c)) {
+            return false;
+        }
+        quint8 byte = static_cast<quint8>(c);
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,1150 @@
+#include "virtualgrbl.h"
+#include <QtMath>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // GRBL realtime komutları
+    const char RT_STATUS = '?';
+    const char RT_FEED_HOLD = '!';
+    const char RT_CYCLE_START = '~';
+    const char RT_SOFT_RESET = 0x18;
+    const char RT_JOG_CANCEL = static_cast<char>(0x85);
+    
+    // GRBL hata kodları
+    const int ERROR_EXPECTED_COMMAND_LETTER = 1;
+    const int ERROR_BAD_NUMBER_FORMAT = 2;
+    const int ERROR_INVALID_STATEMENT = 3;
+    const int ERROR_IDLE_ERROR = 8;
+    const int ERROR_SYSTEM_GC_LOCK = 9;
+    const int ERROR_UNSUPPORTED_COMMAND = 20;
+    const int ERROR_UNDEFINED_FEED_RATE = 22;
+    const int ERROR_INVALID_JOG_COMMAND = 16;
+    
+    const QByteArray STARTUP_BANNER = "\r\nGrbl 1.1h ['$' for help]\r\n";
+}
+
+VirtualGrblController::VirtualGrblController(QObject *parent)
+    : QObject(parent)
+    , tickTimer(new QTimer(this))
+    , lastTickUs(0)
+    , running(false)
+    , baudRate(115200)
+    , linkLatencyUs(0)
+    , rxBufferSize(256)     // grbl_ESP32 RX_BUFFER_SIZE
+    , plannerBlockCount(16) // grbl_ESP32 BLOCK_BUFFER_SIZE
+    , inboundWireFreeUs(0)
+    , outboundWireFreeUs(0)
+    , inboundResetPending(false)
+    , blockElapsed(0.0)
+    , holdDecelRemaining(0.0)
+    , motionMode(0)
+    , absoluteMode(true)
+    , inchMode(false)
+    , modalFeedRate(0.0)
+    , spindleSpeed(0.0)
+    , state("Idle")
+    , checkMode(false)
+    , resetAfterResponse(false)
+{
+    tickTimer->setInterval(1);
+    tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(tickTimer, &QTimer::timeout, this, &VirtualGrblController::tick);
+    
+    for (int i = 0; i < 3; ++i) {
+        machinePosition[i] = 0.0;
+        plannerPosition[i] = 0.0;
+    }
+    
+    // Varsayılan GRBL 1.1 ayarları
+    settings = {
+        {0, 10}, {1, 25}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0},
+        {10, 1}, {11, 0.010}, {12, 0.002}, {13, 0},
+        {20, 0}, {21, 0}, {22, 0}, {23, 0}, {24, 25.0}, {25, 500.0}, {26, 250}, {27, 1.0},
+        {30, 1000}, {31, 0}, {32, 0},
+        {100, 250.0}, {101, 250.0}, {102, 250.0},
+        {110, 500.0}, {111, 500.0}, {112, 500.0},
+        {120, 10.0}, {121, 10.0}, {122, 10.0},
+        {130, 200.0}, {131, 200.0}, {132, 200.0}
+    };
+    
+    resetStatistics();
+}
+
+void VirtualGrblController::setBaudRate(int rate)
+{
+    baudRate = qMax(rate, 300);
+}
+
+int VirtualGrblController::getBaudRate() const
+{
+    return baudRate;
+}
+
+void VirtualGrblController::setLinkLatency(int microseconds)
+{
+    linkLatencyUs = qMax(microseconds, 0);
+}
+
+int VirtualGrblController::getLinkLatency() const
+{
+    return linkLatencyUs;
+}
+
+void VirtualGrblController::setRxBufferSize(int bytes)
+{
+    rxBufferSize = qMax(bytes, 16);
+}
+
+int VirtualGrblController::getRxBufferSize() const
+{
+    return rxBufferSize;
+}
+
+void VirtualGrblController::setPlannerBlockCount(int blocks)
+{
+    plannerBlockCount = qMax(blocks, 2);
+}
+
+int VirtualGrblController::getPlannerBlockCount() const
+{
+    return plannerBlockCount;
+}
+
+void VirtualGrblController::setSetting(int number, double value)
+{
+    settings[number] = value;
+}
+
+double VirtualGrblController::getSetting(int number) const
+{
+    return settings.value(number, 0.0);
+}
+
+void VirtualGrblController::start()
+{
+    if (running) {
+        return;
+    }
+    
+    clock.start();
+    lastTickUs = 0;
+    inboundWireFreeUs = 0;
+    outboundWireFreeUs = 0;
+    running = true;
+    tickTimer->start();
+    
+    sendResponse(STARTUP_BANNER);
+}
+
+void VirtualGrblController::stop()
+{
+    tickTimer->stop();
+    running = false;
+    inboundWire.clear();
+    inboundResetPending = false;
+    outboundWire.clear();
+    rxBuffer.clear();
+    planner.clear();
+    blockElapsed = 0.0;
+    holdDecelRemaining = 0.0;
+    setState("Idle");
+}
+
+bool VirtualGrblController::isRunning() const
+{
+    return running;
+}
+
+void VirtualGrblController::receiveBytes(const QByteArray &data)
+{
+    if (!running || data.isEmpty()) {
+        return;
+    }
+    
+    stats.bytesReceived += data.size();
+    enqueueWire(inboundWire, inboundWireFreeUs, data);
+}
+
+QString VirtualGrblController::getState() const
+{
+    return state;
+}
+
+int VirtualGrblController::plannerBlocksAvailable() const
+{
+    // GRBL halka tamponu bir bloğu boş tutar: Bf en fazla BLOCK_BUFFER_SIZE-1 (= $I OPT)
+    return (plannerBlockCount - 1) - planner.size();
+}
+
+int VirtualGrblController::rxBytesAvailable() const
+{
+    return rxBufferSize - rxBuffer.size();
+}
+
+VirtualGrblStatistics VirtualGrblController::getStatistics() const
+{
+    return stats;
+}
+
+void VirtualGrblController::resetStatistics()
+{
+    stats = {0, 0, 0, 0, 0, 0, 0.0, 0.0, 0.0};
+}
+
+void VirtualGrblController::tick()
+{
+    qint64 now = nowUs();
+    double seconds = (now - lastTickUs) / 1e6;
+    lastTickUs = now;
+    
+    deliverInbound(now);
+    processLines();
+    
+    bool wasMoving = !planner.isEmpty();
+    advanceMotion(seconds);
+    processLines();
+    
+    // Planlayıcı boşaldı: yeni satır yetişmediyse makine durur (starvation)
+    if (wasMoving && planner.isEmpty()) {
+        if (state == "Run" || state == "Jog") {
+            stats.plannerEmptyEvents++;
+            setState("Idle");
+            emit plannerEmptied();
+        }
+    }
+    
+    deliverOutbound(now);
+}
+
+qint64 VirtualGrblController::nowUs() const
+{
+    return clock.nsecsElapsed() / 1000;
+}
+
+double VirtualGrblController::byteTimeUs() const
+{
+    // 8N1: her bayt 10 bit
+    return 10.0 * 1e6 / baudRate;
+}
+
+void VirtualGrblController::enqueueWire(QQueue<WireChunk> &wire, qint64 &wireFreeUs, const QByteArray &data)
+{
+    // Hat boşsa gecikme kadar sonra, doluysa önceki öbekten hemen sonra başlar
+    qint64 start = qMax(nowUs() + linkLatencyUs, wireFreeUs);
+    wire.enqueue(WireChunk{start, data, 0});
+    wireFreeUs = start + static_cast<qint64>(data.size() * byteTimeUs());
+}
+
+void VirtualGrblController::deliverInbound(qint64 now)
+{
+    double byteTime = byteTimeUs();
+    
+    while (!inboundWire.isEmpty() && !inboundResetPending) {
+        WireChunk &chunk = inboundWire.head();
+        while (chunk.delivered < chunk.data.size() && !inboundResetPending
+               && chunk.startUs + (chunk.delivered + 1) * byteTime <= now) {
+            char byte = chunk.data.at(chunk.delivered++);
+            
+            // Realtime komutlar RX tamponuna girmeden yakalanır
+            unsigned char code = static_cast<unsigned char>(byte);
+            if (byte == RT_STATUS || byte == RT_FEED_HOLD || byte == RT_CYCLE_START
+                || byte == RT_SOFT_RESET || code >= 0x80) {
+                handleRealtimeByte(byte);
+            } else if (rxBuffer.size() >= rxBufferSize) {
+                stats.rxOverflowBytes++;
+            } else {
+                rxBuffer.append(byte);
+            }
+        }
+        
+        if (inboundResetPending || chunk.delivered < chunk.data.size()) {
+            break;
+        }
+        inboundWire.dequeue();
+    }
+    
+    // Reset sırasında tutulan öbek referansı geçersiz kalmasın diye hat döngüden sonra boşaltılır
+    if (inboundResetPending) {
+        inboundResetPending = false;
+        inboundWire.clear();
+    }
+}
+
+void VirtualGrblController::deliverOutbound(qint64 now)
+{
+    double byteTime = byteTimeUs();
+    QByteArray ready;
+    
+    while (!outboundWire.isEmpty()) {
+        WireChunk &chunk = outboundWire.head();
+        int count = 0;
+        while (chunk.delivered + count < chunk.data.size()
+               && chunk.startUs + (chunk.delivered + count + 1) * byteTime <= now) {
+            count++;
+        }
+        ready.append(chunk.data.mid(chunk.delivered, count));
+        chunk.delivered += count;
+        
+        if (chunk.delivered < chunk.data.size()) {
+            break;
+        }
+        outboundWire.dequeue();
+    }
+    
+    if (!ready.isEmpty()) {
+        stats.bytesSent += ready.size();
+        emit bytesOutput(ready);
+    }
+}
+
+void VirtualGrblController::handleRealtimeByte(char byte)
+{
+    switch (byte) {
+        case RT_STATUS:
+            sendResponse(buildStatusReport() + "\r\n");
+            break;
+        case RT_FEED_HOLD:
+            if (state == "Run") {
+                // Makine anında durmaz: güncel hızdan $120 ivmesiyle yavaşlar (Hold:1)
+                if (!planner.isEmpty()) {
+                    double accel = qMax(settings.value(120, 10.0), 1.0);
+                    holdDecelRemaining = planner.head().feedRate / 60.0 / accel;
+                }
+                setState("Hold");
+            } else if (state == "Jog") {
+                // Jog sırasında feed hold, jog iptali gibi davranır
+                currentPosition(machinePosition);
+                for (int i = 0; i < 3; ++i) {
+                    plannerPosition[i] = machinePosition[i];
+                }
+                planner.clear();
+                blockElapsed = 0.0;
+                setState("Idle");
+            }
+            break;
+        case RT_CYCLE_START:
+            if (state == "Hold") {
+                holdDecelRemaining = 0.0;
+                setState(planner.isEmpty() ? "Idle" : "Run");
+            }
+            break;
+        case RT_SOFT_RESET:
+            softReset();
+            break;
+        case RT_JOG_CANCEL:
+            if (state == "Jog") {
+                // Kalan jog bloklarını at, bulunulan noktada dur
+                currentPosition(machinePosition);
+                for (int i = 0; i < 3; ++i) {
+                    plannerPosition[i] = machinePosition[i];
+                }
+                planner.clear();
+                blockElapsed = 0.0;
+                setState("Idle");
+            }
+            break;
+        default:
+            // Override komutları (0x90-0x9D vb.) kabul edilir, modellenmez
+            break;
+    }
+}
+
+void VirtualGrblController::processLines()
+{
+    while (true) {
+        int newline = -1;
+        for (int i = 0; i < rxBuffer.size(); ++i) {
+            if (rxBuffer.at(i) == '\n' || rxBuffer.at(i) == '\r') {
+                newline = i;
+                break;
+            }
+        }
+        if (newline == -1) {
+            return;
+        }
+        
+        QByteArray line = rxBuffer.left(newline);
+        
+        // Hareket satırı planlayıcıda yer açılana kadar RX tamponunda bekler
+        if (!checkMode && isMotionLine(line) && planner.size() >= plannerBlockCount - 1) {
+            return;
+        }
+        
+        rxBuffer.remove(0, newline + 1);
+        
+        // GRBL boş ve yorum satırlarına da senkronizasyon için ok döner
+        stats.linesProcessed++;
+        int error = executeLine(line);
+        sendResponse(error == 0 ? QByteArray("ok\r\n")
+                                : QByteArray("error:") + QByteArray::number(error) + "\r\n");
+        
+        if (resetAfterResponse) {
+            resetAfterResponse = false;
+            softReset();
+            inboundResetPending = false;
+            inboundWire.clear();
+            return;
+        }
+    }
+}
+
+void VirtualGrblController::advanceMotion(double seconds)
+{
+    if (state == "Alarm") {
+        return;
+    }
+    
+    if (state == "Hold") {
+        if (holdDecelRemaining <= 0.0) {
+            return;
+        }
+        // Doğrusal yavaşlamada alınan yol v·t/2: blok yarı hızla ilerletilir
+        double decel = qMin(seconds, holdDecelRemaining);
+        holdDecelRemaining -= decel;
+        seconds = 0.5 * decel;
+    }
+    
+    while (seconds > 0.0 && !planner.isEmpty()) {
+        PlannerBlock &block = planner.head();
+        double remaining = block.duration - blockElapsed;
+        
+        if (seconds >= remaining) {
+            for (int i = 0; i < 3; ++i) {
+                machinePosition[i] = block.target[i];
+            }
+            seconds -= remaining;
+            stats.busyTime += remaining;
+            stats.blocksExecuted++;
+            blockElapsed = 0.0;
+            planner.dequeue();
+            if (planner.isEmpty()) {
+                holdDecelRemaining = 0.0;
+            }
+        } else {
+            blockElapsed += seconds;
+            stats.busyTime += seconds;
+            seconds = 0.0;
+        }
+    }
+}
+
+void VirtualGrblController::setState(const QString &newState)
+{
+    if (state != newState) {
+        state = newState;
+        emit stateChanged(state);
+    }
+}
+
+void VirtualGrblController::sendResponse(const QByteArray &text)
+{
+    enqueueWire(outboundWire, outboundWireFreeUs, text);
+}
+
+void VirtualGrblController::softReset()
+{
+    // Hareket sırasında reset pozisyon kaybı demektir: GRBL alarm verir
+    bool wasMoving = !planner.isEmpty() && (state != "Hold" || holdDecelRemaining > 0.0);
+    currentPosition(machinePosition);
+    for (int i = 0; i < 3; ++i) {
+        plannerPosition[i] = machinePosition[i];
+    }
+    
+    planner.clear();
+    blockElapsed = 0.0;
+    holdDecelRemaining = 0.0;
+    rxBuffer.clear();
+    inboundResetPending = true;   // Hattı deliverInbound boşaltır
+    motionMode = 0;
+    absoluteMode = true;
+    inchMode = false;
+    checkMode = false;
+    setState(wasMoving ? "Alarm" : "Idle");
+    
+    sendResponse(STARTUP_BANNER);
+}
+
+int VirtualGrblController::executeLine(const QByteArray &rawLine)
+{
+    // GRBL boşlukları yok sayar ve harfleri büyük harfe çevirir
+    QByteArray line;
+    line.reserve(rawLine.size());
+    int commentDepth = 0;
+    for (char c : rawLine) {
+        if (c == '(') {
+            commentDepth++;
+        } else if (c == ')') {
+            commentDepth = qMax(commentDepth - 1, 0);
+        } else if (c == ';') {
+            break;
+        } else if (commentDepth == 0 && c != ' ' && c != '\t') {
+            line.append(static_cast<char>(toupper(static_cast<unsigned char>(c))));
+        }
+    }
+    
+    if (line.isEmpty()) {
+        return 0;
+    }
+    
+    if (line.startsWith('$')) {
+        return executeSystemCommand(line);
+    }
+    
+    if (state == "Alarm") {
+        return ERROR_SYSTEM_GC_LOCK;
+    }
+    
+    return executeGCode(line, false);
+}
+
+int VirtualGrblController::executeSystemCommand(const QByteArray &line)
+{
+    if (line == "$$") {
+        for (auto it = settings.constBegin(); it != settings.constEnd(); ++it) {
+            // Tamsayı ayarlar ondalıksız, diğerleri GRBL gibi 3 haneyle yazılır
+            bool integral = it.key() < 100 && it.value() == std::floor(it.value());
+            sendResponse(QByteArray("$") + QByteArray::number(it.key()) + "="
+                         + QByteArray::number(it.value(), 'f', integral ? 0 : 3) + "\r\n");
+        }
+        return 0;
+    }
+    
+    if (line == "$X") {
+        if (state == "Alarm") {
+            setState("Idle");
+            sendResponse("[MSG:Caution: Unlocked]\r\n");
+        }
+        return 0;
+    }
+    
+    if (line == "$H" || (line.startsWith("$H") && line.size() == 3)) {
+        if (state != "Idle" && state != "Alarm") {
+            return ERROR_IDLE_ERROR;
+        }
+        // Homing anlık kabul edilir: makine sıfır noktasına alınır
+        for (int i = 0; i < 3; ++i) {
+            machinePosition[i] = 0.0;
+            plannerPosition[i] = 0.0;
+        }
+        setState("Idle");
+        return 0;
+    }
+    
+    if (line == "$C") {
+        if (checkMode) {
+            // GRBL check modundan çıkarken ok yanıtından sonra soft reset yapar
+            sendResponse("[MSG:Disabled]\r\n");
+            resetAfterResponse = true;
+            return 0;
+        }
+        if (state != "Idle") {
+            return ERROR_IDLE_ERROR;
+        }
+        checkMode = true;
+        setState("Check");
+        sendResponse("[MSG:Enabled]\r\n");
+        return 0;
+    }
+    
+    if (line == "$I") {
+        sendResponse("[VER:1.1h.20190825:]\r\n");
+        sendResponse(QByteArray("[OPT:V,") + QByteArray::number(plannerBlockCount - 1) + ","
+                     + QByteArray::number(rxBufferSize) + "]\r\n");
+        return 0;
+    }
+    
+    if (line == "$G") {
+        sendResponse(QByteArray("[GC:G") + QByteArray::number(motionMode) + " G54 G17 "
+                     + (inchMode ? "G20" : "G21") + (absoluteMode ? " G90" : " G91")
+                     + " G94 M5 M9 T0 F" + QByteArray::number(modalFeedRate)
+                     + " S" + QByteArray::number(spindleSpeed) + "]\r\n");
+        return 0;
+    }
+    
+    if (line == "$#") {
+        sendResponse("[G54:0.000,0.000,0.000]\r\n");
+        return 0;
+    }
+    
+    if (line.startsWith("$J=")) {
+        if (state != "Idle" && state != "Jog") {
+            return ERROR_IDLE_ERROR;
+        }
+        return executeGCode(line.mid(3), true);
+    }
+    
+    // $n=deger ayar yazımı
+    int equals = line.indexOf('=');
+    if (equals > 1) {
+        bool numberOk = false;
+        bool valueOk = false;
+        int number = line.mid(1, equals - 1).toInt(&numberOk);
+        double value = line.mid(equals + 1).toDouble(&valueOk);
+        if (!numberOk || !valueOk) {
+            return ERROR_BAD_NUMBER_FORMAT;
+        }
+        if (!settings.contains(number)) {
+            return ERROR_INVALID_STATEMENT;
+        }
+        if (state != "Idle" && state != "Alarm") {
+            return ERROR_IDLE_ERROR;
+        }
+        settings[number] = value;
+        return 0;
+    }
+    
+    if (line == "$") {
+        sendResponse("[HLP:$$ $# $G $I $N $x=val $Nx=line $J=line $SLP $C $X $H ~ ! ? ctrl-x]\r\n");
+        return 0;
+    }
+    
+    if (line == "$N") {
+        sendResponse("$N0=\r\n$N1=\r\n");
+        return 0;
+    }
+    
+    return ERROR_INVALID_STATEMENT;
+}
+
+int VirtualGrblController::executeGCode(const QByteArray &line, bool isJog)
+{
+    double target[3];
+    for (int i = 0; i < 3; ++i) {
+        target[i] = plannerPosition[i];
+    }
+    
+    bool hasAxisWord = false;
+    bool blockAbsolute = absoluteMode;
+    int blockMotionMode = motionMode;
+    double feedRate = isJog ? 0.0 : modalFeedRate;
+    double offsetI = 0.0;
+    double offsetJ = 0.0;
+    bool hasArcOffset = false;
+    double dwellSeconds = -1.0;
+    
+    // Kelimeleri ayrıştır: harf + sayı
+    int pos = 0;
+    while (pos < line.size()) {
+        char letter = line.at(pos++);
+        if (letter < 'A' || letter > 'Z') {
+            return ERROR_EXPECTED_COMMAND_LETTER;
+        }
+        
+        int numberStart = pos;
+        while (pos < line.size() && (isdigit(static_cast<unsigned char>(line.at(pos)))
+                                     || line.at(pos) == '.' || line.at(pos) == '-' || line.at(pos) == '+')) {
+            pos++;
+        }
+        bool ok = false;
+        double value = line.mid(numberStart, pos - numberStart).toDouble(&ok);
+        if (!ok) {
+            return ERROR_BAD_NUMBER_FORMAT;
+        }
+        
+        double scale = inchMode ? 25.4 : 1.0;
+        switch (letter) {
+            case 'G': {
+                int code = qRound(value * 10);
+                switch (code) {
+                    case 0: case 10: case 20: case 30:
+                        if (isJog) {
+                            return ERROR_INVALID_JOG_COMMAND;
+                        }
+                        blockMotionMode = code / 10;
+                        break;
+                    case 40:
+                        dwellSeconds = 0.0;
+                        break;
+                    case 170: case 180: case 190: case 940: case 540: case 800:
+                        break;
+                    case 200:
+                        inchMode = true;
+                        break;
+                    case 210:
+                        inchMode = false;
+                        break;
+                    case 900:
+                        blockAbsolute = true;
+                        break;
+                    case 910:
+                        blockAbsolute = false;
+                        break;
+                    case 280: case 300:
+                        // Referans noktası modellenmez; kabul edilir
+                        break;
+                    default:
+                        return ERROR_UNSUPPORTED_COMMAND;
+                }
+                break;
+            }
+            case 'M': {
+                int code = qRound(value);
+                if (isJog) {
+                    return ERROR_INVALID_JOG_COMMAND;
+                }
+                if (code != 0 && code != 1 && code != 2 && code != 3 && code != 4 && code != 5
+                    && code != 7 && code != 8 && code != 9 && code != 30) {
+                    return ERROR_UNSUPPORTED_COMMAND;
+                }
+                break;
+            }
+            case 'X': case 'Y': case 'Z': {
+                int axis = letter - 'X';
+                double axisValue = value * (inchMode ? 25.4 : 1.0);
+                target[axis] = blockAbsolute ? axisValue : plannerPosition[axis] + axisValue;
+                hasAxisWord = true;
+                break;
+            }
+            case 'F':
+                feedRate = value * scale;
+                break;
+            case 'S':
+                spindleSpeed = value;
+                break;
+            case 'I':
+                offsetI = value * scale;
+                hasArcOffset = true;
+                break;
+            case 'J':
+                offsetJ = value * scale;
+                hasArcOffset = true;
+                break;
+            case 'K': case 'R': case 'N': case 'T':
+                break;
+            case 'P':
+                if (dwellSeconds >= 0.0) {
+                    dwellSeconds = value;
+                }
+                break;
+            default:
+                return ERROR_UNSUPPORTED_COMMAND;
+        }
+    }
+    
+    // Jog komutları modal durumu değiştirmez
+    if (!isJog) {
+        absoluteMode = blockAbsolute;
+        motionMode = blockMotionMode;
+        modalFeedRate = feedRate;
+    } else if (!hasAxisWord || feedRate <= 0.0) {
+        return ERROR_INVALID_JOG_COMMAND;
+    }
+    
+    if (checkMode) {
+        if (hasAxisWord && blockMotionMode != 0 && feedRate <= 0.0) {
+            return ERROR_UNDEFINED_FEED_RATE;
+        }
+        return 0;
+    }
+    
+    // Bekleme (G4) sadece süre tüketen boş bir blok olarak planlanır
+    if (dwellSeconds > 0.0) {
+        PlannerBlock block;
+        for (int i = 0; i < 3; ++i) {
+            block.start[i] = plannerPosition[i];
+            block.target[i] = plannerPosition[i];
+        }
+        block.feedRate = 0.0;
+        block.duration = dwellSeconds;
+        block.isJog = false;
+        planner.enqueue(block);
+        stats.motionTime += dwellSeconds;
+        stats.idealMotionTime += dwellSeconds;
+        if (state == "Idle") {
+            setState("Run");
+        }
+        return 0;
+    }
+    
+    if (!hasAxisWord) {
+        return 0;
+    }
+    
+    int mode = isJog ? 1 : blockMotionMode;
+    double maxRate = qMin(qMin(settings.value(110), settings.value(111)), settings.value(112));
+    double rate = (mode == 0) ? maxRate : qMin(feedRate, maxRate);
+    if (rate <= 0.0) {
+        return ERROR_UNDEFINED_FEED_RATE;
+    }
+    
+    // G2/G3: XY düzleminde yay uzunluğu
+    double arcLength = -1.0;
+    if ((mode == 2 || mode == 3) && hasArcOffset) {
+        double centerX = plannerPosition[0] + offsetI;
+        double centerY = plannerPosition[1] + offsetJ;
+        double radius = std::sqrt(offsetI * offsetI + offsetJ * offsetJ);
+        double startAngle = std::atan2(plannerPosition[1] - centerY, plannerPosition[0] - centerX);
+        double endAngle = std::atan2(target[1] - centerY, target[0] - centerX);
+        double sweep = (mode == 2) ? startAngle - endAngle : endAngle - startAngle;
+        if (sweep <= 0.0) {
+            sweep += 2.0 * M_PI;
+        }
+        double dz = target[2] - plannerPosition[2];
+        arcLength = std::sqrt(radius * sweep * radius * sweep + dz * dz);
+    }
+    
+    PlannerBlock block;
+    for (int i = 0; i < 3; ++i) {
+        block.start[i] = plannerPosition[i];
+        block.target[i] = target[i];
+        plannerPosition[i] = target[i];
+    }
+    block.feedRate = rate;
+    block.duration = blockDuration(block.start, block.target, rate, arcLength, planner.isEmpty());
+    block.isJog = isJog;
+    planner.enqueue(block);
+    stats.motionTime += block.duration;
+    stats.idealMotionTime += blockDuration(block.start, block.target, rate, arcLength, false);
+    
+    if (state == "Idle") {
+        setState(isJog ? "Jog" : "Run");
+    }
+    
+    return 0;
+}
+
+bool VirtualGrblController::isMotionLine(const QByteArray &line) const
+{
+    // Planlayıcıya blok ekleyebilecek satırlar: G-code ve $J=
+    QByteArray trimmed = line.trimmed();
+    if (trimmed.isEmpty()) {
+        return false;
+    }
+    if (trimmed.startsWith('$')) {
+        return trimmed.toUpper().startsWith("$J=");
+    }
+    return true;
+}
+
+double VirtualGrblController::blockDuration(const double start[3], const double target[3], double feedRate,
+                                            double arcLength, bool fromRest) const
+{
+    double distance = arcLength;
+    if (distance < 0.0) {
+        double sum = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            double d = target[i] - start[i];
+            sum += d * d;
+        }
+        distance = std::sqrt(sum);
+    }
+    
+    double velocity = feedRate / 60.0;
+    double accel = qMax(settings.value(120, 10.0), 1.0);
+    
+    // Duruştan kalkan blok: hızlanma ve yavaşlama rampası eklenir
+    if (fromRest) {
+        if (distance >= velocity * velocity / accel) {
+            return distance / velocity + velocity / accel;
+        }
+        return 2.0 * std::sqrt(distance / accel);
+    }
+    
+    return distance / velocity;
+}
+
+QByteArray VirtualGrblController::buildStatusReport() const
+{
+    double position[3];
+    currentPosition(position);
+    
+    int mask = static_cast<int>(settings.value(10, 1));
+    QByteArray report = "<" + state.toLatin1();
+    if (state == "Hold") {
+        // GRBL 1.1: Hold:1 yavaşlıyor, Hold:0 durdu ve devam etmeye hazır
+        report += holdDecelRemaining > 0.0 ? ":1" : ":0";
+    }
+    report += (mask & 1) ? "|MPos:" : "|WPos:";
+    report += QByteArray::number(position[0], 'f', 3) + ","
+            + QByteArray::number(position[1], 'f', 3) + ","
+            + QByteArray::number(position[2], 'f', 3);
+    
+    if (mask & 2) {
+        report += "|Bf:" + QByteArray::number(plannerBlocksAvailable()) + ","
+                + QByteArray::number(rxBytesAvailable());
+    }
+    
+    double feed = (!planner.isEmpty() && state != "Hold") ? planner.head().feedRate : 0.0;
+    report += "|FS:" + QByteArray::number(qRound(feed)) + "," + QByteArray::number(qRound(spindleSpeed));
+    report += ">";
+    return report;
+}
+
+void VirtualGrblController::currentPosition(double position[3]) const
+{
+    if (planner.isEmpty()) {
+        for (int i = 0; i < 3; ++i) {
+            position[i] = machinePosition[i];
+        }
+        return;
+    }
+    
+    // Aktif blok içinde doğrusal ara değer
+    const PlannerBlock &block = planner.head();
+    double fraction = block.duration > 0.0 ? qBound(0.0, blockElapsed / block.duration, 1.0) : 1.0;
+    for (int i = 0; i < 3; ++i) {
+        position[i] = block.start[i] + (block.target[i] - block.start[i]) * fraction;
+    }
+}
+
+// VirtualGrblDevice
+VirtualGrblDevice::VirtualGrblDevice(VirtualGrblController *controller, QObject *parent)
+    : QIODevice(parent)
+    , grbl(controller)
+{
+    connect(grbl, &VirtualGrblController::bytesOutput, this, [this](const QByteArray &data) {
+        if (!isOpen()) {
+            return;
+        }
+        readBuffer.append(data);
+        emit readyRead();
+    });
+}
+
+VirtualGrblController *VirtualGrblDevice::controller() const
+{
+    return grbl;
+}
+
+bool VirtualGrblDevice::open(OpenMode mode)
+{
+    if (!QIODevice::open(mode | QIODevice::Unbuffered)) {
+        return false;
+    }
+    readBuffer.clear();
+    grbl->start();
+    return true;
+}
+
+void VirtualGrblDevice::close()
+{
+    grbl->stop();
+    readBuffer.clear();
+    QIODevice::close();
+}
+
+bool VirtualGrblDevice::isSequential() const
+{
+    return true;
+}
+
+qint64 VirtualGrblDevice::bytesAvailable() const
+{
+    return readBuffer.size() + QIODevice::bytesAvailable();
+}
+
+bool VirtualGrblDevice::canReadLine() const
+{
+    return readBuffer.contains('\n') || QIODevice::canReadLine();
+}
+
+qint64 VirtualGrblDevice::readData(char *data, qint64 maxSize)
+{
+    qint64 count = qMin<qint64>(maxSize, readBuffer.size());
+    memcpy(data, readBuffer.constData(), static_cast<size_t>(count));
+    readBuffer.remove(0, static_cast<int>(count));
+    return count;
+}
+
+qint64 VirtualGrblDevice::writeData(const char *data, qint64 size)
+{
+    grbl->receiveBytes(QByteArray(data, static_cast<int>(size)));
+    emit bytesWritten(size);
+    return size;
+}
+
+// VirtualGrblTcpServer
+
+VirtualGrblTcpServer::VirtualGrblTcpServer(VirtualGrblController *controller, QObject *parent)
+    : QObject(parent)
+    , grbl(controller)
+    , server(new QTcpServer(this))
+    , client(nullptr)
+{
+    connect(server, &QTcpServer::newConnection, this, &VirtualGrblTcpServer::handleNewConnection);
+    connect(grbl, &VirtualGrblController::bytesOutput, this, &VirtualGrblTcpServer::writeToClient);
+}
+
+VirtualGrblTcpServer::~VirtualGrblTcpServer()
+{
+    close();
+}
+
+bool VirtualGrblTcpServer::listen(quint16 port)
+{
+    if (server->isListening()) {
+        return true;
+    }
+    return server->listen(QHostAddress::LocalHost, port);
+}
+
+void VirtualGrblTcpServer::close()
+{
+    server->close();
+    if (client) {
+        client->disconnect(this);
+        client->abort();
+        client->deleteLater();
+        client = nullptr;
+    }
+    grbl->stop();
+}
+
+bool VirtualGrblTcpServer::isListening() const
+{
+    return server->isListening();
+}
+
+quint16 VirtualGrblTcpServer::serverPort() const
+{
+    return server->serverPort();
+}
+
+void VirtualGrblTcpServer::handleNewConnection()
+{
+    while (QTcpSocket *socket = server->nextPendingConnection()) {
+        if (client) {
+            socket->abort(); // Gerçek kontrolcü gibi tek oturum
+            socket->deleteLater();
+            continue;
+        }
+        
+        client = socket;
+        client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(client, &QTcpSocket::readyRead, this, &VirtualGrblTcpServer::handleClientReadyRead);
+        connect(client, &QTcpSocket::disconnected, this, &VirtualGrblTcpServer::handleClientDisconnected);
+        
+        // Her oturum güç açılışı gibi karşılama satırıyla başlar
+        grbl->start();
+    }
+}
+
+void VirtualGrblTcpServer::handleClientReadyRead()
+{
+    if (client) {
+        grbl->receiveBytes(client->readAll());
+    }
+}
+
+void VirtualGrblTcpServer::handleClientDisconnected()
+{
+    if (client) {
+        client->deleteLater();
+        client = nullptr;
+    }
+    grbl->stop();
+}
+
+void VirtualGrblTcpServer::writeToClient(const QByteArray &data)
+{
+    if (client && client->state() == QAbstractSocket::ConnectedState) {
+        client->write(data);
+    }
+}
+
+#ifdef Q_OS_UNIX
+// VirtualGrblPty
+VirtualGrblPty::VirtualGrblPty(VirtualGrblController *controller, QObject *parent)
+    : QObject(parent)
+    , grbl(controller)
+    , notifier(nullptr)
+    , masterFd(-1)
+{
+    connect(grbl, &VirtualGrblController::bytesOutput, this, &VirtualGrblPty::writeToMaster);
+}
+
+VirtualGrblPty::~VirtualGrblPty()
+{
+    close();
+}
+
+bool VirtualGrblPty::open()
+{
+    if (masterFd != -1) {
+        return true;
+    }
+    
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (masterFd == -1 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+        close();
+        return false;
+    }
+    
+    // Master ucunda satır düzenleme/yankı olmasın
+    termios tio;
+    if (tcgetattr(masterFd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(masterFd, TCSANOW, &tio);
+    }
+    
+    slavePath = QString::fromLocal8Bit(ptsname(masterFd));
+    notifier = new QSocketNotifier(masterFd, QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &VirtualGrblPty::handleMasterReadable);
+    
+    grbl->start();
+    return true;
+}
+
+void VirtualGrblPty::close()
+{
+    if (notifier) {
+        delete notifier;
+        notifier = nullptr;
+    }
+    if (masterFd != -1) {
+        ::close(masterFd);
+        masterFd = -1;
+    }
+    grbl->stop();
+    slavePath.clear();
+}
+
+bool VirtualGrblPty::isOpen() const
+{
+    return masterFd != -1;
+}
+
+QString VirtualGrblPty::slaveName() const
+{
+    return slavePath;
+}
+
+void VirtualGrblPty::handleMasterReadable()
+{
+    char buffer[4096];
+    ssize_t count;
+    while ((count = ::read(masterFd, buffer, sizeof(buffer))) > 0) {
+        grbl->receiveBytes(QByteArray(buffer, static_cast<int>(count)));
+    }
+}
+
+void VirtualGrblPty::writeToMaster(const QByteArray &data)
+{
+    if (masterFd == -1) {
+        return;
+    }
+    
+    const char *ptr = data.constData();
+    qint64 remaining = data.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(masterFd, ptr, static_cast<size_t>(remaining));
+        if (written <= 0) {
+            break; // Slave ucu açık değilse veri atılır
+        }
+        ptr += written;
+        remaining -= written;
+    }
+}
+#endif
@@ -0,0 +1,457 @@
+// Akış performans ölçümü: G-code programlarını SerialCommunication üzerinden
+// sanal GRBL kontrolcüsüne gönderir ve ping-pong ile karakter sayma
+// modlarını aynı bağlantı koşullarında karşılaştırır.
+//
+// Örnek: CNC_StreamBenchmark --baud 115200 --latency-us 1000 --mode both test_sample.gcode
+// --transport tcp ile bağlantı yerel bir TCP sunucusu üzerinden kurulur
+// (grbl_ESP32 Telnet yolunun ağ taşıyıcısını sınar). pty ve pty-native kontrolcüyü
+// bir pseudo-terminal üzerinden sunar ve QSerialPort ile yerel Linux altyapısının
+// ack gecikmesini karşılaştırır: --transport pty,pty-native
+// --machines N ile program N makine oturumunda (MachineManager) aynı anda
+// akıtılır; her oturum kendi iş parçacığında, kendi TCP sunucusuna bağlanır.
+// --check programı $C check modunda JobStreamer ile akıtır: kontrolcü satırları
+// doğrular ama hareket etmez, satır/s yalnızca hat ve akış kontrolünü ölçer.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QTimer>
+#include <QtMath>
+#include <functional>
+#include "jobstreamer.h"
+#include "machinemanager.h"
+#include "serialcommunication.h"
+#include "virtualgrbl.h"
+
+struct BenchmarkConfig {
+    int baudRate;
+    int latencyUs;
+    int rxBufferSize;
+    int plannerBlocks;
+    int timeoutSeconds;
+    bool compaction;
+    bool checkMode;     // Programı $C kuru çalıştırmasıyla JobStreamer üzerinden akıt
+    QString transport;  // device, tcp, pty, pty-native
+};
+
+struct BenchmarkResult {
+    QString program;
+    QString mode;
+    int lines;
+    bool completed;
+    double streamSeconds;   // Son ok gelene kadar
+    double jobSeconds;      // Makine durana kadar
+    double idealSeconds;    // Planlayıcı hiç boşalmasaydı
+    double linesPerSecond;
+    quint64 plannerEmptyEvents;
+    quint64 hostStarvationEvents;
+    quint64 txBytes;
+    quint64 rxBytes;
+    quint64 rxOverflowBytes;
+    qint64 compactionSavedBytes;
+    qint64 checkErrors;     // Check modunda GRBL'in reddettiği satırlar
+    qint64 ackP50;
+    qint64 ackP90;
+    qint64 ackP99;
+};
+
+// Kısa segmentli daire: planlayıcı açlığını en çok zorlayan durum
+static QStringList generateShortSegments(int count)
+{
+    QStringList lines = {"G21", "G90", "G0 X10.000 Y0.000 Z1.000", "G1 F1500"};
+    const double radius = 10.0;
+    for (int i = 1; i <= count; ++i) {
+        double angle = 2.0 * M_PI * i / 360.0;
+        lines << QString("G1 X%1 Y%2").arg(radius * qCos(angle), 0, 'f', 3).arg(radius * qSin(angle), 0, 'f', 3);
+    }
+    return lines;
+}
+
+// Uzun doğrusal hareketler: bağlantı değil planlayıcı sınırlayıcıdır
+static QStringList generateLongMoves(int count)
+{
+    QStringList lines = {"G21", "G90", "G1 F3000"};
+    for (int i = 0; i < count; ++i) {
+        lines << QString("G1 X%1 Y%2").arg((i % 2) ? 40.0 : 0.0, 0, 'f', 3).arg(i * 0.5, 0, 'f', 3);
+    }
+    return lines;
+}
+
+static QStringList loadProgram(const QString &path)
+{
+    QStringList lines;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return lines;
+    }
+    
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (!line.isEmpty()) {
+            lines << line;
+        }
+    }
+    return lines;
+}
+
+static BenchmarkResult runBenchmark(const QString &name, const QStringList &lines,
+                                    StreamingMode mode, const BenchmarkConfig &config)
+{
+    BenchmarkResult result = {};
+    result.program = name;
+    result.mode = QString((mode == StreamingMode::PingPong) ? "ping-pong" : "char-count") + ", " + config.transport
+        + (config.checkMode ? ", $C" : "");
+    result.lines = lines.size();
+    
+    VirtualGrblController controller;
+    controller.setBaudRate(config.baudRate);
+    controller.setLinkLatency(config.latencyUs);
+    controller.setRxBufferSize(config.rxBufferSize);
+    controller.setPlannerBlockCount(config.plannerBlocks);
+    controller.setSetting(10, 3); // MPos + Bf: planlayıcıya duyarlı akış için
+    VirtualGrblDevice device(&controller);
+    VirtualGrblTcpServer tcpServer(&controller);
+#ifdef Q_OS_UNIX
+    VirtualGrblPty pty(&controller);
+#endif
+    
+    SerialCommunication serial;
+    serial.setStreamingMode(mode);
+    serial.setLatencySummaryInterval(0);
+    serial.setGCodeCompactionEnabled(config.compaction);
+    serial.setSafetyTimeout(config.timeoutSeconds * 1000);
+    
+    QEventLoop loop;
+    QTimer pollTimer;
+    pollTimer.setInterval(1);
+    QElapsedTimer wallClock;
+    QElapsedTimer deadline;
+    std::function<bool()> done;
+    
+    QObject::connect(&pollTimer, &QTimer::timeout, &loop, [&]() {
+        if (done() || deadline.elapsed() > config.timeoutSeconds * 1000) {
+            loop.quit();
+        }
+    });
+    
+    bool started = false;
+    if (config.transport == "tcp") {
+        started = tcpServer.listen() && serial.connectToHost("127.0.0.1", tcpServer.serverPort());
+#ifdef Q_OS_UNIX
+    } else if (config.transport == "pty" || config.transport == "pty-native") {
+        serial.setSerialBackend(config.transport == "pty-native" ? SerialBackend::LinuxNative
+                                                                 : SerialBackend::QtSerialPort);
+        started = pty.open() && serial.connectToDevice(pty.slaveName(), config.baudRate);
+#endif
+    } else {
+        started = serial.connectToIODevice(&device);
+    }
+    if (!started) {
+        return result;
+    }
+    
+    // Bağlantı, açılış mesajı ve $I yanıtı (RX/planlayıcı boyutları) gelene kadar bekle
+    deadline.start();
+    done = [&]() { return serial.isConnected() && serial.getPendingCommandCount() == 0; };
+    pollTimer.start();
+    loop.exec();
+    if (!serial.isConnected()) {
+        return result;
+    }
+    
+    controller.resetStatistics();
+    serial.resetLatencyStatistics();
+    
+    // Programı gönder ve son ok'u bekle
+    deadline.restart();
+    wallClock.start();
+    JobStreamer streamer(&serial);
+    bool checkFinished = false;
+    if (config.checkMode) {
+        // Check modunda hareket yok: süre yalnızca hat ve akış kontrolüyle sınırlı
+        QObject::connect(&streamer, &JobStreamer::finished, &loop, [&checkFinished]() { checkFinished = true; });
+        streamer.startText(lines.join('\n'), 1, JobMode::Check);
+        done = [&]() { return checkFinished && serial.getPendingCommandCount() == 0; };
+    } else {
+        for (const QString &line : lines) {
+            serial.sendCommand(line);
+        }
+        done = [&]() { return serial.getPendingCommandCount() == 0; };
+    }
+    loop.exec();
+    result.streamSeconds = wallClock.nsecsElapsed() / 1e9;
+    result.checkErrors = streamer.getErrorCount();
+    
+    // Planlayıcıdaki son bloklar bitene kadar bekle
+    done = [&]() {
+        return controller.plannerBlocksAvailable() == controller.getPlannerBlockCount() - 1
+            && controller.getState() != "Run";
+    };
+    loop.exec();
+    result.jobSeconds = wallClock.nsecsElapsed() / 1e9;
+    pollTimer.stop();
+    
+    result.completed = serial.getPendingCommandCount() == 0 && done();
+    
+    VirtualGrblStatistics stats = controller.getStatistics();
+    result.idealSeconds = stats.idealMotionTime;
+    result.linesPerSecond = result.streamSeconds > 0.0 ? lines.size() / result.streamSeconds : 0.0;
+    result.plannerEmptyEvents = stats.plannerEmptyEvents;
+    result.hostStarvationEvents = serial.getPlannerStarvationCount();
+    result.txBytes = stats.bytesReceived;
+    result.rxBytes = stats.bytesSent;
+    result.rxOverflowBytes = stats.rxOverflowBytes;
+    result.compactionSavedBytes = serial.getCompactionBytesSaved();
+    
+    const LatencyHistogram &ack = serial.getAckLatencyHistogram();
+    result.ackP50 = ack.percentile(50.0);
+    result.ackP90 = ack.percentile(90.0);
+    result.ackP99 = ack.percentile(99.0);
+    
+    serial.disconnectFromDevice();
+    return result;
+}
+
+// Çok makineli ölçüm: sanal kontrolcüler ana iş parçacığında, oturumlar kendi iş parçacıklarında
+static bool runMultiMachine(const QString &name, const QStringList &lines, int machineCount,
+                            const BenchmarkConfig &config, QTextStream &out)
+{
+    QTemporaryFile programFile;
+    if (!programFile.open()) {
+        return false;
+    }
+    programFile.write(lines.join('\n').toUtf8());
+    programFile.write("\n");
+    programFile.flush();
+    const QString programPath = programFile.fileName();
+    
+    QList<VirtualGrblController *> controllers;
+    QList<VirtualGrblTcpServer *> servers;
+    for (int i = 0; i < machineCount; ++i) {
+        VirtualGrblController *controller = new VirtualGrblController();
+        controller->setBaudRate(config.baudRate);
+        controller->setLinkLatency(config.latencyUs);
+        controller->setRxBufferSize(config.rxBufferSize);
+        controller->setPlannerBlockCount(config.plannerBlocks);
+        controller->setSetting(10, 3);
+        VirtualGrblTcpServer *server = new VirtualGrblTcpServer(controller);
+        server->listen();
+        controllers << controller;
+        servers << server;
+    }
+    
+    MachineManager manager;
+    QMap<QString, double> finishSeconds;
+    QMap<QString, bool> finishSuccess;
+    QElapsedTimer wallClock;
+    QList<MachineSession *> sessions;
+    for (int i = 0; i < machineCount; ++i) {
+        MachineSession *session = manager.addMachine(QString("cnc%1").arg(i + 1));
+        QObject::connect(session, &MachineSession::jobFinished, &manager, [&](const QString &machine, bool success) {
+            finishSeconds[machine] = wallClock.nsecsElapsed() / 1e9;
+            finishSuccess[machine] = success;
+        });
+        const quint16 port = servers[i]->serverPort();
+        const BenchmarkConfig sessionConfig = config;
+        QMetaObject::invokeMethod(session, [session, port, sessionConfig]() {
+            SerialCommunication *serial = session->getSerialCommunication();
+            serial->setStreamingMode(StreamingMode::CharacterCounting);
+            serial->setLatencySummaryInterval(0);
+            serial->setGCodeCompactionEnabled(sessionConfig.compaction);
+            serial->setSafetyTimeout(sessionConfig.timeoutSeconds * 1000);
+            session->connectToHost("127.0.0.1", port);
+        });
+        sessions << session;
+    }
+    
+    QEventLoop loop;
+    QTimer pollTimer;
+    pollTimer.setInterval(1);
+    QElapsedTimer deadline;
+    std::function<bool()> done;
+    QObject::connect(&pollTimer, &QTimer::timeout, &loop, [&]() {
+        if (done() || deadline.elapsed() > config.timeoutSeconds * 1000) {
+            loop.quit();
+        }
+    });
+    
+    // Tüm oturumlar bağlanıp açılış sorgularını tamamlayana kadar bekle
+    deadline.start();
+    done = [&]() {
+        for (MachineSession *session : sessions) {
+            MachineSnapshot snapshot = session->getSnapshot();
+            if (!snapshot.connected || snapshot.pendingCommands > 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+    pollTimer.start();
+    loop.exec();
+    
+    deadline.restart();
+    wallClock.start();
+    for (MachineSession *session : sessions) {
+        QMetaObject::invokeMethod(session, [session, programPath]() {
+            session->startJob(programPath);
+        });
+    }
+    done = [&]() { return finishSeconds.size() == machineCount; };
+    loop.exec();
+    pollTimer.stop();
+    const double totalSeconds = wallClock.nsecsElapsed() / 1e9;
+    
+    bool allCompleted = finishSeconds.size() == machineCount;
+    double slowest = 0.0;
+    double fastest = totalSeconds;
+    out << QString("%1 [%2 makine, char-count]\n").arg(name).arg(machineCount);
+    for (MachineSession *session : sessions) {
+        const QString machine = session->getName();
+        if (!finishSeconds.contains(machine)) {
+            out << QString("  %1: ** ZAMAN AŞIMI **\n").arg(machine);
+            continue;
+        }
+        const double seconds = finishSeconds.value(machine);
+        slowest = qMax(slowest, seconds);
+        fastest = qMin(fastest, seconds);
+        allCompleted = allCompleted && finishSuccess.value(machine);
+        out << QString("  %1: akış %2 s  satır/s: %3%4\n")
+            .arg(machine)
+            .arg(seconds, 0, 'f', 3)
+            .arg(seconds > 0.0 ? lines.size() / seconds : 0.0, 0, 'f', 1)
+            .arg(finishSuccess.value(machine) ? QString() : QString("  (hata)"));
+    }
+    out << QString("  toplam: %1 s  toplam satır/s: %2  en yavaş/en hızlı: %3  ayrıştırma önbelleği: %4 isabet, %5 ıska\n")
+        .arg(totalSeconds, 0, 'f', 3)
+        .arg(totalSeconds > 0.0 ? lines.size() * machineCount / totalSeconds : 0.0, 0, 'f', 1)
+        .arg(fastest > 0.0 ? slowest / fastest : 0.0, 0, 'f', 2)
+        .arg(manager.getProgramCache()->getHitCount())
+        .arg(manager.getProgramCache()->getMissCount());
+    out.flush();
+    
+    manager.shutdown();
+    qDeleteAll(servers);
+    qDeleteAll(controllers);
+    return allCompleted;
+}
+
+static void printResult(QTextStream &out, const BenchmarkResult &r)
+{
+    QString status = r.completed ? QString() : QString("  ** ZAMAN AŞIMI **");
+    out << QString("%1 [%2]%3\n").arg(r.program, r.mode, status);
+    out << QString("  satır: %1  akış: %2 s  iş: %3 s  ideal hareket: %4 s  verim: %5%\n")
+        .arg(r.lines)
+        .arg(r.streamSeconds, 0, 'f', 3)
+        .arg(r.jobSeconds, 0, 'f', 3)
+        .arg(r.idealSeconds, 0, 'f', 3)
+        .arg(r.jobSeconds > 0.0 ? 100.0 * r.idealSeconds / r.jobSeconds : 0.0, 0, 'f', 1);
+    out << QString("  satır/s: %1  planlayıcı boşalma: %2 (program sonu dahil, host tespiti: %3)  RX taşma: %4 bayt\n")
+        .arg(r.linesPerSecond, 0, 'f', 1)
+        .arg(r.plannerEmptyEvents)
+        .arg(r.hostStarvationEvents)
+        .arg(r.rxOverflowBytes);
+    out << QString("  ack gecikmesi (us): p50=%1 p90=%2 p99=%3  hat: TX %4 bayt, RX %5 bayt  sıkıştırma: -%6 bayt\n")
+        .arg(r.ackP50).arg(r.ackP90).arg(r.ackP99)
+        .arg(r.txBytes).arg(r.rxBytes)
+        .arg(r.compactionSavedBytes);
+    if (r.mode.endsWith("$C")) {
+        out << QString("  check modu hataları: %1\n").arg(r.checkErrors);
+    }
+    out.flush();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("CNC_StreamBenchmark");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Sanal GRBL ile seri akış performans ölçümü");
+    parser.addHelpOption();
+    parser.addPositionalArgument("program", "Ölçülecek G-code dosyaları (yoksa dahili programlar)", "[program...]");
+    parser.addOption({"baud", "Baud hızı", "rate", "115200"});
+    parser.addOption({"latency-us", "Tek yönlü bağlantı gecikmesi (mikrosaniye)", "us", "1000"});
+    parser.addOption({"rx-buffer", "Kontrolcü RX tampon boyutu (bayt)", "bytes", "256"});
+    parser.addOption({"planner-blocks", "Planlayıcı blok sayısı", "blocks", "16"});
+    parser.addOption({"mode", "pingpong, counting veya both", "mode", "both"});
+    parser.addOption({"segments", "Dahili programların satır sayısı", "count", "2000"});
+    parser.addOption({"timeout", "Program başına zaman aşımı (s)", "seconds", "600"});
+    parser.addOption({"transport", "device (süreç içi), tcp (yerel sunucu), pty (QSerialPort) veya pty-native; virgülle birden çok", "type", "device"});
+    parser.addOption({"no-compaction", "G-code sıkıştırmayı kapat (karşılaştırma için)"});
+    parser.addOption({"check", "Programı $C check modunda doğrula (hareket yok, satır/s ve hata sayısı)"});
+    parser.addOption({"machines", "Programı N makine oturumunda eşzamanlı akıt", "count", "0"});
+    parser.process(app);
+    
+    BenchmarkConfig config;
+    config.baudRate = parser.value("baud").toInt();
+    config.latencyUs = parser.value("latency-us").toInt();
+    config.rxBufferSize = parser.value("rx-buffer").toInt();
+    config.plannerBlocks = parser.value("planner-blocks").toInt();
+    config.timeoutSeconds = parser.value("timeout").toInt();
+    config.compaction = !parser.isSet("no-compaction");
+    config.checkMode = parser.isSet("check");
+    const QStringList transports = parser.value("transport").split(',', Qt::SkipEmptyParts);
+    config.transport = transports.value(0, "device");
+    
+    QList<StreamingMode> modes;
+    QString modeName = parser.value("mode");
+    if (modeName == "pingpong" || modeName == "both") {
+        modes << StreamingMode::PingPong;
+    }
+    if (modeName == "counting" || modeName == "both") {
+        modes << StreamingMode::CharacterCounting;
+    }
+    
+    QList<QPair<QString, QStringList>> programs;
+    const QStringList files = parser.positionalArguments();
+    for (const QString &path : files) {
+        QStringList lines = loadProgram(path);
+        if (lines.isEmpty()) {
+            QTextStream(stderr) << "Program okunamadı: " << path << "\n";
+            return 1;
+        }
+        programs.append({QFileInfo(path).fileName(), lines});
+    }
+    if (programs.isEmpty()) {
+        int segments = parser.value("segments").toInt();
+        programs.append({"kisa-segmentler", generateShortSegments(segments)});
+        programs.append({"uzun-hareketler", generateLongMoves(qMax(segments / 10, 1))});
+    }
+    
+    QTextStream out(stdout);
+    out << QString("baud=%1 gecikme=%2us rx=%3 bayt planlayıcı=%4 blok taşıyıcı=%5\n\n")
+        .arg(config.baudRate).arg(config.latencyUs).arg(config.rxBufferSize).arg(config.plannerBlocks)
+        .arg(transports.join(','));
+    
+    bool allCompleted = true;
+    const int machineCount = parser.value("machines").toInt();
+    if (machineCount > 0) {
+        for (const auto &program : programs) {
+            allCompleted = runMultiMachine(program.first, program.second, machineCount, config, out) && allCompleted;
+            out << "\n";
+        }
+        return allCompleted ? 0 : 2;
+    }
+    
+    for (const auto &program : programs) {
+        for (StreamingMode mode : modes) {
+            // Birden çok taşıyıcı verildiyse aynı program ve kip her biri için koşulur,
+            // ack p50/p90/p99 satırları yan yana karşılaştırılabilir
+            for (const QString &transport : transports) {
+                config.transport = transport.trimmed();
+                BenchmarkResult result = runBenchmark(program.first, program.second, mode, config);
+                printResult(out, result);
+                allCompleted = allCompleted && result.completed;
+            }
+        }
+        out << "\n";
+    }
+    
+    return allCompleted ? 0 : 2;
+}
@@ -0,0 +1,344 @@
+// Trafik kaydı analizi ve tekrar oynatma: SerialCommunication'ın yazdığı
+// .cnccap dosyasından ack gecikmelerini, tampon doluluğunu ve durum zaman
+// çizelgesini çıkarır; istenirse kaydedilen satırları sanal GRBL'e yeniden
+// gönderip ok/error sonuçlarını kayıttakilerle karşılaştırır.
+//
+// Örnek: CNC_TrafficReplay --timeline is.cnccap
+//        CNC_TrafficReplay --replay --baud 115200 is.cnccap
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QQueue>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QTimer>
+#include "latencyhistogram.h"
+#include "serialcommunication.h"
+#include "trafficrecorder.h"
+#include "virtualgrbl.h"
+
+struct PendingLine {
+    QByteArray text;
+    qint64 sentNs;
+    int size;
+};
+
+struct CaptureAnalysis {
+    qint64 durationNs;
+    qint64 txBytes;
+    qint64 rxBytes;
+    qint64 realtimeBytes;
+    qint64 statusRequests;
+    qint64 resets;
+    QStringList lines;          // Gönderilen satırlar (realtime baytlar hariç)
+    QStringList responses;      // Her satırın ok/error yanıtı (yoksa boş)
+    QStringList events;         // Durum değişimleri, alarmlar, işaretler
+    LatencyHistogram ackLatencyUs;
+    LatencyHistogram statusLatencyUs;
+    LatencyHistogram bytesInFlight;
+    LatencyHistogram plannerBlocksFree;
+    qint64 longestStallNs;      // Satır beklerken en uzun ack boşluğu
+    qint64 longestStallAtNs;
+};
+
+static QString formatTime(qint64 ns)
+{
+    return QString::number(ns / 1e6, 'f', 3);
+}
+
+static bool isRealtimeByte(char c)
+{
+    unsigned char byte = static_cast<unsigned char>(c);
+    return c == '?' || c == '!' || c == '~' || byte == 0x18 || byte >= 0x80;
+}
+
+static CaptureAnalysis analyzeCapture(TrafficCaptureReader &reader, QTextStream &out, bool timeline)
+{
+    CaptureAnalysis result = {};
+    QQueue<PendingLine> pending;
+    QQueue<int> pendingIndex;
+    QByteArray txLine;
+    QByteArray rxBuffer;
+    int inFlight = 0;
+    qint64 lastStatusRequestNs = -1;
+    qint64 lastProgressNs = 0;
+    QString lastState;
+    
+    if (timeline) {
+        out << "zaman_ms,durum,bf_blok,bf_rx,yoldaki_bayt\n";
+    }
+    
+    TrafficRecord record;
+    while (reader.readNext(record)) {
+        result.durationNs = record.timestampNs;
+        
+        if (record.direction == TrafficDirection::Marker) {
+            result.events << QString("%1 ms  işaret: %2").arg(formatTime(record.timestampNs), QString::fromUtf8(record.data));
+            continue;
+        }
+        
+        if (record.direction == TrafficDirection::Tx) {
+            result.txBytes += record.data.size();
+            for (char c : record.data) {
+                if (isRealtimeByte(c)) {
+                    result.realtimeBytes++;
+                    if (c == '?') {
+                        result.statusRequests++;
+                        lastStatusRequestNs = record.timestampNs;
+                    }
+                    continue;
+                }
+                
+                txLine.append(c);
+                if (c == '\n') {
+                    if (pending.isEmpty()) {
+                        lastProgressNs = record.timestampNs;
+                    }
+                    pending.enqueue({txLine.trimmed(), record.timestampNs, static_cast<int>(txLine.size())});
+                    pendingIndex.enqueue(result.lines.size());
+                    result.lines << QString::fromUtf8(txLine.trimmed());
+                    result.responses << QString();
+                    inFlight += txLine.size();
+                    result.bytesInFlight.record(inFlight);
+                    txLine.clear();
+                }
+            }
+            continue;
+        }
+        
+        // RX: satırlara böl
+        result.rxBytes += record.data.size();
+        rxBuffer.append(record.data);
+        int end;
+        while ((end = rxBuffer.indexOf('\n')) >= 0) {
+            QString line = QString::fromUtf8(rxBuffer.left(end)).trimmed();
+            rxBuffer.remove(0, end + 1);
+            if (line.isEmpty()) {
+                continue;
+            }
+            
+            if (line == "ok" || line.startsWith("error")) {
+                if (pending.isEmpty()) {
+                    continue; // Kayıt ortasında başlamış olabilir
+                }
+                
+                PendingLine acked = pending.dequeue();
+                int index = pendingIndex.dequeue();
+                result.responses[index] = line;
+                result.ackLatencyUs.record((record.timestampNs - acked.sentNs) / 1000);
+                inFlight -= acked.size;
+                
+                qint64 gap = record.timestampNs - lastProgressNs;
+                if (gap > result.longestStallNs) {
+                    result.longestStallNs = gap;
+                    result.longestStallAtNs = record.timestampNs;
+                }
+                lastProgressNs = record.timestampNs;
+                
+                if (line.startsWith("error")) {
+                    result.events << QString("%1 ms  %2: %3").arg(formatTime(record.timestampNs), line, QString::fromUtf8(acked.text));
+                }
+            } else if (line.startsWith('<')) {
+                QString body = line.mid(1, line.size() - 2);
+                QString state = body.section(QRegularExpression("[|,]"), 0, 0);
+                int blocks = -1;
+                int rx = -1;
+                for (const QString &field : body.split('|')) {
+                    if (field.startsWith("Bf:")) {
+                        blocks = field.mid(3).section(',', 0, 0).toInt();
+                        rx = field.mid(3).section(',', 1, 1).toInt();
+                    }
+                }
+                
+                if (lastStatusRequestNs >= 0) {
+                    result.statusLatencyUs.record((record.timestampNs - lastStatusRequestNs) / 1000);
+                    lastStatusRequestNs = -1;
+                }
+                if (blocks >= 0) {
+                    result.plannerBlocksFree.record(blocks);
+                }
+                if (state != lastState) {
+                    result.events << QString("%1 ms  durum: %2").arg(formatTime(record.timestampNs), state);
+                    lastState = state;
+                }
+                if (timeline) {
+                    out << QString("%1,%2,%3,%4,%5\n").arg(formatTime(record.timestampNs), state)
+                        .arg(blocks).arg(rx).arg(inFlight);
+                }
+            } else if (line.startsWith("Grbl ")) {
+                // Reset: yoldaki satırlar için yanıt gelmeyecek
+                result.resets++;
+                result.events << QString("%1 ms  reset (%2 satır yanıtsız)").arg(formatTime(record.timestampNs)).arg(pending.size());
+                pending.clear();
+                pendingIndex.clear();
+                inFlight = 0;
+            } else if (line.startsWith("ALARM")) {
+                result.events << QString("%1 ms  %2").arg(formatTime(record.timestampNs), line);
+            }
+        }
+    }
+    
+    return result;
+}
+
+static void printAnalysis(QTextStream &out, const CaptureAnalysis &a)
+{
+    int errors = 0;
+    for (const QString &response : a.responses) {
+        if (response.startsWith("error")) {
+            errors++;
+        }
+    }
+    
+    out << QString("süre: %1 s  TX: %2 bayt (%3 realtime)  RX: %4 bayt  satır: %5  hata: %6  reset: %7\n")
+        .arg(a.durationNs / 1e9, 0, 'f', 3)
+        .arg(a.txBytes).arg(a.realtimeBytes).arg(a.rxBytes)
+        .arg(a.lines.size()).arg(errors).arg(a.resets);
+    out << "ack gecikmesi (us):        " << a.ackLatencyUs.summary() << "\n";
+    out << "status yanıt süresi (us):  " << a.statusLatencyUs.summary() << "  (" << a.statusRequests << " sorgu)\n";
+    out << "yoldaki bayt:              " << a.bytesInFlight.summary() << "\n";
+    out << "boş planlayıcı bloğu (Bf): " << a.plannerBlocksFree.summary() << "\n";
+    out << QString("en uzun ack boşluğu: %1 ms (%2 ms'de)\n")
+        .arg(formatTime(a.longestStallNs), formatTime(a.longestStallAtNs));
+    
+    if (!a.events.isEmpty()) {
+        out << "\nolaylar:\n";
+        for (const QString &event : a.events) {
+            out << "  " << event << "\n";
+        }
+    }
+    out.flush();
+}
+
+// Kaydedilen satırları sanal kontrolcüye yeniden gönderir; farklı yanıt sayısını döndürür
+static int replayCapture(const CaptureAnalysis &a, QCommandLineParser &parser, QTextStream &out)
+{
+    VirtualGrblController controller;
+    controller.setBaudRate(parser.value("baud").toInt());
+    controller.setLinkLatency(parser.value("latency-us").toInt());
+    controller.setRxBufferSize(parser.value("rx-buffer").toInt());
+    controller.setPlannerBlockCount(parser.value("planner-blocks").toInt());
+    VirtualGrblDevice device(&controller);
+    
+    SerialCommunication serial;
+    serial.setStreamingMode(StreamingMode::CharacterCounting);
+    serial.setGCodeCompactionEnabled(false); // Kayıttaki baytlar aynen gönderilir
+    serial.setLatencySummaryInterval(0);
+    int timeoutSeconds = parser.value("timeout").toInt();
+    serial.setSafetyTimeout(timeoutSeconds * 1000);
+    
+    QStringList replayed;
+    QMap<quint64, int> sequenceToIndex;
+    QObject::connect(&serial, &SerialCommunication::commandFailed, [&](quint64 sequence, const QString &error) {
+        if (sequenceToIndex.contains(sequence)) {
+            replayed[sequenceToIndex.value(sequence)] = error;
+        }
+    });
+    QObject::connect(&serial, &SerialCommunication::commandAcknowledged, [&](quint64 sequence, qint64, qint64) {
+        int index = sequenceToIndex.value(sequence, -1);
+        if (index >= 0 && replayed[index].isEmpty()) {
+            replayed[index] = "ok";
+        }
+    });
+    
+    if (!serial.connectToIODevice(&device)) {
+        out << "Sanal kontrolcüye bağlanılamadı\n";
+        return -1;
+    }
+    
+    QEventLoop loop;
+    QTimer pollTimer;
+    QElapsedTimer deadline;
+    pollTimer.setInterval(1);
+    QObject::connect(&pollTimer, &QTimer::timeout, &loop, [&]() {
+        if (serial.getPendingCommandCount() == 0 || deadline.elapsed() > timeoutSeconds * 1000) {
+            loop.quit();
+        }
+    });
+    
+    // Açılış sorguları bitsin
+    deadline.start();
+    pollTimer.start();
+    loop.exec();
+    
+    QElapsedTimer wallClock;
+    wallClock.start();
+    deadline.restart();
+    for (int i = 0; i < a.lines.size(); ++i) {
+        replayed << QString();
+        serial.sendCommand(a.lines.at(i));
+        sequenceToIndex.insert(serial.getLastQueuedSequence(), i);
+    }
+    loop.exec();
+    
+    int mismatches = 0;
+    for (int i = 0; i < a.lines.size(); ++i) {
+        // Kayıtta yanıtı olmayan satırlar (reset ile düşenler) karşılaştırılmaz
+        if (a.responses.at(i).isEmpty() || a.responses.at(i) == replayed.at(i)) {
+            continue;
+        }
+        if (mismatches < 20) {
+            out << QString("  satır %1: kayıt '%2', tekrar '%3'  %4\n")
+                .arg(i + 1).arg(a.responses.at(i), replayed.at(i), a.lines.at(i));
+        }
+        mismatches++;
+    }
+    
+    out << QString("tekrar: %1 satır %2 s'de, %3 farklı yanıt\n")
+        .arg(a.lines.size()).arg(wallClock.elapsed() / 1000.0, 0, 'f', 3).arg(mismatches);
+    out << "tekrar ack gecikmesi (us): " << serial.getAckLatencyHistogram().summary() << "\n";
+    out.flush();
+    
+    serial.disconnectFromDevice();
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("CNC_TrafficReplay");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Kontrolcü trafik kaydı analizi ve tekrar oynatma");
+    parser.addHelpOption();
+    parser.addPositionalArgument("capture", "SerialCommunication::startTrafficCapture ile yazılmış dosya");
+    parser.addOption({"timeline", "Her status raporunu CSV olarak yaz"});
+    parser.addOption({"replay", "Satırları sanal GRBL'e yeniden gönder ve yanıtları karşılaştır"});
+    parser.addOption({"baud", "Tekrar: baud hızı", "rate", "115200"});
+    parser.addOption({"latency-us", "Tekrar: tek yönlü bağlantı gecikmesi (mikrosaniye)", "us", "1000"});
+    parser.addOption({"rx-buffer", "Tekrar: RX tampon boyutu (bayt)", "bytes", "128"});
+    parser.addOption({"planner-blocks", "Tekrar: planlayıcı blok sayısı (BLOCK_BUFFER_SIZE)", "blocks", "16"});
+    parser.addOption({"timeout", "Tekrar zaman aşımı (s)", "seconds", "600"});
+    parser.process(app);
+    
+    const QStringList files = parser.positionalArguments();
+    if (files.size() != 1) {
+        parser.showHelp(1);
+    }
+    
+    TrafficCaptureReader reader;
+    if (!reader.open(files.first())) {
+        QTextStream(stderr) << files.first() << ": " << reader.errorString() << "\n";
+        return 1;
+    }
+    
+    QTextStream out(stdout);
+    CaptureAnalysis analysis = analyzeCapture(reader, out, parser.isSet("timeline"));
+    if (!reader.errorString().isEmpty()) {
+        out << "uyarı: " << reader.errorString() << " (dosya sonu kesik olabilir)\n";
+    }
+    printAnalysis(out, analysis);
+    
+    if (parser.isSet("replay")) {
+        out << "\n";
+        int mismatches = replayCapture(analysis, parser, out);
+        if (mismatches != 0) {
+            return mismatches < 0 ? 1 : 3;
+        }
+    }
+    
+    return 0;
+}